@@ -0,0 +1,126 @@
+// bench/bench_common.hpp  –  timing and reporting helpers for the benchmarks
+//
+// Results are collected as flat rows and written either as CSV (one
+// header line, one row per measurement) or as JSON (build metadata
+// plus an array of row objects), so runs from two builds can be
+// diffed with bench/compare.py.
+
+#ifndef BENCH_COMMON_H
+# define BENCH_COMMON_H
+
+# include <algorithm>
+# include <chrono>
+# include <cstdio>
+# include <random>
+# include <string>
+# include <vector>
+
+typedef std::chrono::steady_clock BenchClock;
+
+static inline double bench_seconds_since(BenchClock::time_point t0)
+{
+    return std::chrono::duration<double>(BenchClock::now() - t0).count();
+}
+
+// Seconds per call of fn(): calls are batched until a batch takes at
+// least min_seconds, and the fastest of `trials` batches is kept.
+template <class F>
+static double bench_time(F&& fn, double min_seconds = 0.02, int trials = 5)
+{
+    long reps = 1;
+    for (;;) {
+        auto t0 = BenchClock::now();
+        for (long r = 0; r < reps; ++r) fn();
+        if (bench_seconds_since(t0) >= min_seconds || reps >= (1L << 30))
+            break;
+        reps *= 2;
+    }
+
+    double best = 1e300;
+    for (int t = 0; t < trials; ++t) {
+        auto t0 = BenchClock::now();
+        for (long r = 0; r < reps; ++r) fn();
+        best = std::min(best, bench_seconds_since(t0) / (double)reps);
+    }
+    return best;
+}
+
+// Fill v with N(0, 1) samples.
+static inline void bench_fill_gauss(std::vector<float>& v, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    for (float& x : v) x = gauss(rng);
+}
+
+// Synthetic binary problem: labels from a random hyperplane.
+static inline void bench_make_dataset(int n_samples, int n_features,
+                                      std::vector<float>& X,
+                                      std::vector<int>& Y, unsigned seed)
+{
+    X.resize((size_t)n_samples * n_features);
+    Y.resize(n_samples);
+    bench_fill_gauss(X, seed);
+
+    std::vector<float> w(n_features);
+    bench_fill_gauss(w, seed + 1);
+    for (int i = 0; i < n_samples; ++i) {
+        float z = 0.0f;
+        for (int j = 0; j < n_features; ++j)
+            z += X[(size_t)i * n_features + j] * w[j];
+        Y[i] = z > 0.0f ? 1 : 0;
+    }
+}
+
+// ---------------------------------------------------------------
+//  BenchReport – rows of (suite, name, isa, shape, metrics)
+// ---------------------------------------------------------------
+struct BenchRow {
+    std::string suite;    // "kernel", "e2e", …
+    std::string name;     // kernel or operation
+    std::string isa;      // tier the row ran on
+    std::string shape;    // e.g. "n=4096" or "rows=1e5;features=64"
+    double      seconds;  // per call
+    double      gbps;     // bytes moved / second / 1e9
+    double      gflops;   // floating-point ops / second / 1e9
+};
+
+class BenchReport {
+public:
+    void add(const BenchRow& row)
+    {
+        rows.push_back(row);
+        std::fprintf(stderr, "%-8s %-20s %-10s %-28s %12.4g s %9.2f GB/s %9.2f GFLOP/s\n",
+                     row.suite.c_str(), row.name.c_str(), row.isa.c_str(),
+                     row.shape.c_str(), row.seconds, row.gbps, row.gflops);
+    }
+
+    void write_csv(std::FILE* f) const
+    {
+        std::fprintf(f, "suite,name,isa,shape,seconds,gbps,gflops\n");
+        for (const BenchRow& r : rows)
+            std::fprintf(f, "%s,%s,%s,%s,%.6g,%.6g,%.6g\n",
+                         r.suite.c_str(), r.name.c_str(), r.isa.c_str(),
+                         r.shape.c_str(), r.seconds, r.gbps, r.gflops);
+    }
+
+    void write_json(std::FILE* f, const std::string& meta_json) const
+    {
+        std::fprintf(f, "{\n  \"meta\": %s,\n  \"results\": [\n", meta_json.c_str());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const BenchRow& r = rows[i];
+            std::fprintf(f,
+                "    {\"suite\": \"%s\", \"name\": \"%s\", \"isa\": \"%s\", "
+                "\"shape\": \"%s\", \"seconds\": %.6g, \"gbps\": %.6g, "
+                "\"gflops\": %.6g}%s\n",
+                r.suite.c_str(), r.name.c_str(), r.isa.c_str(), r.shape.c_str(),
+                r.seconds, r.gbps, r.gflops, i + 1 < rows.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+    }
+
+private:
+    std::vector<BenchRow> rows;
+};
+
+#endif
@@ -0,0 +1,130 @@
+// bench/bench_dataset.cpp  –  cold start and RSS: raw arrays vs mapped data set
+//
+// Usage: bench_dataset [n_samples] [n_features] [dir]
+//        bench_dataset --load raw|mmap <dir> <n_features>
+//
+// The first form writes a synthetic problem to <dir> twice — as raw
+// float32 / int32 arrays (X.f32, Y.i32) and as a padded .lrds file —
+// then runs itself once per loader so each gets a fresh process:
+//
+//   raw   read both arrays into memory, train(X, Y, n) for one epoch
+//         (which makes the padded copy)
+//   mmap  MappedDataset + train(const MappedDataset&) for one epoch
+//
+// and reports time to open the data, time of the first epoch and the
+// peak resident set size of the process.  The files are read through
+// the page cache either way; drop it between runs
+// (echo 3 > /proc/sys/vm/drop_caches) to time truly cold disks.
+// Defaults: 1000000 samples, 61 features, /tmp.
+
+#include "bench_common.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/MappedDataset.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if !defined(_WIN32)
+# include <sys/resource.h>
+#endif
+
+// Peak RSS of this process in MB (0 where getrusage is unavailable).
+static double peak_rss_mb()
+{
+#if defined(_WIN32)
+    return 0.0;
+#else
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+# if defined(__APPLE__)
+    return ru.ru_maxrss / 1e6;      // bytes
+# else
+    return ru.ru_maxrss / 1e3;      // KB
+# endif
+#endif
+}
+
+static bool read_file(const std::string& path, void* dst, size_t bytes)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    const bool ok = std::fread(dst, 1, bytes, f) == bytes;
+    std::fclose(f);
+    return ok;
+}
+
+static int run_load(const char* mode, const std::string& dir, int n_features)
+{
+    init_kernels();
+    LogisticRegression model(n_features, 0.1f, 1);
+
+    const auto t0 = BenchClock::now();
+    double open_s;
+    if (std::strcmp(mode, "mmap") == 0) {
+        MappedDataset ds((dir + "/bench.lrds").c_str());
+        open_s = bench_seconds_since(t0);
+        model.train(ds);
+    } else {
+        std::FILE* f = std::fopen((dir + "/X.f32").c_str(), "rb");
+        if (!f) { std::perror("X.f32"); return 1; }
+        std::fseek(f, 0, SEEK_END);
+        const long bytes = std::ftell(f);
+        std::fclose(f);
+
+        const int n = (int)(bytes / ((long)n_features * sizeof(float)));
+        std::vector<float> X((size_t)n * n_features);
+        std::vector<int>   Y(n);
+        if (!read_file(dir + "/X.f32", X.data(), X.size() * sizeof(float)) ||
+            !read_file(dir + "/Y.i32", Y.data(), Y.size() * sizeof(int))) {
+            std::fprintf(stderr, "short read in %s\n", dir.c_str());
+            return 1;
+        }
+        open_s = bench_seconds_since(t0);
+        model.train(X.data(), Y.data(), n);
+    }
+    const double total_s = bench_seconds_since(t0);
+
+    std::printf("%-6s %12.1f %12.1f %12.1f\n", mode, open_s * 1e3,
+                (total_s - open_s) * 1e3, peak_rss_mb());
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 5 && std::strcmp(argv[1], "--load") == 0)
+        return run_load(argv[2], argv[3], std::atoi(argv[4]));
+
+    const int         n_samples  = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int         n_features = argc > 2 ? std::atoi(argv[2]) : 61;
+    const std::string dir        = argc > 3 ? argv[3] : "/tmp";
+
+    std::vector<float> X;
+    std::vector<int>   Y;
+    bench_make_dataset(n_samples, n_features, X, Y, 5);
+
+    std::FILE* f = std::fopen((dir + "/X.f32").c_str(), "wb");
+    std::FILE* g = std::fopen((dir + "/Y.i32").c_str(), "wb");
+    if (!f || !g) { std::perror(dir.c_str()); return 1; }
+    std::fwrite(X.data(), sizeof(float), X.size(), f);
+    std::fwrite(Y.data(), sizeof(int), Y.size(), g);
+    std::fclose(f);
+    std::fclose(g);
+    X = std::vector<float>();
+    Y = std::vector<int>();
+
+    convert_raw_dataset((dir + "/X.f32").c_str(), (dir + "/Y.i32").c_str(),
+                        n_features, (dir + "/bench.lrds").c_str());
+
+    std::printf("%d samples x %d features\n%-6s %12s %12s %12s\n", n_samples,
+                n_features, "loader", "open ms", "epoch ms", "peak RSS MB");
+    std::fflush(stdout);
+    for (const char* mode : {"raw", "mmap"}) {
+        const std::string cmd = std::string("\"") + argv[0] + "\" --load " + mode
+                              + " \"" + dir + "\" " + std::to_string(n_features);
+        if (std::system(cmd.c_str()) != 0)
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// bench/bench_fixed.cpp  –  FixedLogisticRegression<N> vs LogisticRegression
+//
+// Usage: bench_fixed [n_samples] [epochs]
+//
+// For N = 4, 8, 16, 32, 64 features, trains both classes single-threaded
+// on the same synthetic problem and times train (per epoch), predict
+// (per call, cycling through the rows) and predict_batch (per row).
+// The last column is the largest probability difference between the
+// two trained models, which should stay at float rounding level.
+// Defaults: 20000 samples, 20 epochs.
+
+#include "bench_common.hpp"
+#include "../logreg/include/FixedLogisticRegression.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <cmath>
+#include <cstdlib>
+
+// Defeats dead-code elimination of the unused results.
+static volatile float g_sink;
+
+static void print_row(int n, const char* what, double dyn, double fix)
+{
+    std::printf("%4d  %-14s %12.2f %12.2f %8.2fx\n", n, what, dyn, fix, dyn / fix);
+}
+
+template <int N>
+static void bench_n(int n_samples, int epochs)
+{
+    std::vector<float> X;
+    std::vector<int>   Y;
+    bench_make_dataset(n_samples, N, X, Y, 11 + N);
+
+    LogisticRegression         dyn(N, 0.1f, epochs, 1);
+    FixedLogisticRegression<N> fix(0.1f, epochs);
+
+    const double dyn_train = bench_time([&] { dyn.train(X.data(), Y.data(), n_samples); },
+                                        0.05, 3);
+    const double fix_train = bench_time([&] { fix.train(X.data(), Y.data(), n_samples); },
+                                        0.05, 3);
+
+    // One predict per row, cycling through the data set.
+    int r_dyn = 0, r_fix = 0;
+    const double dyn_pred = bench_time([&] {
+        g_sink = dyn.predict(X.data() + (size_t)r_dyn * N);
+        r_dyn = r_dyn + 1 == n_samples ? 0 : r_dyn + 1;
+    });
+    const double fix_pred = bench_time([&] {
+        g_sink = fix.predict(X.data() + (size_t)r_fix * N);
+        r_fix = r_fix + 1 == n_samples ? 0 : r_fix + 1;
+    });
+
+    std::vector<float> p_dyn(n_samples), p_fix(n_samples);
+    Workspace ws;
+    const double dyn_batch = bench_time([&] {
+        dyn.predict_batch(X.data(), p_dyn.data(), n_samples, ws);
+    });
+    const double fix_batch = bench_time([&] {
+        fix.predict_batch(X.data(), p_fix.data(), n_samples);
+    });
+
+    // Same starting point, same number of epochs: the models should agree.
+    LogisticRegression         dyn1(N, 0.1f, epochs, 1);
+    FixedLogisticRegression<N> fix1(0.1f, epochs);
+    dyn1.train(X.data(), Y.data(), n_samples);
+    fix1.train(X.data(), Y.data(), n_samples);
+    dyn1.predict_batch(X.data(), p_dyn.data(), n_samples, ws);
+    fix1.predict_batch(X.data(), p_fix.data(), n_samples);
+    float max_diff = 0.0f;
+    for (int i = 0; i < n_samples; ++i)
+        max_diff = std::max(max_diff, std::fabs(p_dyn[i] - p_fix[i]));
+
+    print_row(N, "train/epoch us", dyn_train / epochs * 1e6, fix_train / epochs * 1e6);
+    print_row(N, "predict ns", dyn_pred * 1e9, fix_pred * 1e9);
+    print_row(N, "batch ns/row", dyn_batch / n_samples * 1e9, fix_batch / n_samples * 1e9);
+    std::printf("%4d  %-14s %12.2e\n\n", N, "max |dp|", (double)max_diff);
+}
+
+int main(int argc, char** argv)
+{
+    const int n_samples = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const int epochs    = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    init_kernels();
+
+    std::printf("\n%4s  %-14s %12s %12s %9s\n", "N", "", "dynamic", "fixed", "speedup");
+    bench_n<4>(n_samples, epochs);
+    bench_n<8>(n_samples, epochs);
+    bench_n<16>(n_samples, epochs);
+    bench_n<32>(n_samples, epochs);
+    bench_n<64>(n_samples, epochs);
+    return 0;
+}
@@ -0,0 +1,77 @@
+// bench/bench_half.cpp  –  float32 vs fp16 / bfloat16 feature storage
+//
+// Usage: bench_half [n_samples] [n_features] [epochs]
+//
+// Stores the same problem as a float32, an fp16 and a bfloat16
+// Dataset and trains a model on each.  It reports the bytes each
+// copy takes, the time per epoch, and, after `epochs` epochs, the
+// log-loss and accuracy on the float32 rows and the largest
+// probability difference from the float32-trained model.  The
+// defaults (2M samples x 64 features, 512 MB as float32) keep X far
+// out of cache, where an epoch is bound by memory bandwidth.
+// Defaults: 2000000 samples, 64 features, 10 epochs.
+
+#include "bench_common.hpp"
+#include "../logreg/include/Dataset.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <cmath>
+#include <cstdlib>
+
+static const char* storage_name(FeatureStorage s)
+{
+    return s == STORAGE_F16 ? "fp16" : s == STORAGE_BF16 ? "bf16" : "float32";
+}
+
+int main(int argc, char** argv)
+{
+    const int n_samples  = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    const int n_features = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int epochs     = argc > 3 ? std::atoi(argv[3]) : 10;
+
+    init_kernels();
+    std::vector<float> X;
+    std::vector<int>   Y;
+    bench_make_dataset(n_samples, n_features, X, Y, 5);
+
+    std::printf("%d samples x %d features, %d epochs\n", n_samples, n_features, epochs);
+    std::printf("%8s %10s %12s %8s %10s %8s %12s\n", "storage", "X MB",
+                "epoch ms", "speedup", "log-loss", "acc", "max |dp|");
+
+    std::vector<float> p32(n_samples), p(n_samples);
+    double f32_epoch = 0.0;
+
+    for (FeatureStorage st : {STORAGE_F32, STORAGE_F16, STORAGE_BF16}) {
+        const Dataset data(X.data(), Y.data(), n_samples, n_features, st);
+        const double  elem = st == STORAGE_F32 ? 4.0 : 2.0;
+        const double  mb   = (double)n_samples * data.padded_features() * elem / 1e6;
+
+        // A fresh model per timed call, so every call runs the same
+        // `epochs` epochs from zero weights.
+        const double epoch_s = bench_time([&] {
+            LogisticRegression model(n_features, 0.1f, epochs, 1);
+            model.train(data);
+        }, 0.0, 2) / epochs;
+        if (st == STORAGE_F32)
+            f32_epoch = epoch_s;
+
+        LogisticRegression model(n_features, 0.1f, epochs, 1);
+        model.train(data);
+        float* out = st == STORAGE_F32 ? p32.data() : p.data();
+        model.predict_batch(X.data(), out, n_samples);
+
+        double loss = 0.0, maxdiff = 0.0;
+        int    hits = 0;
+        for (int i = 0; i < n_samples; ++i) {
+            const double q = std::min(std::max((double)out[i], 1e-7), 1.0 - 1e-7);
+            loss    -= Y[i] ? std::log(q) : std::log(1.0 - q);
+            hits    += (out[i] >= 0.5f) == (Y[i] == 1);
+            maxdiff  = std::max(maxdiff, (double)std::fabs(out[i] - p32[i]));
+        }
+
+        std::printf("%8s %10.1f %12.2f %7.2fx %10.5f %8.4f %12.2e\n",
+                    storage_name(st), mb, epoch_s * 1e3, f32_epoch / epoch_s,
+                    loss / n_samples, (double)hits / n_samples, maxdiff);
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+// bench/bench_ilp.cpp  –  dot product throughput vs. accumulator count
+//
+// Usage: bench_ilp
+//
+// Times dot_acc<T, ACC> (simd_math.hpp) with 1, 2, 4 and 8 independent
+// accumulators at every tier this CPU and build support.  With one
+// accumulator each multiply-add waits for the previous one, so the
+// loop is bound by add / FMA latency; more accumulators let the core
+// overlap them until load bandwidth becomes the limit.  Vectors are
+// sized to sit in L1, L2 and L3, where the difference is visible;
+// DRAM-resident data is bandwidth-bound at any ACC.
+
+#include "bench_common.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include "../logreg/include/simd_math.hpp"
+#include <cstdio>
+
+typedef float (*DotFn)(const float*, const float*, uint64_t);
+
+struct IlpTier {
+    KernelIsa   isa;
+    const char* name;
+    DotFn       fn[4];          // ACC = 1, 2, 4, 8
+};
+
+template <class T>
+static IlpTier ilp_tier(KernelIsa isa, const char* name)
+{
+    return {isa, name, {dot_acc<T, 1>, dot_acc<T, 2>, dot_acc<T, 4>, dot_acc<T, 8>}};
+}
+
+// Defeats dead-code elimination of the unused results.
+static volatile float g_sink;
+
+int main()
+{
+    const IlpTier tiers[] = {
+        ilp_tier<IsaSse>(ISA_SSE, "sse"),
+        ilp_tier<IsaAvx>(ISA_AVX, "avx"),
+        ilp_tier<IsaAvx2Fma>(ISA_AVX2_FMA, "avx2_fma"),
+#if LOGREG_HAVE_AVX512
+        ilp_tier<IsaAvx512>(ISA_AVX512, "avx512"),
+#endif
+    };
+
+    // Floats per vector (two vectors): 8 KB, 128 KB, 2 MB in total.
+    const uint64_t sizes[] = {1u << 10, 1u << 14, 1u << 18};
+    const KernelIsa top = detect_kernel_isa();
+
+    std::vector<float> a(sizes[2]), b(sizes[2]);
+    bench_fill_gauss(a, 1);
+    bench_fill_gauss(b, 2);
+
+    std::printf("GFLOP/s\n%-10s %10s %10s %10s %10s %10s %9s\n",
+                "isa", "n", "acc=1", "acc=2", "acc=4", "acc=8", "best/1");
+    for (const IlpTier& t : tiers) {
+        if (t.isa > top) continue;
+        for (uint64_t n : sizes) {
+            double gflops[4];
+            for (int k = 0; k < 4; ++k) {
+                double sec = bench_time([&] { g_sink = t.fn[k](a.data(), b.data(), n); });
+                gflops[k] = 2.0 * (double)n / sec * 1e-9;
+            }
+            double best = gflops[0];
+            for (int k = 1; k < 4; ++k)
+                if (gflops[k] > best) best = gflops[k];
+            std::printf("%-10s %10llu %10.2f %10.2f %10.2f %10.2f %8.2fx\n",
+                        t.name, (unsigned long long)n, gflops[0], gflops[1],
+                        gflops[2], gflops[3], best / gflops[0]);
+        }
+    }
+    return 0;
+}
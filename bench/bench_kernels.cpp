@@ -0,0 +1,231 @@
+// bench/bench_kernels.cpp  –  kernel sweep and end-to-end timings
+//
+// Usage: bench_kernels [--quick] [--out FILE]
+//
+// 1. Every kernel declared in simd_fn.hpp, at every tier this CPU and
+//    build support (capped by LOGREG_MAX_ISA), over vector lengths
+//    that sit in L1, L2, L3 and DRAM.  Throughput is reported as
+//    GB/s of compulsory traffic and GFLOP/s of useful arithmetic.
+// 2. LogisticRegression::train and predict_batch on synthetic data
+//    at the dispatched tier.
+//
+// A human-readable table goes to stderr.  The results are written to
+// FILE (default bench_results.csv); a name ending in .json selects
+// JSON with build metadata.  Compare two runs with
+//     python3 bench/compare.py old.csv new.csv
+
+#include "bench_common.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include "../logreg/include/simd_fn.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Nominal arithmetic per sigmoid element: range reduction, degree-5
+// polynomial, exponent scaling, 1 / (1 + e).
+static const double SIGMOID_FLOPS = 18.0;
+
+// Row width used for the matrix kernels of the sweep.
+static const uint64_t SWEEP_PF = 64;
+
+struct KernelTier {
+    KernelIsa   isa;
+    const char* name;
+    float (*dot)(const float*, const float*, uint64_t);
+    void  (*axpy)(float, const float*, float*, uint64_t);
+    void  (*axpby)(float, const float*, float, float*, uint64_t);
+    void  (*gemv)(const float*, uint64_t, uint64_t, const float*, float, float*);
+    void  (*sigmoid)(const float*, float*, uint64_t);
+    float (*fused_grad)(const float*, const int*, uint64_t, uint64_t,
+                        const float*, float, float*);
+};
+
+static const KernelTier TIERS[] = {
+    {ISA_SCALAR,   "scalar",   dot_scalar,   axpy_scalar,   axpby_scalar,   gemv_scalar,   sigmoid_scalar,   fused_grad_scalar},
+    {ISA_SSE,      "sse",      dot_sse,      axpy_sse,      axpby_sse,      gemv_sse,      sigmoid_sse,      fused_grad_sse},
+    {ISA_AVX,      "avx",      dot_avx,      axpy_avx,      axpby_avx,      gemv_avx,      sigmoid_avx,      fused_grad_avx},
+    {ISA_AVX2_FMA, "avx2_fma", dot_avx2_fma, axpy_avx2_fma, axpby_avx2_fma, gemv_avx2_fma, sigmoid_avx2_fma, fused_grad_avx2_fma},
+#if LOGREG_HAVE_AVX512
+    {ISA_AVX512,   "avx512",   dot_avx512,   axpy_avx512,   axpby_avx512,   gemv_avx512,   sigmoid_avx512,   fused_grad_avx512},
+#endif
+};
+
+static const char* tier_name(KernelIsa isa)
+{
+    for (const KernelTier& t : TIERS)
+        if (t.isa == isa) return t.name;
+    return "scalar";
+}
+
+// Defeats dead-code elimination of kernels whose result is unused.
+static volatile float g_sink;
+
+// ---------------------------------------------------------------
+//  Kernel sweep
+// ---------------------------------------------------------------
+static void bench_kernel_sweep(BenchReport& report, bool quick)
+{
+    // Floats per vector: 4 KB … 64 MB, i.e. L1-resident up to DRAM.
+    std::vector<uint64_t> sizes = {1u << 10, 1u << 12, 1u << 15,
+                                   1u << 18, 1u << 21, 1u << 24};
+    if (quick) sizes.resize(4);
+
+    const uint64_t max_n = sizes.back();
+    float* a   = aligned_alloc_float(max_n, 64);
+    float* b   = aligned_alloc_float(max_n, 64);
+    float* out = aligned_alloc_float(max_n, 64);
+    float* dw  = aligned_alloc_float(SWEEP_PF, 64);
+    std::vector<int> Y(max_n / SWEEP_PF);
+
+    std::vector<float> init(max_n);
+    bench_fill_gauss(init, 1);
+    std::memcpy(a, init.data(), max_n * sizeof(float));
+    bench_fill_gauss(init, 2);
+    std::memcpy(b, init.data(), max_n * sizeof(float));
+    for (size_t i = 0; i < Y.size(); ++i) Y[i] = (int)(i & 1);
+
+    const KernelIsa top = detect_kernel_isa();
+    const double min_s = quick ? 0.005 : 0.02;
+
+    for (const KernelTier& t : TIERS) {
+        if (t.isa > top) continue;
+
+        for (uint64_t n : sizes) {
+            const uint64_t rows  = n / SWEEP_PF;
+            const std::string shape = "n=" + std::to_string(n);
+            double s;
+
+            s = bench_time([&] { g_sink = t.dot(a, b, n); }, min_s);
+            report.add({"kernel", "dot", t.name, shape, s,
+                        8.0 * n / s * 1e-9, 2.0 * n / s * 1e-9});
+
+            // x and y read, y written; out serves as y.
+            s = bench_time([&] { t.axpy(1e-3f, a, out, n); }, min_s);
+            report.add({"kernel", "axpy", t.name, shape, s,
+                        12.0 * n / s * 1e-9, 2.0 * n / s * 1e-9});
+
+            s = bench_time([&] { t.axpby(1e-3f, a, 0.5f, out, n); }, min_s);
+            report.add({"kernel", "axpby", t.name, shape, s,
+                        12.0 * n / s * 1e-9, 3.0 * n / s * 1e-9});
+
+            s = bench_time([&] { t.sigmoid(a, out, n); }, min_s);
+            report.add({"kernel", "sigmoid", t.name, shape, s,
+                        8.0 * n / s * 1e-9, SIGMOID_FLOPS * n / s * 1e-9});
+
+            // X [rows × 64] read once, one float written per row.
+            s = bench_time([&] { t.gemv(a, rows, SWEEP_PF, b, 0.1f, out); }, min_s);
+            report.add({"kernel", "gemv", t.name, shape, s,
+                        4.0 * (n + rows) / s * 1e-9, 2.0 * n / s * 1e-9});
+
+            // X read once (the axpy re-reads rows from L1), one label per row.
+            std::memset(dw, 0, SWEEP_PF * sizeof(float));
+            s = bench_time([&] {
+                g_sink = t.fused_grad(a, Y.data(), rows, SWEEP_PF, b, 0.1f, dw);
+            }, min_s);
+            report.add({"kernel", "fused_grad", t.name, shape, s,
+                        4.0 * (n + rows) / s * 1e-9,
+                        (4.0 * n + SIGMOID_FLOPS * rows) / s * 1e-9});
+        }
+    }
+
+    aligned_free_float(a);
+    aligned_free_float(b);
+    aligned_free_float(out);
+    aligned_free_float(dw);
+}
+
+// ---------------------------------------------------------------
+//  End to end: train + predict_batch at the dispatched tier
+// ---------------------------------------------------------------
+static void bench_end_to_end(BenchReport& report, bool quick)
+{
+    struct Shape { int n_samples, n_features, epochs; };
+    std::vector<Shape> shapes = {{200000, 16, 10},
+                                 {100000, 64, 10},
+                                 {20000, 512, 10}};
+    if (quick)
+        for (Shape& sh : shapes) { sh.n_samples /= 10; sh.epochs = 3; }
+
+    const char* isa = tier_name(active_kernel_isa());
+
+    for (const Shape& sh : shapes) {
+        std::vector<float> X;
+        std::vector<int>   Y;
+        bench_make_dataset(sh.n_samples, sh.n_features, X, Y, 42);
+
+        const double n  = (double)sh.n_samples;
+        const double pf = (double)((sh.n_features + 7) & ~7);
+        const std::string shape = "rows=" + std::to_string(sh.n_samples)
+                                + ";features=" + std::to_string(sh.n_features)
+                                + ";epochs=" + std::to_string(sh.epochs);
+
+        LogisticRegression model(sh.n_features, 0.1f, sh.epochs);
+        double s = bench_time([&] {
+            model.train(X.data(), Y.data(), sh.n_samples);
+        }, 0.0, 3);
+        report.add({"e2e", "train", isa, shape, s,
+                    sh.epochs * 4.0 * n * pf / s * 1e-9,
+                    sh.epochs * (4.0 * n * pf + SIGMOID_FLOPS * n) / s * 1e-9});
+
+        std::vector<float> probs(sh.n_samples);
+        Workspace ws;
+        model.predict_batch(X.data(), probs.data(), sh.n_samples, ws);
+        s = bench_time([&] {
+            model.predict_batch(X.data(), probs.data(), sh.n_samples, ws);
+        }, 0.0, 5);
+        report.add({"e2e", "predict_batch", isa, shape, s,
+                    4.0 * n * (pf + 1.0) / s * 1e-9,
+                    (2.0 * n * pf + SIGMOID_FLOPS * n) / s * 1e-9});
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool        quick = false;
+    std::string out_path = "bench_results.csv";
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--quick"))
+            quick = true;
+        else if (!std::strcmp(argv[i], "--out") && i + 1 < argc)
+            out_path = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: %s [--quick] [--out FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    init_kernels();
+
+    BenchReport report;
+    bench_kernel_sweep(report, quick);
+    bench_end_to_end(report, quick);
+
+    std::FILE* f = std::fopen(out_path.c_str(), "w");
+    if (!f) {
+        std::perror(out_path.c_str());
+        return 1;
+    }
+
+    const bool json = out_path.size() >= 5
+                   && out_path.compare(out_path.size() - 5, 5, ".json") == 0;
+    if (json) {
+        std::string meta = "{\"compiler\": \"";
+#if defined(__VERSION__)
+        meta += __VERSION__;
+#endif
+        meta += "\", \"active_isa\": \"";
+        meta += tier_name(active_kernel_isa());
+        meta += "\", \"hardware_threads\": "
+              + std::to_string(std::thread::hardware_concurrency())
+              + ", \"quick\": " + (quick ? "true" : "false") + "}";
+        report.write_json(f, meta);
+    }
+    else
+        report.write_csv(f);
+
+    std::fclose(f);
+    std::fprintf(stderr, "results written to %s\n", out_path.c_str());
+    return 0;
+}
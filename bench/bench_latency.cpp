@@ -0,0 +1,86 @@
+// bench/bench_latency.cpp  –  single-sample scoring latency
+//
+// Usage: bench_latency [n_calls]
+//
+// Times LogisticRegression::predict one call at a time on unaligned
+// inputs for typical online feature counts and reports p50 / p99 /
+// p99.9 in nanoseconds.  The cost of reading the clock is measured
+// the same way and subtracted.
+
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double percentile(std::vector<double>& v, double q)
+{
+    size_t k = (size_t)(q * (double)(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+int main(int argc, char** argv)
+{
+    const int n_calls = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int feature_counts[] = {8, 16, 32, 64, 128, 256, 512};
+    const int n_inputs = 1024;   // distinct samples, cycled through
+
+    init_kernels();
+
+    std::mt19937 rng(7);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+    // Clock overhead: back-to-back now() pairs.
+    std::vector<double> lat(n_calls);
+    for (int c = 0; c < n_calls; ++c) {
+        auto t0 = Clock::now();
+        auto t1 = Clock::now();
+        lat[c] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+    const double overhead = percentile(lat, 0.5);
+
+    std::printf("\nclock overhead %.1f ns (subtracted), %d calls per row\n",
+                overhead, n_calls);
+    std::printf("%10s %10s %10s %10s\n", "features", "p50_ns", "p99_ns", "p999_ns");
+
+    volatile float sink = 0.0f;
+
+    for (int nf : feature_counts) {
+        // Brief training so the weights are not all zero.
+        std::vector<float> X((size_t)n_inputs * nf + 1);
+        std::vector<int>   Y(n_inputs);
+        for (float& v : X) v = gauss(rng);
+        for (int i = 0; i < n_inputs; ++i) Y[i] = X[(size_t)i * nf + 1] > 0.0f;
+
+        LogisticRegression model(nf, 0.1f, 5);
+        model.train(X.data() + 1, Y.data(), n_inputs);
+
+        // X.data() + 1 is deliberately not 32-byte aligned.
+        const float* base = X.data() + 1;
+
+        for (int c = 0; c < 1000; ++c)   // warm-up
+            sink = sink + model.predict(base + (size_t)(c % n_inputs) * nf);
+
+        for (int c = 0; c < n_calls; ++c) {
+            const float* x = base + (size_t)(c % n_inputs) * nf;
+            auto t0 = Clock::now();
+            float p = model.predict(x);
+            auto t1 = Clock::now();
+            sink = sink + p;
+            lat[c] = std::chrono::duration<double, std::nano>(t1 - t0).count()
+                     - overhead;
+        }
+
+        std::printf("%10d %10.1f %10.1f %10.1f\n", nf,
+                    percentile(lat, 0.50),
+                    percentile(lat, 0.99),
+                    percentile(lat, 0.999));
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+// bench/bench_online.cpp  –  partial_fit latency per batch
+//
+// Usage: bench_online [n_samples] [n_features] [n_threads]
+//
+// Streams the rows of a synthetic problem through partial_fit in
+// batches of 1, 16, 256 and 4096 rows (Adam, decaying step size) and
+// reports the time per call, the rows per second, the buffers
+// allocated while streaming (after a first warm-up call) and the
+// training accuracy after one pass over the rows.
+// Defaults: 200000 samples, 64 features, 1 thread.
+
+#include "bench_common.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include "../logreg/include/simd_fn.hpp"
+#include <cstdlib>
+
+int main(int argc, char** argv)
+{
+    const int n_samples  = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int n_features = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int n_threads  = argc > 3 ? std::atoi(argv[3]) : 1;
+
+    init_kernels();
+    std::vector<float> X;
+    std::vector<int>   Y;
+    bench_make_dataset(n_samples, n_features, X, Y, 9);
+
+    std::printf("%d samples x %d features, %d thread(s)\n", n_samples, n_features,
+                n_threads);
+    std::printf("%8s %12s %14s %8s %8s\n", "batch", "us / call", "samples/s",
+                "allocs", "acc");
+
+    std::vector<int> pred(n_samples);
+    for (int batch : {1, 16, 256, 4096}) {
+        LogisticRegression model(n_features, 0.01f, 1, n_threads);
+        model.set_optimizer(OPTIMIZER_ADAM);
+        model.set_lr_decay(1e-6f);
+        model.partial_fit(X.data(), Y.data(), batch);
+
+        const uint64_t allocs = aligned_alloc_count();
+        const auto     t0     = BenchClock::now();
+        int            calls  = 0;
+        for (int i = batch; i + batch <= n_samples; i += batch, ++calls)
+            model.partial_fit(X.data() + (size_t)i * n_features, Y.data() + i, batch);
+        const double t = bench_seconds_since(t0);
+
+        model.predict_class_batch(X.data(), pred.data(), n_samples);
+        int hits = 0;
+        for (int i = 0; i < n_samples; ++i)
+            hits += pred[i] == Y[i];
+        std::printf("%8d %12.2f %14.4g %8llu %8.4f\n", batch, t * 1e6 / calls,
+                    (double)calls * batch / t,
+                    (unsigned long long)(aligned_alloc_count() - allocs),
+                    (double)hits / n_samples);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// bench/bench_optimizers.cpp  –  epochs to a target loss per update rule
+//
+// Usage: bench_optimizers [n_samples] [n_features] [max_epochs] [n_threads]
+//
+// Finds the optimum of the problem with L-BFGS, then trains it with
+// each Optimizer at learning rates 0.01 … 1 and stops, through the
+// epoch callback, at the first epoch whose log-loss is within 0.01 %
+// of the optimum.  For each optimizer it reports the learning rate
+// that got there in the fewest epochs, those epochs, the wall time
+// and the time per epoch (the fused update is one pass over
+// n_features floats, so this stays the time of the gradient sweep).
+// The problem is the ill-conditioned, non-separable one of
+// bench_solvers: feature scales from 1 to 5 and a common offset.
+// Defaults: 100000 samples, 32 features, 1000 epochs, 1 thread.
+
+#include "bench_common.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <cmath>
+#include <cstdlib>
+
+static const char* optimizer_name(Optimizer o)
+{
+    switch (o) {
+    case OPTIMIZER_MOMENTUM: return "momentum";
+    case OPTIMIZER_NESTEROV: return "nesterov";
+    case OPTIMIZER_ADAGRAD:  return "adagrad";
+    case OPTIMIZER_ADAM:     return "adam";
+    default:                 return "sgd";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int n_samples  = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int n_features = argc > 2 ? std::atoi(argv[2]) : 32;
+    const int max_epochs = argc > 3 ? std::atoi(argv[3]) : 1000;
+    const int n_threads  = argc > 4 ? std::atoi(argv[4]) : 1;
+
+    init_kernels();
+    std::vector<float> X((size_t)n_samples * n_features);
+    std::vector<float> w(n_features);
+    std::vector<int>   Y(n_samples);
+    bench_fill_gauss(X, 5);
+    bench_fill_gauss(w, 6);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+    for (int i = 0; i < n_samples; ++i) {
+        double z = 0.25;
+        for (int j = 0; j < n_features; ++j) {
+            const float scale = 1.0f + 4.0f * j / n_features;
+            float&      x     = X[(size_t)i * n_features + j];
+            z += 0.5 * w[j] * x;
+            x  = x * scale + 0.5f;
+        }
+        Y[i] = unif(rng) < 1.0 / (1.0 + std::exp(-z)) ? 1 : 0;
+    }
+
+    // The optimum, and the loss every optimizer has to reach.
+    double best_loss = 0.0;
+    {
+        LogisticRegression ref(n_features, 0.1f, 500, n_threads);
+        ref.set_solver(SOLVER_LBFGS);
+        ref.set_tolerance(1e-6f);
+        ref.train(X.data(), Y.data(), n_samples);
+        ref.set_solver(SOLVER_GD);
+        ref.set_epoch_callback([&](const EpochStats& st) {
+            best_loss = st.loss;
+            return true;
+        });
+        ref.train(X.data(), Y.data(), n_samples);
+    }
+    const double target = best_loss * 1.0001;
+
+    std::printf("%d samples x %d features, %d thread(s), optimum %.6f, target %.6f\n",
+                n_samples, n_features, n_threads, best_loss, target);
+    std::printf("%10s %8s %8s %10s %12s\n", "optimizer", "lr", "epochs", "time s",
+                "ms / epoch");
+
+    const float lrs[] = {0.01f, 0.03f, 0.1f, 0.3f, 1.0f};
+    for (Optimizer o : {OPTIMIZER_SGD, OPTIMIZER_MOMENTUM, OPTIMIZER_NESTEROV,
+                        OPTIMIZER_ADAGRAD, OPTIMIZER_ADAM}) {
+        int    best_epochs = 0;
+        float  best_lr     = 0.0f;
+        double best_time   = 0.0;
+        for (float lr : lrs) {
+            LogisticRegression model(n_features, lr, max_epochs, n_threads);
+            model.set_optimizer(o);
+            bool reached = false;
+            model.set_epoch_callback([&](const EpochStats& st) {
+                reached = st.loss <= target;
+                return reached || !std::isfinite(st.loss);
+            });
+            const auto   t0 = BenchClock::now();
+            model.train(X.data(), Y.data(), n_samples);
+            const double t  = bench_seconds_since(t0);
+            if (reached && (best_epochs == 0 || model.get_n_passes() < best_epochs)) {
+                best_epochs = model.get_n_passes();
+                best_lr     = lr;
+                best_time   = t;
+            }
+        }
+        if (best_epochs == 0)
+            std::printf("%10s %8s %8s %10s %12s\n", optimizer_name(o), "-",
+                        "> max", "-", "-");
+        else
+            std::printf("%10s %8.2f %8d %10.3f %12.3f\n", optimizer_name(o), best_lr,
+                        best_epochs, best_time, best_time * 1e3 / best_epochs);
+    }
+    return 0;
+}
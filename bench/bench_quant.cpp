@@ -0,0 +1,80 @@
+// bench/bench_quant.cpp  –  float32 vs int8 scoring
+//
+// Usage: bench_quant [n_samples] [n_features] [epochs]
+//
+// Trains a float32 model, quantizes it with the training rows as the
+// calibration sample, and times three ways of scoring the same rows:
+// float32 predict_batch, the int8 model on codes from quantize(), and
+// the int8 model on the float rows (quantized block by block on the
+// way).  It reports the bytes each input takes, the time per call,
+// the accuracy of each model, how often the two agree on the class,
+// and the largest probability difference.
+// Defaults: 1000000 samples, 64 features, 10 epochs.
+
+#include "bench_common.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/QuantizedLogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+int main(int argc, char** argv)
+{
+    const int n_samples  = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int n_features = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int epochs     = argc > 3 ? std::atoi(argv[3]) : 10;
+
+    init_kernels();
+    std::vector<float> X;
+    std::vector<int>   Y;
+    bench_make_dataset(n_samples, n_features, X, Y, 5);
+
+    LogisticRegression model(n_features, 0.1f, epochs, 1);
+    model.train(X.data(), Y.data(), n_samples);
+    const QuantizedLogisticRegression qmodel(model, X.data(), n_samples);
+
+    std::vector<uint8_t> Xq((size_t)n_samples * n_features);
+    qmodel.quantize(X.data(), n_features, n_samples, Xq.data());
+
+    std::printf("%d samples x %d features, int8 kernel: %s\n",
+                n_samples, n_features, active_int8_isa_name());
+    std::printf("%16s %10s %12s %8s %8s\n", "scoring", "X MB", "ms / call",
+                "speedup", "acc");
+
+    std::vector<float> p32(n_samples), p8(n_samples);
+    Workspace ws;
+
+    const double t32 = bench_time([&] {
+        model.predict_batch(X.data(), n_features, p32.data(), n_samples, ws);
+    });
+    const double tq = bench_time([&] {
+        qmodel.predict_batch(Xq.data(), n_features, p8.data(), n_samples);
+    });
+    const double tf = bench_time([&] {
+        qmodel.predict_batch(X.data(), n_features, p8.data(), n_samples, ws);
+    });
+
+    double maxdiff = 0.0;
+    int    hits32 = 0, hits8 = 0, agree = 0;
+    for (int i = 0; i < n_samples; ++i) {
+        const bool c32 = p32[i] >= 0.5f, c8 = p8[i] >= 0.5f;
+        hits32  += c32 == (Y[i] == 1);
+        hits8   += c8 == (Y[i] == 1);
+        agree   += c32 == c8;
+        maxdiff  = std::max(maxdiff, (double)std::fabs(p8[i] - p32[i]));
+    }
+
+    const double mb32 = (double)n_samples * n_features * sizeof(float) / 1e6;
+    const double mb8  = (double)n_samples * n_features / 1e6;
+    const double acc32 = (double)hits32 / n_samples, acc8 = (double)hits8 / n_samples;
+    std::printf("%16s %10.1f %12.3f %7.2fx %8.4f\n", "float32",
+                mb32, t32 * 1e3, 1.0, acc32);
+    std::printf("%16s %10.1f %12.3f %7.2fx %8.4f\n", "int8 codes",
+                mb8, tq * 1e3, t32 / tq, acc8);
+    std::printf("%16s %10.1f %12.3f %7.2fx %8.4f\n", "int8 from float",
+                mb32, tf * 1e3, t32 / tf, acc8);
+    std::printf("accuracy delta %+.4f, class agreement %.4f, max |dp| %.2e\n",
+                acc8 - acc32, (double)agree / n_samples, maxdiff);
+    return 0;
+}
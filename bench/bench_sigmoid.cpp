@@ -0,0 +1,138 @@
+// bench/bench_sigmoid.cpp  –  sigmoid accuracy (ULP) and throughput
+//
+// Usage: bench_sigmoid [lo] [hi] [stride]
+//
+// Runs every sigmoid kernel (accurate and fast tier, each ISA this
+// CPU and build support) on every stride-th float of [lo, hi] and
+// compares against 1 / (1 + exp(-x)) evaluated in double precision.
+// Reports the largest and mean error in ulp of the float result, the
+// input where the largest error occurs, and throughput on an
+// L2-resident buffer.  Defaults: lo = -87, hi = 87, stride = 16;
+// stride 1 visits every float in the range.  Results whose exact
+// value is subnormal (x < -87.3) are skipped.
+
+#include "bench_common.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include "../logreg/include/simd_fn.hpp"
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+struct SigmoidKernel {
+    KernelIsa   isa;
+    const char* isa_name;
+    const char* tier;
+    void (*fn)(const float*, float*, uint64_t);
+};
+
+static const SigmoidKernel KERNELS[] = {
+    {ISA_SCALAR,   "scalar",   "accurate", sigmoid_scalar},
+    {ISA_SSE,      "sse",      "accurate", sigmoid_sse},
+    {ISA_SSE,      "sse",      "fast",     sigmoid_fast_sse},
+    {ISA_AVX,      "avx",      "accurate", sigmoid_avx},
+    {ISA_AVX,      "avx",      "fast",     sigmoid_fast_avx},
+    {ISA_AVX2_FMA, "avx2_fma", "accurate", sigmoid_avx2_fma},
+    {ISA_AVX2_FMA, "avx2_fma", "fast",     sigmoid_fast_avx2_fma},
+#if LOGREG_HAVE_AVX512
+    {ISA_AVX512,   "avx512",   "accurate", sigmoid_avx512},
+    {ISA_AVX512,   "avx512",   "fast",     sigmoid_fast_avx512},
+#endif
+};
+static const int N_KERNELS = (int)(sizeof(KERNELS) / sizeof(KERNELS[0]));
+
+// Map a float to an unsigned key that increases with its value, so
+// stepping the key by one steps to the next representable float.
+static uint32_t float_key(float f)
+{
+    uint32_t b;
+    std::memcpy(&b, &f, sizeof(b));
+    return (b & 0x80000000u) ? ~b : (b | 0x80000000u);
+}
+
+static float key_float(uint32_t k)
+{
+    uint32_t b = (k & 0x80000000u) ? (k & 0x7FFFFFFFu) : ~k;
+    float f;
+    std::memcpy(&f, &b, sizeof(f));
+    return f;
+}
+
+// Size of one ulp at the float nearest to y (y > 0, normal).
+static double ulp_of(double y)
+{
+    int e;
+    std::frexp((float)y, &e);
+    return std::ldexp(1.0, e - 24);
+}
+
+struct UlpStats {
+    double   max_ulp  = 0.0;
+    double   sum_ulp  = 0.0;
+    uint64_t count    = 0;
+    float    worst_x  = 0.0f;
+};
+
+int main(int argc, char** argv)
+{
+    const float    lo     = argc > 1 ? (float)std::atof(argv[1]) : -87.0f;
+    const float    hi     = argc > 2 ? (float)std::atof(argv[2]) : 87.0f;
+    const uint32_t stride = argc > 3 ? (uint32_t)std::atoi(argv[3]) : 16u;
+
+    const KernelIsa top = detect_kernel_isa();
+    const size_t    chunk = 1 << 16;
+
+    std::vector<float>    x(chunk), out(chunk);
+    std::vector<double>   ref(chunk);
+    std::vector<UlpStats> stats(N_KERNELS);
+
+    const uint32_t k_lo = float_key(lo);
+    const uint32_t k_hi = float_key(hi);
+    uint64_t       k    = k_lo;
+
+    while (k <= k_hi) {
+        size_t n = 0;
+        for (; n < chunk && k <= k_hi; ++n, k += stride) {
+            x[n]   = key_float((uint32_t)k);
+            ref[n] = 1.0 / (1.0 + std::exp(-(double)x[n]));
+        }
+
+        for (int i = 0; i < N_KERNELS; ++i) {
+            if (KERNELS[i].isa > top) continue;
+            KERNELS[i].fn(x.data(), out.data(), n);
+
+            UlpStats& s = stats[i];
+            for (size_t j = 0; j < n; ++j) {
+                if (ref[j] < FLT_MIN) continue;
+                double err = std::fabs((double)out[j] - ref[j]) / ulp_of(ref[j]);
+                s.sum_ulp += err;
+                s.count   += 1;
+                if (err > s.max_ulp) {
+                    s.max_ulp = err;
+                    s.worst_x = x[j];
+                }
+            }
+        }
+    }
+
+    // Throughput on 64K values spread over the useful range.
+    for (size_t j = 0; j < chunk; ++j)
+        x[j] = -10.0f + 20.0f * (float)j / (float)chunk;
+
+    std::printf("\nrange [%g, %g], every %u-th float\n", lo, hi, stride);
+    std::printf("%-10s %-9s %12s %12s %14s %10s\n",
+                "isa", "tier", "max_ulp", "mean_ulp", "worst_x", "Gelem/s");
+
+    for (int i = 0; i < N_KERNELS; ++i) {
+        if (KERNELS[i].isa > top) continue;
+        const UlpStats& s = stats[i];
+        double sec = bench_time([&] { KERNELS[i].fn(x.data(), out.data(), chunk); });
+
+        std::printf("%-10s %-9s %12.2f %12.3f %14.7g %10.2f\n",
+                    KERNELS[i].isa_name, KERNELS[i].tier, s.max_ulp,
+                    s.count ? s.sum_ulp / (double)s.count : 0.0,
+                    s.worst_x, (double)chunk / sec * 1e-9);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// bench/bench_softmax.cpp  –  softmax regression vs K one-vs-rest models
+//
+// Usage: bench_softmax [n_samples] [n_features] [epochs]
+//
+// For K = 3, 10 and 32 classes, builds a problem with labels from K
+// random hyperplanes (the largest score wins) and times one epoch of
+// SoftmaxRegression::train against K binary LogisticRegression models
+// trained one-vs-rest, plus predict_proba against K predict_batch
+// calls.  It also reports the training accuracy of both.  Defaults:
+// 100000 samples, 128 features, 5 epochs.
+
+#include "bench_common.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/SoftmaxRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <cstdlib>
+#include <memory>
+
+static void make_problem(int n_samples, int n_features, int n_classes,
+                         std::vector<float>& X, std::vector<int>& Y,
+                         unsigned seed)
+{
+    X.resize((size_t)n_samples * n_features);
+    Y.resize(n_samples);
+    bench_fill_gauss(X, seed);
+
+    std::vector<float> W((size_t)n_classes * n_features);
+    bench_fill_gauss(W, seed + 1);
+    for (int i = 0; i < n_samples; ++i) {
+        const float* x    = X.data() + (size_t)i * n_features;
+        float        best = -1e30f;
+        for (int k = 0; k < n_classes; ++k) {
+            float z = 0.0f;
+            for (int j = 0; j < n_features; ++j)
+                z += x[j] * W[(size_t)k * n_features + j];
+            if (z > best) { best = z; Y[i] = k; }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int n_samples  = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int n_features = argc > 2 ? std::atoi(argv[2]) : 128;
+    const int epochs     = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    init_kernels();
+    std::printf("%d samples x %d features, %d epochs\n", n_samples, n_features, epochs);
+    std::printf("%6s %14s %14s %8s %14s %14s %10s %10s\n", "K", "softmax ms",
+                "K x OvR ms", "speedup", "proba ms", "K x batch ms",
+                "acc", "OvR acc");
+
+    for (int K : {3, 10, 32}) {
+        std::vector<float> X;
+        std::vector<int>   Y;
+        make_problem(n_samples, n_features, K, X, Y, 11 + K);
+
+        SoftmaxRegression softmax(n_features, K, 0.5f, epochs, 1);
+        std::vector<float> proba((size_t)n_samples * K);
+        const double sm_train = bench_time([&] {
+            softmax.train(X.data(), Y.data(), n_samples);
+        }, 0.0, 2) / epochs;
+        const double sm_pred = bench_time([&] {
+            softmax.predict_proba(X.data(), proba.data(), n_samples);
+        }, 0.05, 3);
+
+        std::vector<std::unique_ptr<LogisticRegression>> ovr;
+        std::vector<int> yk(n_samples);
+        for (int k = 0; k < K; ++k)
+            ovr.emplace_back(new LogisticRegression(n_features, 0.5f, epochs, 1));
+        const double ovr_train = bench_time([&] {
+            for (int k = 0; k < K; ++k) {
+                for (int i = 0; i < n_samples; ++i) yk[i] = Y[i] == k;
+                ovr[k]->train(X.data(), yk.data(), n_samples);
+            }
+        }, 0.0, 2) / epochs;
+
+        std::vector<float> pk((size_t)K * n_samples);
+        const double ovr_pred = bench_time([&] {
+            for (int k = 0; k < K; ++k)
+                ovr[k]->predict_batch(X.data(), pk.data() + (size_t)k * n_samples,
+                                      n_samples);
+        }, 0.05, 3);
+
+        std::vector<int> cls(n_samples);
+        softmax.predict_class_batch(X.data(), cls.data(), n_samples);
+        int sm_ok = 0, ovr_ok = 0;
+        for (int i = 0; i < n_samples; ++i) {
+            int best = 0;
+            for (int k = 1; k < K; ++k)
+                if (pk[(size_t)k * n_samples + i] > pk[(size_t)best * n_samples + i])
+                    best = k;
+            sm_ok  += cls[i] == Y[i];
+            ovr_ok += best == Y[i];
+        }
+
+        std::printf("%6d %14.2f %14.2f %7.2fx %14.2f %14.2f %10.3f %10.3f\n", K,
+                    sm_train * 1e3, ovr_train * 1e3, ovr_train / sm_train,
+                    sm_pred * 1e3, ovr_pred * 1e3,
+                    sm_ok / (double)n_samples, ovr_ok / (double)n_samples);
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+// bench/bench_solvers.cpp  –  gradient descent vs L-BFGS vs IRLS
+//
+// Usage: bench_solvers [n_samples] [n_features] [epochs] [n_threads]
+//
+// Trains the same problem with each Solver and reports the passes
+// over X, the wall time, the final mean log-loss and the training
+// accuracy.  The problem is not separable (labels are drawn from the
+// model's own probabilities) and its features have scales from 1 to
+// 5 and a common offset, the conditioning that makes a fixed-step
+// gradient descent slow; the optimum is then finite and every solver
+// heads for the same loss.  GD runs all `epochs` epochs; L-BFGS and
+// IRLS stop at the default tolerance.
+// Defaults: 500000 samples, 32 features, 1000 epochs, 1 thread.
+
+#include "bench_common.hpp"
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <cmath>
+#include <cstdlib>
+
+static const char* solver_name(Solver s)
+{
+    return s == SOLVER_LBFGS ? "L-BFGS" : s == SOLVER_IRLS ? "IRLS" : "GD";
+}
+
+int main(int argc, char** argv)
+{
+    const int n_samples  = argc > 1 ? std::atoi(argv[1]) : 500000;
+    const int n_features = argc > 2 ? std::atoi(argv[2]) : 32;
+    const int epochs     = argc > 3 ? std::atoi(argv[3]) : 1000;
+    const int n_threads  = argc > 4 ? std::atoi(argv[4]) : 1;
+
+    init_kernels();
+    std::vector<float> X((size_t)n_samples * n_features);
+    std::vector<float> w(n_features);
+    std::vector<int>   Y(n_samples);
+    bench_fill_gauss(X, 5);
+    bench_fill_gauss(w, 6);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+    for (int i = 0; i < n_samples; ++i) {
+        double z = 0.25;
+        for (int j = 0; j < n_features; ++j) {
+            const float scale = 1.0f + 4.0f * j / n_features;
+            float&      x     = X[(size_t)i * n_features + j];
+            z += 0.5 * w[j] * x;
+            x  = x * scale + 0.5f;
+        }
+        Y[i] = unif(rng) < 1.0 / (1.0 + std::exp(-z)) ? 1 : 0;
+    }
+
+    std::printf("%d samples x %d features, %d thread(s)\n", n_samples, n_features, n_threads);
+    std::printf("%8s %8s %10s %8s %12s %8s\n", "solver", "passes", "time s",
+                "speedup", "log-loss", "acc");
+
+    std::vector<float> p(n_samples);
+    double gd_time = 0.0;
+    for (Solver s : {SOLVER_GD, SOLVER_LBFGS, SOLVER_IRLS}) {
+        if (s == SOLVER_IRLS && n_features > IRLS_MAX_FEATURES)
+            continue;
+
+        // One timed run from zero weights: a GD run is seconds long.
+        LogisticRegression model(n_features, 0.1f, epochs, n_threads);
+        model.set_solver(s);
+        const auto   t0 = BenchClock::now();
+        model.train(X.data(), Y.data(), n_samples);
+        const double t  = bench_seconds_since(t0);
+        if (s == SOLVER_GD)
+            gd_time = t;
+
+        model.predict_batch(X.data(), p.data(), n_samples);
+        double loss = 0.0;
+        int    hits = 0;
+        for (int i = 0; i < n_samples; ++i) {
+            const double q = std::min(std::max((double)p[i], 1e-7), 1.0 - 1e-7);
+            loss -= Y[i] ? std::log(q) : std::log(1.0 - q);
+            hits += (p[i] >= 0.5f) == (Y[i] == 1);
+        }
+        std::printf("%8s %8d %10.3f %7.1fx %12.6f %8.4f\n", solver_name(s),
+                    model.get_n_passes(), t, gd_time / t, loss / n_samples,
+                    (double)hits / n_samples);
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// bench/bench_threads.cpp  –  thread scaling of train / predict_batch
+//
+// Usage: bench_threads [n_samples] [n_features] [epochs] [max_threads]
+//
+// Trains the same synthetic problem with 1, 2, 4, … max_threads
+// threads and reports wall time, speedup over one thread and the
+// largest probability difference against the single-threaded model.
+
+#include "../logreg/include/LogisticRegression.hpp"
+#include "../logreg/include/logreg_dispatcher.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+static double seconds_since(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv)
+{
+    const int n_samples   = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int n_features  = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int epochs      = argc > 3 ? std::atoi(argv[3]) : 20;
+    int       max_threads = argc > 4 ? std::atoi(argv[4])
+                                     : (int)std::thread::hardware_concurrency();
+    if (max_threads < 1) max_threads = 1;
+
+    init_kernels();
+
+    // ---- synthetic, roughly separable data ----
+    std::mt19937 rng(42);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+    std::vector<float> true_w(n_features);
+    for (float& w : true_w) w = gauss(rng);
+
+    std::vector<float> X((size_t)n_samples * n_features);
+    std::vector<int>   Y(n_samples);
+    for (int i = 0; i < n_samples; ++i) {
+        float z = 0.0f;
+        for (int j = 0; j < n_features; ++j) {
+            float v = gauss(rng);
+            X[(size_t)i * n_features + j] = v;
+            z += v * true_w[j];
+        }
+        Y[i] = z > 0.0f ? 1 : 0;
+    }
+
+    std::vector<int> counts;
+    for (int t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+
+    std::printf("\nn_samples=%d n_features=%d epochs=%d\n",
+                n_samples, n_features, epochs);
+    std::printf("%8s %12s %10s %14s %10s %12s\n",
+                "threads", "train_s", "speedup", "predict_ms", "speedup",
+                "max_dprob");
+
+    std::vector<float> ref(n_samples), probs(n_samples);
+    double train_1 = 0.0, pred_1 = 0.0;
+
+    for (int nt : counts) {
+        LogisticRegression model(n_features, 0.1f, epochs, nt);
+
+        auto t0 = std::chrono::steady_clock::now();
+        model.train(X.data(), Y.data(), n_samples);
+        double train_s = seconds_since(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        model.predict_batch(X.data(), probs.data(), n_samples);
+        double pred_s = seconds_since(t0);
+
+        if (nt == 1) {
+            ref     = probs;
+            train_1 = train_s;
+            pred_1  = pred_s;
+        }
+
+        float max_diff = 0.0f;
+        for (int i = 0; i < n_samples; ++i)
+            max_diff = std::max(max_diff, std::fabs(probs[i] - ref[i]));
+
+        std::printf("%8d %12.4f %10.2f %14.3f %10.2f %12.3g\n",
+                    nt, train_s, train_1 / train_s,
+                    pred_s * 1e3, pred_1 / pred_s, max_diff);
+    }
+    return 0;
+}
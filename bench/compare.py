@@ -0,0 +1,63 @@
+"""Compare two bench_kernels result files (CSV or JSON).
+
+Usage: python3 bench/compare.py OLD NEW [--threshold 0.05]
+
+Rows are matched on (suite, name, isa, shape).  Prints the speed ratio
+old_seconds / new_seconds for every row and exits with status 1 if any
+row got slower by more than the threshold (default 5 %).
+"""
+
+import csv
+import json
+import sys
+
+
+def load(path):
+    if path.endswith(".json"):
+        with open(path) as f:
+            rows = json.load(f)["results"]
+    else:
+        with open(path, newline="") as f:
+            rows = list(csv.DictReader(f))
+    return {(r["suite"], r["name"], r["isa"], r["shape"]): float(r["seconds"])
+            for r in rows}
+
+
+def main(argv):
+    threshold = 0.05
+    args = []
+    i = 1
+    while i < len(argv):
+        if argv[i] == "--threshold":
+            threshold = float(argv[i + 1])
+            i += 2
+        else:
+            args.append(argv[i])
+            i += 1
+    if len(args) != 2:
+        print(__doc__.strip().splitlines()[2])
+        return 2
+
+    old, new = load(args[0]), load(args[1])
+    regressions = 0
+
+    print(f"{'suite':8} {'name':16} {'isa':10} {'shape':34} {'speedup':>8}")
+    for key in sorted(old.keys() & new.keys()):
+        ratio = old[key] / new[key]
+        flag = ""
+        if ratio < 1.0 / (1.0 + threshold):
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{key[0]:8} {key[1]:16} {key[2]:10} {key[3]:34} {ratio:8.3f}{flag}")
+
+    for key in sorted(old.keys() - new.keys()):
+        print("only in old:", *key)
+    for key in sorted(new.keys() - old.keys()):
+        print("only in new:", *key)
+
+    print(f"\n{regressions} regression(s) beyond {threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -1,22 +1,225 @@
 // bindings/py_logreg.cpp  –  pybind11 ↔ NumPy bridge
 //
-// Every NumPy buffer that enters the C++ layer is either already
-// 32-byte aligned (common on modern NumPy ≥ 1.20) or is copied
-// transparently by the LogisticRegression class into aligned
-// scratch storage.  The Python user never has to think about it.
+// Float32 matrices whose rows are contiguous — C-ordered arrays and
+// column slices of them, at any alignment — are passed to the C++
+// layer in place with their row stride; LogisticRegression reads
+// them directly or makes its own padded copy when that is cheaper.
+// Anything else (other dtypes, transposed or reversed views) is
+// converted to one C-contiguous float32 array first.  scipy.sparse
+// matrices go to the CSR overloads with their arrays, also in place
+// when they already have the right dtypes.
 
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 
+#include "ChunkSource.hpp"
+#include "CsrMatrix.hpp"
+#include "Dataset.hpp"
 #include "LogisticRegression.hpp"
+#include "MappedDataset.hpp"
+#include "QuantizedLogisticRegression.hpp"
+#include "SoftmaxRegression.hpp"
+#include "Workspace.hpp"
+#include "half_float.hpp"
 #include "logreg_dispatcher.hpp"
 #include "simd_fn.hpp"
 
+#include <algorithm>
+#include <climits>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
+#include <string>
 
 namespace py = pybind11;
 
+// ---------------------------------------------------------------
+//  Array helpers
+// ---------------------------------------------------------------
+typedef py::array_t<float,   py::array::c_style | py::array::forcecast> FloatArray;
+typedef py::array_t<int32_t, py::array::c_style | py::array::forcecast> IntArray;
+
+// A float32 view of X that LogisticRegression can read in place: unit
+// column stride and a row stride of whole floats, at least one row
+// long.  Otherwise a C-contiguous float32 copy.  ld receives the row
+// stride in floats.
+typedef py::array_t<float, py::array::forcecast> AnyFloatArray;
+
+static AnyFloatArray row_major(AnyFloatArray X, int& ld)
+{
+    if (X.ndim() != 2)
+        throw std::runtime_error("X must be 2-D [n_samples x n_features]");
+
+    const py::ssize_t fs = (py::ssize_t)sizeof(float);
+    const py::ssize_t rs = X.strides(0);
+    if (X.strides(1) == fs && rs >= X.shape(1) * fs && rs % fs == 0) {
+        ld = static_cast<int>(rs / fs);
+        return X;
+    }
+    ld = static_cast<int>(X.shape(1));
+    return FloatArray::ensure(X);
+}
+
+// Int8 codes from QuantizedLogisticRegression.quantize: a uint8 view
+// with unit column stride is used in place (ldq = its row stride in
+// bytes), anything else becomes one C-contiguous uint8 copy.
+typedef py::array_t<uint8_t, py::array::c_style | py::array::forcecast> CodeArray;
+
+static py::array_t<uint8_t> code_rows(py::array_t<uint8_t> Xq, int& ldq)
+{
+    if (Xq.ndim() != 2)
+        throw std::runtime_error("X must be 2-D [n_samples x n_features]");
+
+    const py::ssize_t rs = Xq.strides(0);
+    if (Xq.strides(1) == 1 && rs >= Xq.shape(1)) {
+        ldq = static_cast<int>(rs);
+        return Xq;
+    }
+    ldq = static_cast<int>(Xq.shape(1));
+    return CodeArray::ensure(Xq);
+}
+
+static bool is_codes(const py::object& X)
+{
+    return py::isinstance<py::array_t<uint8_t>>(X);
+}
+
+// CSR arrays of a scipy.sparse matrix: csr_matrix / csr_array as they
+// are, any other format through one tocsr().  indptr and indices are
+// used in place when int32, data when float32; otherwise converted.
+struct SparseRows {
+    py::object mat;         // keeps a converted matrix alive
+    IntArray   indptr;
+    IntArray   indices;
+    FloatArray data;
+    int        n_rows = 0;
+    int        n_cols = 0;
+
+    CsrMatrix csr() const
+    {
+        return CsrMatrix{indptr.data(), indices.data(), data.data(),
+                         n_rows, n_cols};
+    }
+};
+
+// False when X is not a scipy.sparse matrix.  The C++ layer trusts
+// the CSR structure, so it is checked here: a bad indptr or an index
+// out of range would otherwise read out of bounds.
+static bool as_csr(py::handle X, SparseRows& out)
+{
+    if (!py::hasattr(X, "tocsr") || !py::hasattr(X, "format"))
+        return false;
+
+    out.mat = py::reinterpret_borrow<py::object>(X);
+    if (out.mat.attr("format").cast<std::string>() != "csr")
+        out.mat = out.mat.attr("tocsr")();
+
+    py::tuple shape = out.mat.attr("shape");
+    const int64_t rows = shape[0].cast<int64_t>();
+    const int64_t cols = shape[1].cast<int64_t>();
+    const int64_t nnz  = out.mat.attr("nnz").cast<int64_t>();
+    if (rows > INT_MAX || cols > INT_MAX || nnz > INT32_MAX)
+        throw std::runtime_error("sparse X is too large (int32 indices)");
+
+    out.indptr  = out.mat.attr("indptr").cast<IntArray>();
+    out.indices = out.mat.attr("indices").cast<IntArray>();
+    out.data    = out.mat.attr("data").cast<FloatArray>();
+    out.n_rows  = static_cast<int>(rows);
+    out.n_cols  = static_cast<int>(cols);
+
+    const int32_t* ip = out.indptr.data();
+    const int32_t* ix = out.indices.data();
+    if (out.indptr.size() != rows + 1 || ip[0] < 0)
+        throw std::runtime_error("sparse X has a malformed indptr");
+    for (int64_t i = 0; i < rows; ++i)
+        if (ip[i + 1] < ip[i])
+            throw std::runtime_error("sparse X has a malformed indptr");
+    if (ip[rows] > out.indices.size() || ip[rows] > out.data.size())
+        throw std::runtime_error("sparse X indptr points past its data");
+    for (int32_t k = ip[0]; k < ip[rows]; ++k)
+        if (ix[k] < 0 || ix[k] >= out.n_cols)
+            throw std::runtime_error("sparse X has a column index out of range");
+    return true;
+}
+
+// ---------------------------------------------------------------
+//  PyChunkSource  –  ChunkSource over a Python iterable of (X, Y)
+//  chunks.  factory() is called once per epoch and must return a
+//  fresh iterable; chunks may have any number of rows, they are cut
+//  or joined into batches here.  rewind / next run on the model's
+//  loader thread and take the GIL only while touching Python objects.
+// ---------------------------------------------------------------
+class PyChunkSource : public ChunkSource {
+public:
+    PyChunkSource(py::object factory, int n_features)
+        : factory(std::move(factory)), n_features(n_features) {}
+
+    void rewind() override
+    {
+        py::gil_scoped_acquire gil;
+        it    = py::iter(factory());
+        X     = FloatArray();
+        Y     = IntArray();
+        rows  = 0;
+        pos   = 0;
+    }
+
+    int next(float* dst, int stride, int* labels, int max_rows) override
+    {
+        py::gil_scoped_acquire gil;
+        int done = 0;
+
+        while (done < max_rows) {
+            if (pos == rows && !load_chunk())
+                break;
+            const int k = std::min(max_rows - done, rows - pos);
+            const float*   xp = X.data() + (size_t)pos * n_features;
+            const int32_t* yp = Y.data() + pos;
+            for (int r = 0; r < k; ++r)
+                std::memcpy(dst + (size_t)(done + r) * stride,
+                            xp + (size_t)r * n_features,
+                            n_features * sizeof(float));
+            std::memcpy(labels + done, yp, k * sizeof(int));
+            done += k;
+            pos  += k;
+        }
+        return done;
+    }
+
+private:
+    // Advance to the next non-empty chunk; false at the end of the pass.
+    bool load_chunk()
+    {
+        while (it != py::iterator::sentinel()) {
+            py::tuple chunk = py::reinterpret_borrow<py::object>(*it);
+            ++it;
+            if (chunk.size() != 2)
+                throw std::runtime_error("chunks must be (X, Y) pairs");
+            X = chunk[0].cast<FloatArray>();
+            Y = chunk[1].cast<IntArray>();
+            if (X.ndim() != 2 || X.shape(1) != n_features)
+                throw std::runtime_error(
+                    "chunk X must be 2-D [rows x n_features]");
+            if (Y.ndim() != 1 || Y.shape(0) != X.shape(0))
+                throw std::runtime_error(
+                    "chunk Y must be 1-D with one label per row of X");
+            rows = static_cast<int>(X.shape(0));
+            pos  = 0;
+            if (rows > 0)
+                return true;
+        }
+        return false;
+    }
+
+    py::object   factory;
+    int          n_features;
+    py::iterator it;
+    FloatArray   X;
+    IntArray     Y;
+    int          rows = 0;
+    int          pos  = 0;
+};
+
 // ---------------------------------------------------------------
 //  Module definition
 // ---------------------------------------------------------------
@@ -27,17 +230,244 @@ PYBIND11_MODULE(logreg, m)
     // Auto-detect best SIMD kernels once at import time.
     init_kernels();
 
+    m.def("aligned_alloc_count", &aligned_alloc_count,
+          "Number of aligned heap allocations made by the library so far.\n"
+          "A call that leaves it unchanged allocated nothing.");
+
+    py::enum_<SigmoidAccuracy>(m, "SigmoidAccuracy",
+        "Accuracy tier of the vectorised sigmoid used by train / predict_batch.")
+        .value("ACCURATE", SIGMOID_ACCURATE,
+               "Degree-6 exp polynomial and exact division (< 2.5 ulp).")
+        .value("FAST", SIGMOID_FAST,
+               "Degree-4 exp2 polynomial and reciprocal estimate (< 1e-5 relative).");
+
+    py::enum_<FeatureStorage>(m, "FeatureStorage",
+        "Element type feature rows are stored and streamed as.  Weights and\n"
+        "sums are float32 in every case.")
+        .value("F32", STORAGE_F32, "float32 (exact).")
+        .value("F16", STORAGE_F16,
+               "IEEE half precision: ~3 digits, |x| <= 65504, half the bytes.")
+        .value("BF16", STORAGE_BF16,
+               "bfloat16: float32 range, ~2 digits, half the bytes.");
+
+    py::enum_<Solver>(m, "Solver",
+        "Optimiser LogisticRegression.train uses on dense float32 rows.")
+        .value("GD", SOLVER_GD,
+               "`epochs` steps of full-batch gradient descent at lr.")
+        .value("LBFGS", SOLVER_LBFGS,
+               "L-BFGS with a backtracking line search; stops at tol.")
+        .value("IRLS", SOLVER_IRLS,
+               "Newton / IRLS with a Cholesky-solved Hessian; stops at tol.\n"
+               "For up to 1024 features.")
+        .value("HOGWILD", SOLVER_HOGWILD,
+               "`epochs` passes of lock-free asynchronous SGD (Hogwild!);\n"
+               "dense float32 or sparse rows.  See set_hogwild.");
+
+    py::enum_<Optimizer>(m, "Optimizer",
+        "Update rule of the gradient-descent steps (Solver.GD and\n"
+        "train_minibatch); g is the mean gradient.")
+        .value("SGD", OPTIMIZER_SGD, "w -= lr g.")
+        .value("MOMENTUM", OPTIMIZER_MOMENTUM,
+               "m = beta1 m + g,  w -= lr m.")
+        .value("NESTEROV", OPTIMIZER_NESTEROV,
+               "m = beta1 m + g,  w -= lr (g + beta1 m).")
+        .value("ADAGRAD", OPTIMIZER_ADAGRAD,
+               "m += g^2,  w -= lr g / (sqrt(m) + eps).")
+        .value("ADAM", OPTIMIZER_ADAM,
+               "Adam with bias-corrected moments (beta1, beta2, eps).");
+
+    py::class_<EpochStats>(m, "EpochStats",
+        "Progress of one gradient-descent epoch, passed to the epoch\n"
+        "callback.  Losses are mean log-losses at the weights the epoch\n"
+        "started from (averaged over the batches for train_minibatch).")
+        .def_readonly("epoch", &EpochStats::epoch, "0-based epoch index.")
+        .def_readonly("loss", &EpochStats::loss, "Training log-loss.")
+        .def_readonly("grad_norm", &EpochStats::grad_norm,
+                      "L2 norm of the mean gradient (weights and bias).")
+        .def_readonly("val_loss", &EpochStats::val_loss,
+                      "Validation log-loss, nan without a validation set.")
+        .def_readonly("seconds", &EpochStats::seconds,
+                      "Wall time of the epoch.")
+        .def_readonly("elapsed", &EpochStats::elapsed,
+                      "Wall time since train started.")
+        .def("__repr__", [](const EpochStats& st) {
+            return "EpochStats(epoch=" + std::to_string(st.epoch)
+                   + ", loss=" + std::to_string(st.loss)
+                   + ", grad_norm=" + std::to_string(st.grad_norm)
+                   + ", val_loss=" + std::to_string(st.val_loss)
+                   + ", seconds=" + std::to_string(st.seconds) + ")";
+        });
+
+    py::class_<Workspace>(m, "Workspace",
+        "Reusable scratch memory for predict_batch / predict_class_batch.\n\n"
+        "Buffers grow to the largest batch seen and are then reused, so\n"
+        "repeated scoring with the same Workspace does not allocate.")
+        .def(py::init<>())
+        .def_property_readonly("nbytes", &Workspace::bytes,
+             "Bytes currently held by the workspace.")
+        .def("release", &Workspace::release,
+             "Return all memory held by the workspace.");
+
+    // ---- data sets --------------------------------------------------------
+    py::class_<Dataset>(m, "Dataset",
+        "X (and optionally Y) copied once into the padded, aligned layout\n"
+        "the kernels read.  Pass it to LogisticRegression.train /\n"
+        "predict_batch / predict_class_batch to skip the per-call copy.\n"
+        "With storage=FeatureStorage.F16 / .BF16 the rows are rounded to\n"
+        "16 bits, halving memory and the bytes read per epoch.")
+        .def(py::init([](AnyFloatArray X_in, py::object Y_in,
+                         FeatureStorage storage)
+             {
+                 int  ld;
+                 auto X = row_major(X_in, ld);
+                 const int n = static_cast<int>(X.shape(0));
+
+                 IntArray    Y;
+                 const int*  yp = nullptr;
+                 if (!Y_in.is_none()) {
+                     Y = Y_in.cast<IntArray>();
+                     if (Y.ndim() != 1 || Y.shape(0) != n)
+                         throw std::runtime_error(
+                             "Y must be 1-D with one label per row of X");
+                     yp = Y.data();
+                 }
+
+                 py::gil_scoped_release nogil;
+                 return new Dataset(X.data(), ld, yp, n,
+                                    static_cast<int>(X.shape(1)), storage);
+             }),
+             py::arg("X"), py::arg("Y") = py::none(),
+             py::arg("storage") = STORAGE_F32)
+        .def_property_readonly("n_samples", &Dataset::n_samples)
+        .def_property_readonly("n_features", &Dataset::n_features)
+        .def_property_readonly("storage", &Dataset::storage)
+        .def_property_readonly("X",
+             [](py::object self)
+             {
+                 const Dataset& ds = self.cast<const Dataset&>();
+                 if (ds.storage() != STORAGE_F32) {
+                     // 16-bit rows have no float32 view: widen a copy.
+                     const int nf = ds.n_features();
+                     const int pf = ds.padded_features();
+                     const bool bf = ds.storage() == STORAGE_BF16;
+                     py::array_t<float> X({ds.n_samples(), nf});
+                     float* out = X.mutable_data();
+                     for (int i = 0; i < ds.n_samples(); ++i)
+                         for (int j = 0; j < nf; ++j) {
+                             const uint16_t h = ds.Xh()[(size_t)i * pf + j];
+                             out[(size_t)i * nf + j] = bf ? bf16_to_float(h)
+                                                          : half_to_float(h);
+                         }
+                     return X;
+                 }
+                 py::array_t<float> X(
+                     {(py::ssize_t)ds.n_samples(), (py::ssize_t)ds.n_features()},
+                     {(py::ssize_t)ds.padded_features() * (py::ssize_t)sizeof(float),
+                      (py::ssize_t)sizeof(float)},
+                     ds.X(), self);
+                 X.attr("setflags")(py::arg("write") = false);
+                 return X;
+             },
+             "Read-only [n_samples x n_features] view of the stored rows\n"
+             "(a widened float32 copy for 16-bit storage).")
+        .def_property_readonly("Y",
+             [](py::object self) -> py::object
+             {
+                 const Dataset& ds = self.cast<const Dataset&>();
+                 if (!ds.Y())
+                     return py::none();
+                 py::array_t<int32_t> Y(ds.n_samples(), ds.Y(), self);
+                 Y.attr("setflags")(py::arg("write") = false);
+                 return std::move(Y);
+             },
+             "Read-only view of the stored labels (None if there are none).")
+        .def("column_stats",
+             [](const Dataset& self)
+             {
+                 const ColumnStats* cs;
+                 {
+                     py::gil_scoped_release nogil;
+                     cs = &self.column_stats();
+                 }
+                 py::dict d;
+                 d["mean"] = py::array_t<float>(cs->mean.size(), cs->mean.data());
+                 d["std"]  = py::array_t<float>(cs->stddev.size(), cs->stddev.data());
+                 d["min"]  = py::array_t<float>(cs->min.size(), cs->min.data());
+                 d["max"]  = py::array_t<float>(cs->max.size(), cs->max.data());
+                 return d;
+             },
+             "Per-column mean, std (ddof=0), min and max as a dict of arrays.\n"
+             "Computed on the first call and cached.");
+
+    // ---- memory-mapped data sets -----------------------------------------
+    py::enum_<DatasetAdvice>(m, "DatasetAdvice",
+        "Page-cache access hint (madvise) for a MappedDataset.")
+        .value("NORMAL", ADVISE_NORMAL)
+        .value("SEQUENTIAL", ADVISE_SEQUENTIAL,
+               "Aggressive read-ahead; pages may be dropped after use.\n"
+               "For single passes over data sets larger than RAM.")
+        .value("RANDOM", ADVISE_RANDOM, "No read-ahead.")
+        .value("WILLNEED", ADVISE_WILLNEED,
+               "Start reading the whole file in the background.");
+
+    m.def("write_dataset",
+          [](const std::string& path, FloatArray X, IntArray Y)
+          {
+              auto xbuf = X.request();
+              auto ybuf = Y.request();
+              if (xbuf.ndim != 2)
+                  throw std::runtime_error(
+                      "X must be 2-D [n_samples x n_features]");
+              if (ybuf.ndim != 1 || ybuf.shape[0] != xbuf.shape[0])
+                  throw std::runtime_error(
+                      "Y must be 1-D with one label per row of X");
+
+              py::gil_scoped_release nogil;
+              write_dataset(path.c_str(),
+                            static_cast<const float*>(xbuf.ptr),
+                            static_cast<const int*>(ybuf.ptr),
+                            xbuf.shape[0], static_cast<int>(xbuf.shape[1]));
+          },
+          py::arg("path"), py::arg("X"), py::arg("Y"),
+          "Write X [n_samples x n_features] and Y [n_samples] as a padded,\n"
+          "memory-mappable data set (open it with MappedDataset).");
+
+    m.def("convert_raw_dataset",
+          [](const std::string& x_path, const std::string& y_path,
+             int n_features, const std::string& out_path)
+          {
+              py::gil_scoped_release nogil;
+              return convert_raw_dataset(x_path.c_str(), y_path.c_str(),
+                                         n_features, out_path.c_str());
+          },
+          py::arg("x_path"), py::arg("y_path"), py::arg("n_features"),
+          py::arg("out_path"),
+          "Convert a headerless float32 matrix file and an int32 label file\n"
+          "to a memory-mappable data set, streaming both.  Returns n_samples.");
+
+    py::class_<MappedDataset, Dataset>(m, "MappedDataset",
+        "Dataset backed by a read-only memory mapping of a file written by\n"
+        "write_dataset.  Rows are stored pre-padded, so LogisticRegression\n"
+        "reads them straight from the page cache.")
+        .def(py::init<const char*, DatasetAdvice>(),
+             py::arg("path"), py::arg("advice") = ADVISE_WILLNEED)
+        .def("advise", &MappedDataset::advise, py::arg("advice"),
+             "Apply a page-cache access hint to the whole mapping.")
+        .def_property_readonly("nbytes", &MappedDataset::size_bytes,
+             "Size of the mapped file.");
+
     py::class_<LogisticRegression>(m, "LogisticRegression",
         "Binary logistic regression classifier.\n\n"
         "Internally uses SIMD-accelerated dot products and sigmoid.\n"
-        "All data is automatically copied to 32-byte-aligned buffers\n"
-        "when necessary, so NumPy arrays of any alignment are accepted.")
+        "Float32 arrays with contiguous rows (C order or column slices)\n"
+        "are read in place at any alignment; other arrays are converted.")
 
         // ---- constructor ------------------------------------------------
-        .def(py::init<int, float, int>(),
+        .def(py::init<int, float, int, int>(),
              py::arg("n_features"),
-             py::arg("lr")     = 0.1f,
-             py::arg("epochs") = 1000,
+             py::arg("lr")        = 0.1f,
+             py::arg("epochs")    = 1000,
+             py::arg("n_threads") = 1,
              "Create a logistic regression model.\n\n"
              "Parameters\n"
              "----------\n"
@@ -46,13 +476,129 @@ PYBIND11_MODULE(logreg, m)
              "lr : float, optional\n"
              "    Learning rate (default 0.1).\n"
              "epochs : int, optional\n"
-             "    Number of full passes over the training set (default 1000).")
+             "    Number of full passes over the training set (default 1000).\n"
+             "n_threads : int, optional\n"
+             "    Worker threads for train / predict_batch (default 1,\n"
+             "    0 = one per hardware core).")
 
         // ---- train ------------------------------------------------------
+        // The Dataset overloads come first: the array ones accept any
+        // object and convert it.
         .def("train",
+             [](LogisticRegression& self, const Dataset& data)
+             {
+                 py::gil_scoped_release nogil;
+                 self.train(data);
+             },
+             py::arg("data"),
+             "Train on a Dataset or MappedDataset in place, without copying\n"
+             "its rows.")
+
+        .def("train",
+             [](LogisticRegression& self, py::object X_in, IntArray Y)
+             {
+                 if (Y.ndim() != 1)
+                     throw std::runtime_error(
+                         "Y must be 1-D [n_samples]");
+
+                 SparseRows sp;
+                 if (as_csr(X_in, sp)) {
+                     if (sp.n_cols != self.get_n_features())
+                         throw std::runtime_error(
+                             "X.shape[1] does not match n_features");
+                     if (Y.shape(0) != sp.n_rows)
+                         throw std::runtime_error(
+                             "X and Y must have the same number of samples");
+
+                     py::gil_scoped_release nogil;
+                     self.train(sp.csr(), Y.data());
+                     return;
+                 }
+
+                 int  ld;
+                 auto X    = row_major(X_in.cast<AnyFloatArray>(), ld);
+                 auto xbuf = X.request();
+                 auto ybuf = Y.request();
+
+                 if (xbuf.shape[1] != self.get_n_features())
+                     throw std::runtime_error(
+                         "X.shape[1] does not match n_features");
+                 if (xbuf.shape[0] != ybuf.shape[0])
+                     throw std::runtime_error(
+                         "X and Y must have the same number of samples");
+
+                 py::gil_scoped_release nogil;
+                 self.train(
+                     static_cast<const float*>(xbuf.ptr), ld,
+                     static_cast<const int*>(ybuf.ptr),
+                     static_cast<int>(xbuf.shape[0]));
+             },
+             py::arg("X"), py::arg("Y"),
+             "Train on X [n_samples x n_features] and Y [n_samples] in {0,1}.\n"
+             "X may be a scipy.sparse matrix (CSR is read in place): time and\n"
+             "memory then scale with its non-zeros.")
+
+        // ---- online learning ---------------------------------------------
+        .def("partial_fit",
+             [](LogisticRegression& self, py::object X_in, IntArray Y, int steps)
+             {
+                 if (Y.ndim() != 1)
+                     throw std::runtime_error(
+                         "Y must be 1-D [n_samples]");
+
+                 SparseRows sp;
+                 if (as_csr(X_in, sp)) {
+                     if (sp.n_cols != self.get_n_features())
+                         throw std::runtime_error(
+                             "X.shape[1] does not match n_features");
+                     if (Y.shape(0) != sp.n_rows)
+                         throw std::runtime_error(
+                             "X and Y must have the same number of samples");
+
+                     py::gil_scoped_release nogil;
+                     self.partial_fit(sp.csr(), Y.data(), steps);
+                     return;
+                 }
+
+                 int  ld;
+                 auto X    = row_major(X_in.cast<AnyFloatArray>(), ld);
+                 auto xbuf = X.request();
+                 auto ybuf = Y.request();
+
+                 if (xbuf.shape[1] != self.get_n_features())
+                     throw std::runtime_error(
+                         "X.shape[1] does not match n_features");
+                 if (xbuf.shape[0] != ybuf.shape[0])
+                     throw std::runtime_error(
+                         "X and Y must have the same number of samples");
+
+                 py::gil_scoped_release nogil;
+                 self.partial_fit(
+                     static_cast<const float*>(xbuf.ptr), ld,
+                     static_cast<const int*>(ybuf.ptr),
+                     static_cast<int>(xbuf.shape[0]), steps);
+             },
+             py::arg("X"), py::arg("Y"), py::arg("steps") = 1,
+             "Take `steps` gradient steps on the batch X, Y from the current\n"
+             "weights and the optimizer state of the previous call, at\n"
+             "lr / (1 + lr_decay * samples_seen).  X may be dense or\n"
+             "scipy.sparse.  Allocates nothing once a batch of this size\n"
+             "has been seen.")
+        .def_property("lr_decay",
+             &LogisticRegression::get_lr_decay,
+             &LogisticRegression::set_lr_decay,
+             "Decay of the partial_fit step size with the rows seen\n"
+             "(default 0: constant lr).")
+        .def_property_readonly("samples_seen",
+             &LogisticRegression::get_samples_seen,
+             "Rows partial_fit has stepped on, once per step.")
+        .def("reset_online_state", &LogisticRegression::reset_online_state,
+             "Zero the optimizer state and samples_seen, keeping the weights.")
+
+        // ---- mini-batch / streaming training ----------------------------
+        .def("train_minibatch",
              [](LogisticRegression& self,
-                py::array_t<float,   py::array::c_style | py::array::forcecast> X,
-                py::array_t<int32_t, py::array::c_style | py::array::forcecast> Y)
+                FloatArray X, IntArray Y, int batch_size)
              {
                  auto xbuf = X.request();
                  auto ybuf = Y.request();
@@ -69,14 +615,36 @@ PYBIND11_MODULE(logreg, m)
                  if (xbuf.shape[0] != ybuf.shape[0])
                      throw std::runtime_error(
                          "X and Y must have the same number of samples");
+                 if (batch_size <= 0)
+                     throw std::runtime_error("batch_size must be positive");
 
-                 self.train(
-                     static_cast<const float*>(xbuf.ptr),
-                     static_cast<const int*>(ybuf.ptr),
-                     static_cast<int>(xbuf.shape[0]));
+                 ArrayChunkSource src(static_cast<const float*>(xbuf.ptr),
+                                      static_cast<const int*>(ybuf.ptr),
+                                      static_cast<int>(xbuf.shape[0]),
+                                      self.get_n_features());
+                 py::gil_scoped_release nogil;
+                 self.train_minibatch(src, batch_size);
              },
-             py::arg("X"), py::arg("Y"),
-             "Train on X [n_samples x n_features] and Y [n_samples] in {0,1}.")
+             py::arg("X"), py::arg("Y"), py::arg("batch_size"),
+             "Mini-batch gradient descent: one step per batch_size rows\n"
+             "of X, in order, for each epoch.")
+
+        .def("train_stream",
+             [](LogisticRegression& self, py::object chunks, int batch_size)
+             {
+                 if (batch_size <= 0)
+                     throw std::runtime_error("batch_size must be positive");
+
+                 PyChunkSource src(chunks, self.get_n_features());
+                 py::gil_scoped_release nogil;
+                 self.train_minibatch(src, batch_size);
+             },
+             py::arg("chunks"), py::arg("batch_size"),
+             "Out-of-core mini-batch training.  chunks() is called once per\n"
+             "epoch and must return an iterable of (X, Y) pairs, X of shape\n"
+             "[rows x n_features]; rows are regrouped into batches of\n"
+             "batch_size and the next batch is read while the current one\n"
+             "trains.  Only two batches are held in memory.")
 
         // ---- predict (single sample) ------------------------------------
         .def("predict",
@@ -114,13 +682,41 @@ PYBIND11_MODULE(logreg, m)
 
         // ---- predict_batch ----------------------------------------------
         .def("predict_batch",
-             [](const LogisticRegression& self,
-                py::array_t<float, py::array::c_style | py::array::forcecast> X)
+             [](const LogisticRegression& self, const Dataset& data)
              {
+                 py::array_t<float> out(data.n_samples());
+                 float* op = static_cast<float*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     self.predict_batch(data, op);
+                 }
+                 return out;
+             },
+             py::arg("data"),
+             "Return P(y=1 | x_i) for each row of a Dataset.")
+
+        .def("predict_batch",
+             [](const LogisticRegression& self, py::object X_in,
+                Workspace* ws)
+             {
+                 SparseRows sp;
+                 if (as_csr(X_in, sp)) {
+                     if (sp.n_cols != self.get_n_features())
+                         throw std::runtime_error(
+                             "X.shape[1] does not match n_features");
+
+                     py::array_t<float> out(sp.n_rows);
+                     float* op = static_cast<float*>(out.request().ptr);
+                     {
+                         py::gil_scoped_release nogil;
+                         self.predict_batch(sp.csr(), op);
+                     }
+                     return out;
+                 }
+
+                 int  ld;
+                 auto X    = row_major(X_in.cast<AnyFloatArray>(), ld);
                  auto xbuf = X.request();
-                 if (xbuf.ndim != 2)
-                     throw std::runtime_error(
-                         "X must be 2-D [n_samples x n_features]");
                  if (xbuf.shape[1] != self.get_n_features())
                      throw std::runtime_error(
                          "X.shape[1] does not match n_features");
@@ -128,24 +724,57 @@ PYBIND11_MODULE(logreg, m)
                  const int n = static_cast<int>(xbuf.shape[0]);
 
                  py::array_t<float> out(n);
-                 self.predict_batch(
-                     static_cast<const float*>(xbuf.ptr),
-                     static_cast<float*>(out.request().ptr),
-                     n);
+                 const float* xp = static_cast<const float*>(xbuf.ptr);
+                 float*       op = static_cast<float*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     if (ws) self.predict_batch(xp, ld, op, n, *ws);
+                     else    self.predict_batch(xp, ld, op, n);
+                 }
                  return out;
              },
-             py::arg("X"),
-             "Return P(y=1 | x_i) for each row of X as a 1-D array.")
+             py::arg("X"), py::arg("workspace") = nullptr,
+             "Return P(y=1 | x_i) for each row of X as a 1-D array.\n"
+             "X may be a scipy.sparse matrix.  Pass a Workspace to reuse\n"
+             "scratch memory across calls (dense X only).")
 
         // ---- predict_class_batch ----------------------------------------
         .def("predict_class_batch",
-             [](const LogisticRegression& self,
-                py::array_t<float, py::array::c_style | py::array::forcecast> X)
+             [](const LogisticRegression& self, const Dataset& data)
              {
+                 py::array_t<int32_t> out(data.n_samples());
+                 int* op = static_cast<int*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     self.predict_class_batch(data, op);
+                 }
+                 return out;
+             },
+             py::arg("data"),
+             "Return the predicted class of each row of a Dataset.")
+
+        .def("predict_class_batch",
+             [](const LogisticRegression& self, py::object X_in,
+                Workspace* ws)
+             {
+                 SparseRows sp;
+                 if (as_csr(X_in, sp)) {
+                     if (sp.n_cols != self.get_n_features())
+                         throw std::runtime_error(
+                             "X.shape[1] does not match n_features");
+
+                     py::array_t<int32_t> out(sp.n_rows);
+                     int* op = static_cast<int*>(out.request().ptr);
+                     {
+                         py::gil_scoped_release nogil;
+                         self.predict_class_batch(sp.csr(), op);
+                     }
+                     return out;
+                 }
+
+                 int  ld;
+                 auto X    = row_major(X_in.cast<AnyFloatArray>(), ld);
                  auto xbuf = X.request();
-                 if (xbuf.ndim != 2)
-                     throw std::runtime_error(
-                         "X must be 2-D [n_samples x n_features]");
                  if (xbuf.shape[1] != self.get_n_features())
                      throw std::runtime_error(
                          "X.shape[1] does not match n_features");
@@ -153,17 +782,395 @@ PYBIND11_MODULE(logreg, m)
                  const int n = static_cast<int>(xbuf.shape[0]);
 
                  py::array_t<int32_t> out(n);
-                 self.predict_class_batch(
-                     static_cast<const float*>(xbuf.ptr),
-                     static_cast<int*>(out.request().ptr),
-                     n);
+                 const float* xp = static_cast<const float*>(xbuf.ptr);
+                 int*         op = static_cast<int*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     if (ws) self.predict_class_batch(xp, ld, op, n, *ws);
+                     else    self.predict_class_batch(xp, ld, op, n);
+                 }
                  return out;
              },
-             py::arg("X"),
-             "Return predicted class (0 or 1) for each row of X as a 1-D array.")
+             py::arg("X"), py::arg("workspace") = nullptr,
+             "Return predicted class (0 or 1) for each row of X as a 1-D array.\n"
+             "X may be a scipy.sparse matrix.  Pass a Workspace to reuse\n"
+             "scratch memory across calls (dense X only).")
 
         // ---- properties -------------------------------------------------
         .def_property_readonly("n_features",
              &LogisticRegression::get_n_features,
-             "Number of input features the model was created with.");
+             "Number of input features the model was created with.")
+        .def_property_readonly("n_threads",
+             &LogisticRegression::get_n_threads,
+             "Number of threads used by train / predict_batch.")
+        .def_property("sigmoid_accuracy",
+             &LogisticRegression::get_sigmoid_accuracy,
+             &LogisticRegression::set_sigmoid_accuracy,
+             "Sigmoid tier (SigmoidAccuracy.ACCURATE or .FAST) used by\n"
+             "train and predict_batch.")
+        .def_property("feature_storage",
+             &LogisticRegression::get_feature_storage,
+             &LogisticRegression::set_feature_storage,
+             "FeatureStorage that train rounds a float array to (once per\n"
+             "call) before its epochs.  Scoring arrays always reads float32.")
+        .def_property("solver",
+             &LogisticRegression::get_solver,
+             &LogisticRegression::set_solver,
+             "Solver used by train (Solver.GD, .LBFGS or .IRLS).  LBFGS and\n"
+             "IRLS ignore lr and take at most `epochs` iterations.")
+        .def_property("tol",
+             &LogisticRegression::get_tolerance,
+             &LogisticRegression::set_tolerance,
+             "LBFGS / IRLS stop once every component of the mean gradient\n"
+             "is within tol (default 1e-4).")
+        .def("set_optimizer", &LogisticRegression::set_optimizer,
+             py::arg("optimizer"), py::arg("beta1") = 0.9f,
+             py::arg("beta2") = 0.999f, py::arg("eps") = 1e-8f,
+             "Update rule of gradient descent (default Optimizer.SGD).\n"
+             "Momentum and Nesterov use beta1 as the momentum, Adam both\n"
+             "betas; eps offsets the AdaGrad / Adam denominators.  The\n"
+             "state starts from zero at every train call.")
+        .def_property_readonly("optimizer",
+             &LogisticRegression::get_optimizer,
+             "Optimizer set by set_optimizer.")
+        .def("set_hogwild", &LogisticRegression::set_hogwild,
+             py::arg("step"), py::arg("n_threads") = 0,
+             "Solver.HOGWILD: each of n_threads pool threads (0: all of\n"
+             "them) runs every epoch over its own shard of the rows,\n"
+             "stepping w -= step (p - y) x per row on the shared weights\n"
+             "without locks.  step is per row (default 0.01).  Not\n"
+             "deterministic with more than one thread.")
+        .def_property_readonly("hogwild_step",
+             &LogisticRegression::get_hogwild_step)
+        .def_property_readonly("hogwild_threads",
+             &LogisticRegression::get_hogwild_threads)
+        .def_property_readonly("n_passes",
+             &LogisticRegression::get_n_passes,
+             "Passes over the training rows made by the last train call.")
+        .def_property_readonly("samples_per_second",
+             &LogisticRegression::get_samples_per_second,
+             "Training rows processed per second by the last train call.")
+
+        // ---- convergence monitoring -------------------------------------
+        .def("set_early_stopping", &LogisticRegression::set_early_stopping,
+             py::arg("loss_tol"), py::arg("grad_tol") = 0.0f,
+             py::arg("patience") = 5,
+             "Stop gradient descent once the monitored loss (validation loss\n"
+             "when a validation set is given, else training loss) has not\n"
+             "improved on its best by more than loss_tol for `patience`\n"
+             "epochs, or once the mean gradient's L2 norm is within\n"
+             "grad_tol.  0 disables a test (both are off by default).")
+        .def("set_validation",
+             [](LogisticRegression& self, const Dataset* data)
+             {
+                 self.set_validation(data);
+             },
+             py::arg("data").none(true), py::keep_alive<1, 2>(),
+             "Score a labelled Dataset after every epoch (None: stop).  Its\n"
+             "log-loss drives early stopping, and train ends on the weights\n"
+             "of the epoch where it was lowest.")
+        .def("set_epoch_callback",
+             [](LogisticRegression& self, py::object fn)
+             {
+                 if (fn.is_none()) {
+                     self.set_epoch_callback(EpochCallback());
+                     return;
+                 }
+                 // train runs without the GIL: take it for the call.
+                 self.set_epoch_callback([fn](const EpochStats& st) {
+                     py::gil_scoped_acquire gil;
+                     return py::bool_(fn(st)).cast<bool>();
+                 });
+             },
+             py::arg("fn").none(true),
+             "Call fn(EpochStats) after every gradient-descent epoch; a true\n"
+             "return value stops training.  None removes the callback.");
+
+    py::class_<SoftmaxRegression>(m, "SoftmaxRegression",
+        "Multinomial (softmax) logistic regression over n_classes classes.\n\n"
+        "Each epoch reads X once for all classes.  Dense float32 arrays\n"
+        "with contiguous rows are read in place, as for LogisticRegression.")
+
+        .def(py::init<int, int, float, int, int>(),
+             py::arg("n_features"),
+             py::arg("n_classes"),
+             py::arg("lr")        = 0.1f,
+             py::arg("epochs")    = 1000,
+             py::arg("n_threads") = 1,
+             "Create a softmax regression model.\n\n"
+             "Parameters\n"
+             "----------\n"
+             "n_features : int\n"
+             "    Number of input features (columns of X).\n"
+             "n_classes : int\n"
+             "    Number of classes (>= 2); labels are 0 .. n_classes - 1.\n"
+             "lr : float, optional\n"
+             "    Learning rate (default 0.1).\n"
+             "epochs : int, optional\n"
+             "    Number of full passes over the training set (default 1000).\n"
+             "n_threads : int, optional\n"
+             "    Worker threads (default 1, 0 = one per hardware core).")
+
+        .def("train",
+             [](SoftmaxRegression& self, AnyFloatArray X_in, IntArray Y)
+             {
+                 if (Y.ndim() != 1)
+                     throw std::runtime_error(
+                         "Y must be 1-D [n_samples]");
+
+                 int  ld;
+                 auto X    = row_major(X_in, ld);
+                 auto xbuf = X.request();
+                 auto ybuf = Y.request();
+
+                 if (xbuf.shape[1] != self.get_n_features())
+                     throw std::runtime_error(
+                         "X.shape[1] does not match n_features");
+                 if (xbuf.shape[0] != ybuf.shape[0])
+                     throw std::runtime_error(
+                         "X and Y must have the same number of samples");
+
+                 py::gil_scoped_release nogil;
+                 self.train(
+                     static_cast<const float*>(xbuf.ptr), ld,
+                     static_cast<const int*>(ybuf.ptr),
+                     static_cast<int>(xbuf.shape[0]));
+             },
+             py::arg("X"), py::arg("Y"),
+             "Train on X [n_samples x n_features] and Y [n_samples] in\n"
+             "0 .. n_classes - 1.")
+
+        .def("predict_proba",
+             [](const SoftmaxRegression& self, AnyFloatArray X_in,
+                Workspace* ws)
+             {
+                 int  ld;
+                 auto X    = row_major(X_in, ld);
+                 auto xbuf = X.request();
+                 if (xbuf.shape[1] != self.get_n_features())
+                     throw std::runtime_error(
+                         "X.shape[1] does not match n_features");
+
+                 const int n = static_cast<int>(xbuf.shape[0]);
+
+                 py::array_t<float> out({(py::ssize_t)n,
+                                         (py::ssize_t)self.get_n_classes()});
+                 const float* xp = static_cast<const float*>(xbuf.ptr);
+                 float*       op = static_cast<float*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     if (ws) self.predict_proba(xp, ld, op, n, *ws);
+                     else    self.predict_proba(xp, ld, op, n);
+                 }
+                 return out;
+             },
+             py::arg("X"), py::arg("workspace") = nullptr,
+             "Return P(y=k | x_i) as a 2-D array [n_samples x n_classes]\n"
+             "whose rows sum to 1.")
+
+        .def("predict_class_batch",
+             [](const SoftmaxRegression& self, AnyFloatArray X_in,
+                Workspace* ws)
+             {
+                 int  ld;
+                 auto X    = row_major(X_in, ld);
+                 auto xbuf = X.request();
+                 if (xbuf.shape[1] != self.get_n_features())
+                     throw std::runtime_error(
+                         "X.shape[1] does not match n_features");
+
+                 const int n = static_cast<int>(xbuf.shape[0]);
+
+                 py::array_t<int32_t> out(n);
+                 const float* xp = static_cast<const float*>(xbuf.ptr);
+                 int*         op = static_cast<int*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     if (ws) self.predict_class_batch(xp, ld, op, n, *ws);
+                     else    self.predict_class_batch(xp, ld, op, n);
+                 }
+                 return out;
+             },
+             py::arg("X"), py::arg("workspace") = nullptr,
+             "Return the most likely class of each row of X as a 1-D array.")
+
+        .def_property_readonly("n_features",
+             &SoftmaxRegression::get_n_features,
+             "Number of input features the model was created with.")
+        .def_property_readonly("n_classes",
+             &SoftmaxRegression::get_n_classes,
+             "Number of classes the model was created with.")
+        .def_property_readonly("n_threads",
+             &SoftmaxRegression::get_n_threads,
+             "Number of threads used by train / predict.")
+        .def_property("exp_accuracy",
+             &SoftmaxRegression::get_exp_accuracy,
+             &SoftmaxRegression::set_exp_accuracy,
+             "exp tier (SigmoidAccuracy.ACCURATE or .FAST) of the softmax.");
+
+    // ---- int8 scoring -----------------------------------------------------
+    py::class_<QuantizedLogisticRegression>(m, "QuantizedLogisticRegression",
+        "Int8 scoring copy of a trained LogisticRegression.\n\n"
+        "Each feature is mapped onto codes 0 .. 127 over its [min, max] in a\n"
+        "calibration sample, and the weights are rounded to int8.  Score the\n"
+        "uint8 codes from quantize() to read a quarter of the bytes of\n"
+        "float32 rows; float arrays are accepted too and quantized on the fly.")
+
+        .def(py::init([](const LogisticRegression& model, AnyFloatArray X_in,
+                         int n_threads)
+             {
+                 int  ld;
+                 auto X    = row_major(X_in, ld);
+                 auto xbuf = X.request();
+                 if (xbuf.shape[1] != model.get_n_features())
+                     throw std::runtime_error(
+                         "X_cal.shape[1] does not match n_features");
+
+                 return new QuantizedLogisticRegression(
+                     model, static_cast<const float*>(xbuf.ptr), ld,
+                     static_cast<int>(xbuf.shape[0]), n_threads);
+             }),
+             py::arg("model"), py::arg("X_cal"), py::arg("n_threads") = 1,
+             "Quantize a trained model, calibrating the feature ranges on the\n"
+             "rows of X_cal (typically a sample of the training data; values\n"
+             "outside their column's range are clamped when scored).")
+
+        .def("quantize",
+             [](const QuantizedLogisticRegression& self, AnyFloatArray X_in)
+             {
+                 int  ld;
+                 auto X    = row_major(X_in, ld);
+                 auto xbuf = X.request();
+                 if (xbuf.shape[1] != self.get_n_features())
+                     throw std::runtime_error(
+                         "X.shape[1] does not match n_features");
+
+                 const int n  = static_cast<int>(xbuf.shape[0]);
+                 const int nf = self.get_n_features();
+
+                 py::array_t<uint8_t> out({(py::ssize_t)n, (py::ssize_t)nf});
+                 const float* xp = static_cast<const float*>(xbuf.ptr);
+                 uint8_t*     op = static_cast<uint8_t*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     self.quantize(xp, ld, n, op);
+                 }
+                 return out;
+             },
+             py::arg("X"),
+             "Return the uint8 codes of X as a 2-D array [n_samples x n_features].")
+
+        .def("predict_batch",
+             [](const QuantizedLogisticRegression& self, py::object X_in,
+                Workspace* ws)
+             {
+                 const bool codes = is_codes(X_in);
+                 int        ld;
+                 py::array  X = codes
+                     ? py::array(code_rows(X_in.cast<py::array_t<uint8_t>>(), ld))
+                     : py::array(row_major(X_in.cast<AnyFloatArray>(), ld));
+                 auto xbuf = X.request();
+                 if (xbuf.ndim != 2 || xbuf.shape[1] != self.get_n_features())
+                     throw std::runtime_error(
+                         "X.shape[1] does not match n_features");
+
+                 const int n = static_cast<int>(xbuf.shape[0]);
+
+                 py::array_t<float> out(n);
+                 float* op = static_cast<float*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     if (codes)
+                         self.predict_batch(static_cast<const uint8_t*>(xbuf.ptr),
+                                            ld, op, n);
+                     else if (ws)
+                         self.predict_batch(static_cast<const float*>(xbuf.ptr),
+                                            ld, op, n, *ws);
+                     else
+                         self.predict_batch(static_cast<const float*>(xbuf.ptr),
+                                            ld, op, n);
+                 }
+                 return out;
+             },
+             py::arg("X"), py::arg("workspace") = nullptr,
+             "Return P(y=1 | x_i) for each row of X as a 1-D array.  X is\n"
+             "either uint8 codes from quantize() or a float array.")
+
+        .def("predict_class_batch",
+             [](const QuantizedLogisticRegression& self, py::object X_in,
+                Workspace* ws)
+             {
+                 const bool codes = is_codes(X_in);
+                 int        ld;
+                 py::array  X = codes
+                     ? py::array(code_rows(X_in.cast<py::array_t<uint8_t>>(), ld))
+                     : py::array(row_major(X_in.cast<AnyFloatArray>(), ld));
+                 auto xbuf = X.request();
+                 if (xbuf.ndim != 2 || xbuf.shape[1] != self.get_n_features())
+                     throw std::runtime_error(
+                         "X.shape[1] does not match n_features");
+
+                 const int n = static_cast<int>(xbuf.shape[0]);
+
+                 py::array_t<int32_t> out(n);
+                 int* op = static_cast<int*>(out.request().ptr);
+                 {
+                     py::gil_scoped_release nogil;
+                     Workspace  local;
+                     Workspace& w = ws ? *ws : local;
+                     if (codes)
+                         self.predict_class_batch(static_cast<const uint8_t*>(xbuf.ptr),
+                                                  ld, op, n, w);
+                     else
+                         self.predict_class_batch(static_cast<const float*>(xbuf.ptr),
+                                                  ld, op, n, w);
+                 }
+                 return out;
+             },
+             py::arg("X"), py::arg("workspace") = nullptr,
+             "Return predicted class (0 or 1) for each row of X as a 1-D array.\n"
+             "X is either uint8 codes from quantize() or a float array.")
+
+        .def_property_readonly("n_features",
+             &QuantizedLogisticRegression::get_n_features,
+             "Number of input features.")
+        .def_property_readonly("n_threads",
+             &QuantizedLogisticRegression::get_n_threads,
+             "Number of threads used by quantize / predict_batch.")
+        .def_property_readonly("scale",
+             [](const QuantizedLogisticRegression& self)
+             {
+                 const int nf = self.get_n_features();
+                 py::array_t<float> out(nf);
+                 std::memcpy(out.mutable_data(), self.get_scale(), nf * sizeof(float));
+                 return out;
+             },
+             "Per-feature step between consecutive codes.")
+        .def_property_readonly("zero_point",
+             [](const QuantizedLogisticRegression& self)
+             {
+                 const int nf = self.get_n_features();
+                 py::array_t<float> out(nf);
+                 std::memcpy(out.mutable_data(), self.get_zero_point(), nf * sizeof(float));
+                 return out;
+             },
+             "Per-feature value of code 0.")
+        .def_property_readonly("weights",
+             [](const QuantizedLogisticRegression& self)
+             {
+                 const int nf = self.get_n_features();
+                 py::array_t<int8_t> out(nf);
+                 std::memcpy(out.mutable_data(), self.get_weights(), nf);
+                 return out;
+             },
+             "Int8 weights (feature scales folded in).")
+        .def_property_readonly("weight_scale",
+             &QuantizedLogisticRegression::get_weight_scale,
+             "Float value of one int8 weight step.")
+        .def_property_readonly("offset",
+             &QuantizedLogisticRegression::get_offset,
+             "Logit of the all-zero code row: bias + sum(w * zero_point).");
+
+    m.def("int8_kernel", &active_int8_isa_name,
+          "Name of the int8 dot-product kernel selected for this CPU.");
 }
@@ -0,0 +1,123 @@
+#include "include/Dataset.hpp"
+#include "include/half_float.hpp"
+#include "include/simd_fn.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+static inline int pad8(int n) { return (n + 7) & ~7; }
+
+// -------------------------------------------------------------------
+//  Construction / destruction
+// -------------------------------------------------------------------
+
+Dataset::Dataset()
+    : x(nullptr), xh(nullptr), format(STORAGE_F32), y(nullptr), rows(0),
+      features(0), padded(0), own_x(nullptr)
+{
+}
+
+Dataset::Dataset(const float* X, const int* Y, int n_samples, int n_features,
+                 FeatureStorage storage)
+    : Dataset(X, n_features, Y, n_samples, n_features, storage)
+{
+}
+
+Dataset::Dataset(const float* X, int ld, const int* Y, int n_samples,
+                 int n_features, FeatureStorage storage)
+    : Dataset()
+{
+    if (n_samples < 0 || n_features <= 0 || ld < n_features)
+        throw std::runtime_error("Dataset: bad shape");
+
+    rows     = n_samples;
+    features = n_features;
+    padded   = pad8(n_features);
+    format   = storage;
+
+    // Rows are copied once, pad columns zeroed so SIMD dot products
+    // over padded_features elements are exact.  16-bit rows take half
+    // the floats.
+    const size_t n    = (size_t)rows * padded;
+    const size_t nflt = storage == STORAGE_F32 ? n : (n + 1) / 2;
+    own_x = aligned_alloc_float(std::max<size_t>(1, nflt), 64);
+    if (!own_x)
+        throw std::bad_alloc();
+
+    if (storage == STORAGE_F32) {
+        for (int i = 0; i < rows; ++i) {
+            float* dst = own_x + (size_t)i * padded;
+            std::memcpy(dst, X + (size_t)i * ld, features * sizeof(float));
+            std::memset(dst + features, 0, (padded - features) * sizeof(float));
+        }
+        x = own_x;
+    } else {
+        uint16_t* h = reinterpret_cast<uint16_t*>(own_x);
+        for (int i = 0; i < rows; ++i) {
+            uint16_t* dst = h + (size_t)i * padded;
+            if (storage == STORAGE_BF16) float_to_bf16_row(X + (size_t)i * ld, dst, features);
+            else                         float_to_half_row(X + (size_t)i * ld, dst, features);
+            std::memset(dst + features, 0, (padded - features) * sizeof(uint16_t));
+        }
+        xh = h;
+    }
+
+    if (Y) {
+        own_y.assign(Y, Y + rows);
+        y = own_y.data();
+    }
+}
+
+Dataset::~Dataset()
+{
+    aligned_free_float(own_x);
+}
+
+// -------------------------------------------------------------------
+//  Column statistics
+//  One pass over the rows, accumulating in double so the variance of
+//  large sets does not lose its low digits.  16-bit rows are widened
+//  one at a time, so the statistics are those of the stored values.
+// -------------------------------------------------------------------
+
+const ColumnStats& Dataset::column_stats() const
+{
+    std::call_once(stats_once, [this] {
+        const int           nf = features;
+        std::vector<double> sum(nf, 0.0), sq(nf, 0.0);
+        std::unique_ptr<ColumnStats> s(new ColumnStats);
+        s->min.assign(nf, std::numeric_limits<float>::infinity());
+        s->max.assign(nf, -std::numeric_limits<float>::infinity());
+
+        std::vector<float> wide(xh ? nf : 0);
+        for (int i = 0; i < rows; ++i) {
+            const float* xi = x + (size_t)i * padded;
+            if (xh) {
+                const uint16_t* hi = xh + (size_t)i * padded;
+                for (int j = 0; j < nf; ++j)
+                    wide[j] = format == STORAGE_BF16 ? bf16_to_float(hi[j])
+                                                     : half_to_float(hi[j]);
+                xi = wide.data();
+            }
+            for (int j = 0; j < nf; ++j) {
+                sum[j] += xi[j];
+                sq[j]  += (double)xi[j] * xi[j];
+                s->min[j] = std::min(s->min[j], xi[j]);
+                s->max[j] = std::max(s->max[j], xi[j]);
+            }
+        }
+
+        s->mean.resize(nf);
+        s->stddev.resize(nf);
+        for (int j = 0; j < nf; ++j) {
+            const double m = rows ? sum[j] / rows : 0.0;
+            const double v = rows ? sq[j] / rows - m * m : 0.0;
+            s->mean[j]   = (float)m;
+            s->stddev[j] = (float)std::sqrt(std::max(0.0, v));
+        }
+        stats = std::move(s);
+    });
+    return *stats;
+}
@@ -1,172 +1,1123 @@
 #include "include/LogisticRegression.hpp"
+#include "include/ChunkSource.hpp"
+#include "include/CsrMatrix.hpp"
+#include "include/Dataset.hpp"
+#include "include/ThreadPool.hpp"
+#include "include/half_float.hpp"
 #include "include/logreg_dispatcher.hpp"
+#include "include/model_loops.hpp"
 #include "include/simd_fn.hpp"
+#include "include/simd_math.hpp"
+#include "include/solvers.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
 
 // Round n up to the next multiple of 8 (so every row is 32-byte aligned
 // when stored as floats).
 static inline int pad8(int n) { return (n + 7) & ~7; }
 
+// Round n up to the next multiple of 16 floats (one 64-byte cache line),
+// used to keep per-thread accumulators from sharing a line.
+static inline int pad16(int n) { return (n + 15) & ~15; }
+
+// -------------------------------------------------------------------
+//  Datasets are stored with the model's own padding (n_features
+//  rounded up to 8), so only the width has to match.
+// -------------------------------------------------------------------
+static void check_dataset(const Dataset& data, int n_features)
+{
+    if (data.n_features() != n_features)
+        throw std::runtime_error("data set n_features does not match the model");
+}
+
+// Rows per work block: enough to fill ~128 KB of padded X so a block
+// stays resident in L2 while a thread works on it.
+static inline int block_rows(int padded_features)
+{
+    const int rows = (128 * 1024) / (padded_features * (int)sizeof(float));
+    return std::max(8, rows & ~7);
+}
+
+// The same ~128 KB for CSR rows, at 8 bytes (value + index) per
+// non-zero and the average row length of X.
+static inline int block_rows(const CsrMatrix& X)
+{
+    const int64_t nnz  = std::max<int64_t>(1, X.nnz());
+    const int64_t rows = (int64_t)X.n_rows * (128 * 1024 / 8) / nnz;
+    return (int)std::max<int64_t>(8, std::min<int64_t>(rows, 1 << 20) & ~7);
+}
+
+static void check_csr(const CsrMatrix& X, int n_features)
+{
+    if (X.n_cols != n_features)
+        throw std::runtime_error("sparse X n_cols does not match the model");
+}
+
+// Sets samples_per_sec of one train call when it returns: its rows
+// times the passes it made, over its wall time.
+namespace {
+
+class ThroughputTimer {
+public:
+    ThroughputTimer(double& out, const int& passes, int rows)
+        : out(out), passes(passes), rows(rows),
+          start(std::chrono::steady_clock::now()) {}
+
+    ~ThroughputTimer()
+    {
+        const double s = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        out = s > 0.0 ? (double)passes * rows / s : 0.0;
+    }
+
+private:
+    double&                                 out;
+    const int&                              passes;
+    int                                     rows;
+    std::chrono::steady_clock::time_point   start;
+};
+
+} // namespace
+
 // -------------------------------------------------------------------
 //  Construction / destruction
 // -------------------------------------------------------------------
 
-LogisticRegression::LogisticRegression(int n_features, float lr, int epochs)
+LogisticRegression::LogisticRegression(int n_features, float lr, int epochs,
+                                       int n_threads)
     : n_features(n_features),
       padded_features(pad8(n_features)),
       lr(lr),
       epochs(epochs),
-      bias(0.0f)
+      bias(0.0f),
+      opt_buffer(nullptr),
+      lr_decay(0.0f),
+      samples_seen(0),
+      sigmoid_accuracy(SIGMOID_ACCURATE),
+      feature_storage(STORAGE_F32),
+      solver(SOLVER_GD),
+      tol(1e-4f),
+      n_passes(0),
+      samples_per_sec(0.0),
+      hogwild_step(0.01f),
+      hogwild_threads(0),
+      stop_loss_tol(0.0f),
+      stop_grad_tol(0.0f),
+      stop_patience(5),
+      validation(nullptr),
+      own_pool(new ThreadPool(n_threads))
 {
+    pool = own_pool.get();
     weights = aligned_alloc_float(padded_features, 32);
     std::memset(weights, 0, padded_features * sizeof(float));
+    std::memset(&opt_state, 0, sizeof(opt_state));
+    opt_state.kind = OPTIMIZER_SGD;
 }
 
 LogisticRegression::~LogisticRegression()
 {
     aligned_free_float(weights);
+    aligned_free_float(opt_buffer);
+}
+
+void LogisticRegression::set_thread_pool(ThreadPool* p)
+{
+    pool = p ? p : own_pool.get();
+}
+
+int LogisticRegression::get_n_threads() const
+{
+    return pool->size();
+}
+
+void LogisticRegression::set_sigmoid_accuracy(SigmoidAccuracy accuracy)
+{
+    sigmoid_accuracy = accuracy;
+}
+
+void LogisticRegression::set_feature_storage(FeatureStorage storage)
+{
+    feature_storage = storage;
+}
+
+void LogisticRegression::set_solver(Solver s)
+{
+    if (s == SOLVER_IRLS && n_features > IRLS_MAX_FEATURES)
+        throw std::runtime_error("SOLVER_IRLS supports at most 1024 features");
+    solver = s;
+}
+
+void LogisticRegression::set_tolerance(float t)
+{
+    tol = t;
+}
+
+void LogisticRegression::set_hogwild(float step, int n_threads)
+{
+    if (!(step > 0.0f))
+        throw std::runtime_error("Hogwild step must be positive");
+    hogwild_step    = step;
+    hogwild_threads = std::max(0, n_threads);
+}
+
+void LogisticRegression::set_optimizer(Optimizer opt, float beta1, float beta2,
+                                       float eps)
+{
+    if (opt != OPTIMIZER_SGD && !opt_buffer) {
+        opt_buffer = aligned_alloc_float(2 * (size_t)padded_features, 32);
+        opt_state.m = opt_buffer;
+        opt_state.v = opt_buffer + padded_features;
+    }
+    opt_state.kind  = opt;
+    opt_state.beta1 = beta1;
+    opt_state.beta2 = beta2;
+    opt_state.eps   = eps;
+    fresh_opt_state();
+}
+
+// Every train call starts the update rule from zero state.
+OptState* LogisticRegression::fresh_opt_state()
+{
+    if (opt_state.kind == OPTIMIZER_SGD)
+        return nullptr;
+    std::memset(opt_buffer, 0, 2 * (size_t)padded_features * sizeof(float));
+    opt_state.mb = opt_state.vb = 0.0f;
+    opt_state.t  = 0;
+    return &opt_state;
+}
+
+// partial_fit carries it on from call to call.
+OptState* LogisticRegression::live_opt_state()
+{
+    return opt_state.kind == OPTIMIZER_SGD ? nullptr : &opt_state;
+}
+
+void LogisticRegression::set_lr_decay(float decay)
+{
+    lr_decay = std::max(0.0f, decay);
+}
+
+void LogisticRegression::reset_online_state()
+{
+    fresh_opt_state();
+    samples_seen = 0;
+}
+
+float LogisticRegression::online_lr() const
+{
+    return lr / (1.0f + lr_decay * static_cast<float>(samples_seen));
+}
+
+void LogisticRegression::set_early_stopping(float loss_tol, float grad_tol,
+                                            int patience)
+{
+    stop_loss_tol = loss_tol;
+    stop_grad_tol = grad_tol;
+    stop_patience = std::max(1, patience);
+}
+
+void LogisticRegression::set_validation(const Dataset* data)
+{
+    if (data) {
+        check_dataset(*data, n_features);
+        if (!data->Y())
+            throw std::runtime_error("validation Dataset has no labels");
+    }
+    validation = data;
+}
+
+void LogisticRegression::set_epoch_callback(EpochCallback callback)
+{
+    epoch_callback = std::move(callback);
+}
+
+// L-BFGS and IRLS run on float32 rows only, Hogwild! on float32 or
+// sparse ones.
+void LogisticRegression::check_gd_solver() const
+{
+    if (solver != SOLVER_GD)
+        throw std::runtime_error("L-BFGS / IRLS need dense float32 rows and "
+                                 "Hogwild float32 or sparse ones; "
+                                 "use SOLVER_GD for other data");
 }
 
 // -------------------------------------------------------------------
-//  Helper: copy row-major X [n_samples × n_features] into a padded,
-//  32-byte-aligned buffer [n_samples × padded_features].
+//  Helper: copy X [n_samples rows, ld floats apart] into the padded,
+//  aligned buffer dst [n_samples × padded_features].
 //  Extra columns are zero-filled so SIMD dot products are exact.
 // -------------------------------------------------------------------
-static float* copy_to_aligned(const float* X, int n_samples,
-                               int n_features, int padded_features)
+static void copy_to_aligned(const float* X, int ld, int n_samples,
+                            int n_features, int padded_features,
+                            float* dst, ThreadPool& pool)
+{
+    const int pf = padded_features;
+    const int bs = block_rows(pf);
+    const int nb = (n_samples + bs - 1) / bs;
+
+    pool.parallel_for(nb, [&](int b, int) {
+        const int end = std::min(n_samples, (b + 1) * bs);
+        for (int i = b * bs; i < end; ++i) {
+            std::memcpy(dst + (size_t)i * pf,
+                        X   + (size_t)i * ld,
+                        n_features * sizeof(float));
+            if (pf > n_features)
+                std::memset(dst + (size_t)i * pf + n_features, 0,
+                            (pf - n_features) * sizeof(float));
+        }
+    });
+}
+
+// -------------------------------------------------------------------
+//  Helper: round X [n_samples rows, ld floats apart] to 16-bit values
+//  in dst [n_samples × padded_features], padding zeroed as above.
+// -------------------------------------------------------------------
+static void copy_to_half(const float* X, int ld, int n_samples,
+                         int n_features, int padded_features,
+                         FeatureStorage storage, uint16_t* dst,
+                         ThreadPool& pool)
 {
     const int pf = padded_features;
-    float* buf = aligned_alloc_float((size_t)n_samples * pf, 32);
-    if (!buf) return nullptr;
+    const int bs = block_rows(pf);
+    const int nb = (n_samples + bs - 1) / bs;
+
+    pool.parallel_for(nb, [&](int b, int) {
+        const int end = std::min(n_samples, (b + 1) * bs);
+        for (int i = b * bs; i < end; ++i) {
+            uint16_t* row = dst + (size_t)i * pf;
+            if (storage == STORAGE_BF16)
+                float_to_bf16_row(X + (size_t)i * ld, row, n_features);
+            else
+                float_to_half_row(X + (size_t)i * ld, row, n_features);
+            if (pf > n_features)
+                std::memset(row + n_features, 0,
+                            (pf - n_features) * sizeof(uint16_t));
+        }
+    });
+}
+
+// -------------------------------------------------------------------
+//  Input rows: in place or a padded copy
+//  The kernels read X in place at any alignment and row stride
+//  (unaligned loads, masked last vector), so the padded copy is only
+//  an optimisation.  Reading in place costs, per row and pass, one
+//  masked tail step when n_features is not a multiple of the vector
+//  width — a scalar gather on the 128-bit tier — and, on that tier
+//  only, split loads when rows are not 16-byte aligned.  The copy
+//  costs about as much as one pass over X, so X is copied only
+//  when the in-place loss over all passes is larger, and large
+//  enough per pass (5 %) to be worth the extra memory.
+// -------------------------------------------------------------------
+static bool copy_pays_off(const float* X, int ld, int n_features, int passes)
+{
+    const KernelIsa isa = active_kernel_isa();
+    if (isa == ISA_SCALAR)
+        return false;
+
+    const int  W   = isa == ISA_AVX512 ? 16 : isa == ISA_SSE ? 4 : 8;
+    const bool sse = isa == ISA_SSE;
+
+    double extra = 0.0;                 // vector steps lost per row
+    if (n_features % W)
+        extra += sse ? 3.0 : 0.25;
+    if (sse && ((uintptr_t)X % 16 != 0 || ld % 4 != 0))
+        extra += 1.0;
+
+    // A row is n_features / W vector steps plus about one step of
+    // per-row work (reduction, sigmoid).
+    const double loss = extra / ((double)n_features / W + 1.0);
+    return loss >= 0.05 && loss * passes > 1.0;
+}
 
-    for (int i = 0; i < n_samples; ++i) {
-        std::memcpy(buf + (size_t)i * pf,
-                    X   + (size_t)i * n_features,
-                    n_features * sizeof(float));
-        if (pf > n_features)
-            std::memset(buf + (size_t)i * pf + n_features, 0,
-                        (pf - n_features) * sizeof(float));
+// X itself when reading it in place is cheaper over `passes` sweeps,
+// else its padded copy in ws.  ld is updated to the returned rows'
+// stride, cols to the floats per row the kernels should read.
+const float* LogisticRegression::input_rows(const float* X, int& ld, int& cols,
+                                            int n_samples, int passes,
+                                            Workspace& ws) const
+{
+    if (!copy_pays_off(X, ld, n_features, passes)) {
+        cols = n_features;
+        return X;
     }
-    return buf;
+    float* padded = ws.x_buffer((size_t)n_samples * padded_features);
+    copy_to_aligned(X, ld, n_samples, n_features, padded_features, padded, *pool);
+    ld = cols = padded_features;
+    return padded;
 }
 
 // -------------------------------------------------------------------
 //  Training – full-batch gradient descent
+//  Each epoch is a single sweep over X: the fused kernel
+//  computes logits, sigmoid and the gradient contribution of a block
+//  while its rows are still in cache.  All scratch memory comes from
+//  the Workspace, so repeated calls of the same shape never allocate.
 // -------------------------------------------------------------------
 
 void LogisticRegression::train(const float* X, const int* Y, int n_samples)
 {
-    const int pf = padded_features;
+    train(X, Y, n_samples, workspace);
+}
 
-    // 1) Copy all training data to an aligned, row-padded buffer.
-    //    Each row starts on a 32-byte boundary so SIMD aligned
-    //    loads are always safe.
-    float* aligned_X = copy_to_aligned(X, n_samples, n_features, pf);
+void LogisticRegression::train(const float* X, const int* Y, int n_samples,
+                               Workspace& ws)
+{
+    train(X, n_features, Y, n_samples, ws);
+}
+
+void LogisticRegression::train(const float* X, int ld, const int* Y,
+                               int n_samples)
+{
+    train(X, ld, Y, n_samples, workspace);
+}
+
+void LogisticRegression::train(const float* X, int ld, const int* Y,
+                               int n_samples, Workspace& ws)
+{
+    const ThroughputTimer timer(samples_per_sec, n_passes, n_samples);
+
+    // 16-bit storage: one rounded, padded copy, read by every epoch.
+    if (feature_storage != STORAGE_F32) {
+        check_gd_solver();
+        const int pf = padded_features;
+        uint16_t* rows = ws.xh_buffer((size_t)n_samples * pf);
+        copy_to_half(X, ld, n_samples, n_features, pf, feature_storage,
+                     rows, *pool);
+        TrainJob job = train_job(nullptr, pf, pf, Y, n_samples, ws);
+        job.Xh      = rows;
+        job.storage = feature_storage;
+        descend(job, half_train_loop, ws);
+        return;
+    }
+
+    // 1) X in place, or padded once when that pays over all epochs.
+    int cols;
+    const float* rows = input_rows(X, ld, cols, n_samples, epochs, ws);
+
+    // 2) The epoch loop itself is compiled per ISA (model_loops.cpp).
+    solve(train_job(rows, ld, cols, Y, n_samples, ws), ws);
+}
+
+void LogisticRegression::train(const Dataset& data)
+{
+    check_dataset(data, n_features);
+    if (!data.Y())
+        throw std::runtime_error("cannot train on a Dataset without labels");
+    const ThroughputTimer timer(samples_per_sec, n_passes, data.n_samples());
+    TrainJob job = train_job(data.X(), padded_features, padded_features,
+                             data.Y(), data.n_samples(), workspace);
+    if (data.storage() == STORAGE_F32) {
+        solve(job, workspace);
+        return;
+    }
+    check_gd_solver();
+    job.Xh      = data.Xh();
+    job.storage = data.storage();
+    descend(job, half_train_loop, workspace);
+}
 
-    // 2) Allocate work buffers (reused across epochs).
-    float* z  = aligned_alloc_float(n_samples, 32);   // logits
-    float* dw = aligned_alloc_float(pf, 32);           // weight gradient
+// Gradient descent runs `epochs` fused epochs, Hogwild! `epochs`
+// unsynchronised ones; L-BFGS and IRLS take their state from ws and
+// stop on their own (solvers.hpp).
+void LogisticRegression::solve(TrainJob job, Workspace& ws)
+{
+    switch (solver) {
+    case SOLVER_LBFGS:
+        n_passes = lbfgs_solve(job, *pool, tol,
+                               ws.solver_buffer(lbfgs_work_floats(job)));
+        break;
+    case SOLVER_IRLS:
+        n_passes = irls_solve(job, *pool, tol,
+                              ws.solver_buffer(irls_work_floats(job, pool->size())));
+        break;
+    case SOLVER_HOGWILD:
+        job.lr     = hogwild_step;
+        job.shards = hogwild_shards();
+        hogwild_loop(job, *pool);
+        n_passes = epochs;
+        break;
+    default:
+        descend(job, train_loop, ws);
+        break;
+    }
+}
+
+// Arguments of train_loop.  Every thread owns one cache-line-padded
+// gradient slot: dw in the first acc floats, db right after.  The
+// slots are reduced once per step.
+TrainJob LogisticRegression::train_job(const float* X, int ld, int cols,
+                                       const int* Y, int n_samples,
+                                       Workspace& ws)
+{
+    const int pf   = padded_features;
+    const int acc  = pad16(pf);
+    const int slot = acc + 16;
+
+    TrainJob job;
+    job.X               = X;
+    job.Xh              = nullptr;
+    job.storage         = STORAGE_F32;
+    job.Y               = Y;
+    job.n_samples       = n_samples;
+    job.n_features      = n_features;
+    job.ld              = ld;
+    job.cols            = cols;
+    job.block_rows      = block_rows(pf);
+    job.grad            = ws.grad_buffer((size_t)pool->size() * slot);
+    job.slot            = slot;
+    job.acc             = acc;
+    job.weights         = weights;
+    job.bias            = &bias;
+    job.lr              = lr;
+    job.epochs          = epochs;
+    job.fast_sigmoid    = sigmoid_accuracy == SIGMOID_FAST;
+    job.hess            = nullptr;
+    job.ldh             = 0;
+    job.hook            = nullptr;
+    job.opt             = nullptr;
+    job.shards          = 1;
+    return job;
+}
+
+int LogisticRegression::hogwild_shards() const
+{
+    const int k = hogwild_threads > 0 ? hogwild_threads : pool->size();
+    return std::min(k, pool->size());
+}
+
+// -------------------------------------------------------------------
+//  Convergence monitoring
+//  The epoch loops hand the monitor the summed loss and gradient of
+//  each epoch (EpochHook, model_loops.hpp).  It adds the validation
+//  loss and the timing, runs the callback, applies the stopping rules
+//  and keeps a copy of the weights with the best validation loss.
+//  train_minibatch steps once per batch, so there the monitor sums
+//  the batches and the epoch is closed by end_pass().
+//  Scratch (Workspace::solver_buffer): the best weights and bias,
+//  the summed batch gradient, then 8 doubles per pool thread for the
+//  validation loss.
+// -------------------------------------------------------------------
+
+namespace {
 
-    for (int epoch = 0; epoch < epochs; ++epoch) {
+class EpochMonitor : public EpochHook {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static size_t scratch_floats(int padded_features, int n_threads)
+    {
+        return 2 * (size_t)pad16(padded_features + 1) + 16 * (size_t)n_threads;
+    }
 
-        // ---- forward pass: z_i = <w, x_i> + b ----
-        for (int i = 0; i < n_samples; ++i) {
-            z[i] = dot_product(aligned_X + (size_t)i * pf,
-                               weights, pf) + bias;
+    EpochMonitor(float loss_tol, float grad_tol, int patience,
+                 const EpochCallback& callback, const ScoreJob* val,
+                 const int* val_y, float* weights, float* bias, int n_features,
+                 int padded_features, bool per_batch, float* scratch,
+                 ThreadPool& pool)
+        : loss_tol(loss_tol), grad_tol(grad_tol), patience(patience),
+          callback(callback), val(val ? *val : ScoreJob()), has_val(val != nullptr),
+          val_y(val_y), weights(weights), bias(bias), n_features(n_features),
+          padded_features(padded_features), per_batch(per_batch),
+          best_w(scratch), gsum(scratch + pad16(padded_features + 1)),
+          sums(reinterpret_cast<double*>(gsum + pad16(padded_features + 1))),
+          pool(pool), start(Clock::now()), epoch_start(start)
+    {
+        std::memset(gsum, 0, (n_features + 1) * sizeof(float));
+    }
+
+    bool end_epoch(double loss, const float* dw, float db, int n) override
+    {
+        if (!per_batch)
+            return close(loss / n, grad_norm(dw, db) / n);
+        axpy(1.0f, dw, gsum, n_features);
+        gsum[n_features] += db;
+        loss_sum         += loss;
+        rows             += n;
+        return false;
+    }
+
+    // train_minibatch: close the epoch made of the batches since the
+    // last call.
+    bool end_pass()
+    {
+        if (rows == 0)
+            return false;
+        const bool stop = close(loss_sum / rows,
+                                grad_norm(gsum, gsum[n_features]) / rows);
+        std::memset(gsum, 0, (n_features + 1) * sizeof(float));
+        loss_sum = 0.0;
+        rows     = 0;
+        return stop;
+    }
+
+    // Leave the weights of the best validation epoch.
+    void finish()
+    {
+        if (!has_val || best_epoch < 0)
+            return;
+        std::memcpy(weights, best_w, padded_features * sizeof(float));
+        *bias = best_w[padded_features];
+    }
+
+    int epochs() const { return epoch; }
+
+private:
+    double grad_norm(const float* dw, float db) const
+    {
+        return std::sqrt((double)dot_product(dw, dw, n_features) + (double)db * db);
+    }
+
+    bool close(double loss, double gnorm)
+    {
+        EpochStats st;
+        st.epoch     = epoch++;
+        st.loss      = loss;
+        st.grad_norm = gnorm;
+        st.val_loss  = std::numeric_limits<double>::quiet_NaN();
+        if (has_val) {
+            val.bias    = *bias;
+            st.val_loss = (val.storage == STORAGE_F32 ? loss_loop : half_loss_loop)(
+                              val, val_y, sums, pool) / val.n_samples;
+        }
+        const Clock::time_point now = Clock::now();
+        st.seconds  = std::chrono::duration<double>(now - epoch_start).count();
+        st.elapsed  = std::chrono::duration<double>(now - start).count();
+
+        const double monitored = has_val ? st.val_loss : st.loss;
+        if (monitored < best) {
+            if (has_val) {
+                std::memcpy(best_w, weights, padded_features * sizeof(float));
+                best_w[padded_features] = *bias;
+                best_epoch              = st.epoch;
+            }
+            stall = monitored < best - loss_tol ? 0 : stall + 1;
+            best  = monitored;
+        } else {
+            ++stall;
         }
 
-        // ---- sigmoid (SIMD-vectorised) ----
-        float* p = sigmoid(z, n_samples);
+        bool stop = callback && callback(st);
+        stop |= loss_tol > 0.0f && stall >= patience;
+        stop |= grad_tol > 0.0f && gnorm <= grad_tol;
+        epoch_start = Clock::now();     // not counting the callback
+        return stop;
+    }
+
+    const float             loss_tol;
+    const float             grad_tol;
+    const int               patience;
+    const EpochCallback&    callback;
+    ScoreJob                val;
+    const bool              has_val;
+    const int*              val_y;
+    float*                  weights;
+    float*                  bias;
+    const int               n_features;
+    const int               padded_features;
+    const bool              per_batch;
+    float*                  best_w;
+    float*                  gsum;
+    double*                 sums;
+    ThreadPool&             pool;
+
+    Clock::time_point       start;
+    Clock::time_point       epoch_start;
+    int                     epoch      = 0;
+    int                     stall      = 0;
+    int                     best_epoch = -1;
+    double                  best       = std::numeric_limits<double>::infinity();
+    double                  loss_sum   = 0.0;
+    int64_t                 rows       = 0;
+};
+
+} // namespace
+
+bool LogisticRegression::monitoring() const
+{
+    return stop_loss_tol > 0.0f || stop_grad_tol > 0.0f || validation
+           || epoch_callback;
+}
+
+ScoreJob LogisticRegression::validation_job() const
+{
+    const Dataset& v   = *validation;
+    ScoreJob       job = score_job(v.X(), padded_features, padded_features,
+                                   v.n_samples(), nullptr, nullptr);
+    job.Xh      = v.Xh();
+    job.storage = v.storage();
+    return job;
+}
+
+template <class Job>
+void LogisticRegression::descend(Job job, void (*loop)(const Job&, ThreadPool&),
+                                 Workspace& ws)
+{
+    job.opt = fresh_opt_state();
+    if (!monitoring()) {
+        loop(job, *pool);
+        n_passes = epochs;
+        return;
+    }
+    const ScoreJob vjob = validation ? validation_job() : ScoreJob();
+    float* scratch = ws.solver_buffer(
+        EpochMonitor::scratch_floats(padded_features, pool->size()));
+    EpochMonitor mon(stop_loss_tol, stop_grad_tol, stop_patience, epoch_callback,
+                     validation ? &vjob : nullptr,
+                     validation ? validation->Y() : nullptr, weights, &bias,
+                     n_features, padded_features, false, scratch, *pool);
+    job.hook = &mon;
+    loop(job, *pool);
+    mon.finish();
+    n_passes = mon.epochs();
+}
+
+// -------------------------------------------------------------------
+//  Training – sparse rows
+//  Same epochs and gradient slots as the dense path; only the
+//  per-block kernel changes (gathered logits, scattered gradient).
+// -------------------------------------------------------------------
+
+void LogisticRegression::train(const CsrMatrix& X, const int* Y)
+{
+    train(X, Y, workspace);
+}
+
+void LogisticRegression::train(const CsrMatrix& X, const int* Y,
+                               Workspace& ws)
+{
+    check_csr(X, n_features);
+    if (solver != SOLVER_HOGWILD)
+        check_gd_solver();
+    const ThroughputTimer timer(samples_per_sec, n_passes, X.n_rows);
+
+    SparseTrainJob job = sparse_train_job(X, Y, ws);
+    if (solver == SOLVER_HOGWILD) {
+        job.lr     = hogwild_step;
+        job.shards = hogwild_shards();
+        sparse_hogwild_loop(job, *pool);
+        n_passes = epochs;
+        return;
+    }
+    descend(job, sparse_train_loop, ws);
+}
+
+// Arguments of sparse_train_loop: the gradient slots of train_job.
+SparseTrainJob LogisticRegression::sparse_train_job(const CsrMatrix& X,
+                                                    const int* Y, Workspace& ws)
+{
+    const int acc  = pad16(padded_features);
+    const int slot = acc + 16;
+
+    SparseTrainJob job;
+    job.X               = X;
+    job.Y               = Y;
+    job.n_features      = n_features;
+    job.block_rows      = block_rows(X);
+    job.grad            = ws.grad_buffer((size_t)pool->size() * slot);
+    job.slot            = slot;
+    job.acc             = acc;
+    job.weights         = weights;
+    job.bias            = &bias;
+    job.lr              = lr;
+    job.epochs          = epochs;
+    job.fast_sigmoid    = sigmoid_accuracy == SIGMOID_FAST;
+    job.hook            = nullptr;
+    job.opt             = nullptr;
+    job.shards          = 1;
+    return job;
+}
+
+// -------------------------------------------------------------------
+//  Training – mini-batch gradient descent on streamed data
+//  Two padded batch buffers: a loader thread fills one from the
+//  ChunkSource while the pool trains on the other, so reading the
+//  next batch (from disk, a socket, ...) overlaps the arithmetic.
+//  Each batch is one gradient step, i.e. a one-epoch train_loop
+//  over the batch.  The padding columns are zeroed once per call
+//  and never written by the source.
+// -------------------------------------------------------------------
+
+namespace {
+
+class BatchLoader {
+public:
+    BatchLoader(ChunkSource& src, float* X, int* Y, int batch_size,
+                int stride, int epochs)
+        : src(src), X(X), Y(Y), batch_size(batch_size), stride(stride),
+          epochs(epochs), thread(&BatchLoader::run, this) {}
+
+    ~BatchLoader()
+    {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            stop = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
 
-        // ---- compute gradients ----
-        std::memset(dw, 0, pf * sizeof(float));
-        float db = 0.0f;
+    // Wait for buffer s and return its row count (0: end of epoch).
+    int acquire(int s)
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        cv.wait(lk, [&] { return full[s]; });
+        if (error)
+            std::rethrow_exception(error);
+        return rows[s];
+    }
 
-        for (int i = 0; i < n_samples; ++i) {
-            float err = p[i] - static_cast<float>(Y[i]);
-            db += err;
-            const float* xi = aligned_X + (size_t)i * pf;
-            for (int j = 0; j < n_features; ++j)
-                dw[j] += err * xi[j];
+    // Hand buffer s back to the loader.
+    void release(int s)
+    {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            full[s] = false;
         }
+        cv.notify_all();
+    }
 
-        // ---- parameter update ----
-        const float inv_n = 1.0f / static_cast<float>(n_samples);
-        for (int j = 0; j < n_features; ++j)
-            weights[j] -= lr * inv_n * dw[j];
-        bias -= lr * inv_n * db;
+    float* batch_x(int s) const { return X + (size_t)s * batch_size * stride; }
+    int*   batch_y(int s) const { return Y + (size_t)s * batch_size; }
 
-        aligned_free_float(p);
+private:
+    void publish(int s, int n)
+    {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            rows[s] = n;
+            full[s] = true;
+        }
+        cv.notify_all();
+    }
+
+    void run()
+    {
+        int s = 0;
+        try {
+            for (int e = 0; e < epochs; ++e) {
+                src.rewind();
+                for (;;) {
+                    {
+                        std::unique_lock<std::mutex> lk(mtx);
+                        cv.wait(lk, [&] { return stop || !full[s]; });
+                        if (stop) return;
+                    }
+                    const int n = std::max(0, src.next(batch_x(s), stride,
+                                                       batch_y(s), batch_size));
+                    publish(s, std::min(n, batch_size));
+                    s ^= 1;
+                    if (n <= 0) break;
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lk(mtx);
+            error   = std::current_exception();
+            full[0] = full[1] = true;
+            cv.notify_all();
+        }
     }
 
-    aligned_free_float(dw);
-    aligned_free_float(z);
-    aligned_free_float(aligned_X);
+    ChunkSource&            src;
+    float*                  X;
+    int*                    Y;
+    int                     batch_size;
+    int                     stride;
+    int                     epochs;
+
+    std::mutex              mtx;
+    std::condition_variable cv;
+    bool                    full[2] = {false, false};
+    int                     rows[2] = {0, 0};
+    bool                    stop    = false;
+    std::exception_ptr      error;
+
+    std::thread             thread;     // last: starts after the state above
+};
+
+} // namespace
+
+void LogisticRegression::train_minibatch(ChunkSource& src, int batch_size)
+{
+    train_minibatch(src, batch_size, workspace);
+}
+
+void LogisticRegression::train_minibatch(ChunkSource& src, int batch_size,
+                                         Workspace& ws)
+{
+    const int    pf = padded_features;
+    const size_t bx = (size_t)batch_size * pf;
+
+    float* xb = ws.batch_buffer(2 * bx);
+    int*   yb = ws.label_buffer(2 * (size_t)batch_size);
+    std::memset(xb, 0, 2 * bx * sizeof(float));
+
+    TrainJob job = train_job(xb, pf, pf, yb, 0, ws);
+    job.epochs = 1;
+    job.opt    = fresh_opt_state();
+
+    // Monitoring: every batch reports to mon, which closes an epoch
+    // after its last batch.
+    std::optional<EpochMonitor> mon;
+    const ScoreJob vjob = validation ? validation_job() : ScoreJob();
+    if (monitoring()) {
+        float* scratch = ws.solver_buffer(
+            EpochMonitor::scratch_floats(pf, pool->size()));
+        mon.emplace(stop_loss_tol, stop_grad_tol, stop_patience, epoch_callback,
+                    validation ? &vjob : nullptr,
+                    validation ? validation->Y() : nullptr, weights, &bias,
+                    n_features, pf, true, scratch, *pool);
+        job.hook = &*mon;
+    }
+
+    BatchLoader loader(src, xb, yb, batch_size, pf, epochs);
+    int s = 0;
+    n_passes = epochs;
+    for (int e = 0; e < epochs; ++e) {
+        for (;;) {
+            const int n = loader.acquire(s);
+            if (n > 0) {
+                job.X         = loader.batch_x(s);
+                job.Y         = loader.batch_y(s);
+                job.n_samples = n;
+                train_loop(job, *pool);
+            }
+            loader.release(s);
+            s ^= 1;
+            if (n == 0) break;
+        }
+        if (mon && mon->end_pass()) {
+            n_passes = e + 1;
+            break;
+        }
+    }
+    if (mon)
+        mon->finish();
 }
 
 // -------------------------------------------------------------------
-//  Single-sample prediction
+//  Online learning – partial_fit
+//  Each step is a one-epoch train_loop over the rows given, at the
+//  decayed step size and on the live optimizer state.  The gradient
+//  slots (and a padded copy of X, when one pays) come from the model's
+//  Workspace, so once it has grown to the batch shape nothing is
+//  allocated.
 // -------------------------------------------------------------------
 
-float LogisticRegression::predict(const float* x) const
+void LogisticRegression::partial_fit(const float* X, const int* Y,
+                                     int n_samples, int steps)
 {
-    const int pf = padded_features;
+    partial_fit(X, n_features, Y, n_samples, steps);
+}
+
+void LogisticRegression::partial_fit(const float* X, int ld, const int* Y,
+                                     int n_samples, int steps)
+{
+    const ThroughputTimer timer(samples_per_sec, n_passes, n_samples);
+    n_passes = 0;
+    if (n_samples <= 0)
+        return;
+
+    int cols;
+    const float* rows = input_rows(X, ld, cols, n_samples, steps, workspace);
+    TrainJob     job  = train_job(rows, ld, cols, Y, n_samples, workspace);
+    job.epochs = 1;
+    job.opt    = live_opt_state();
+    for (; n_passes < steps; ++n_passes) {
+        job.lr = online_lr();
+        train_loop(job, *pool);
+        samples_seen += n_samples;
+    }
+}
+
+void LogisticRegression::partial_fit(const CsrMatrix& X, const int* Y, int steps)
+{
+    check_csr(X, n_features);
+    const ThroughputTimer timer(samples_per_sec, n_passes, X.n_rows);
+    n_passes = 0;
+    if (X.n_rows <= 0)
+        return;
+
+    SparseTrainJob job = sparse_train_job(X, Y, workspace);
+    job.epochs = 1;
+    job.opt    = live_opt_state();
+    for (; n_passes < steps; ++n_passes) {
+        job.lr = online_lr();
+        sparse_train_loop(job, *pool);
+        samples_seen += X.n_rows;
+    }
+}
 
-    // Copy into an aligned scratch buffer so the SIMD dot-product
-    // can always use aligned loads.
-    float* buf = aligned_alloc_float(pf, 32);
-    std::memcpy(buf, x, n_features * sizeof(float));
-    if (pf > n_features)
-        std::memset(buf + n_features, 0,
-                    (pf - n_features) * sizeof(float));
+// -------------------------------------------------------------------
+//  Single-sample prediction (online path)
+//  Reads x in place with unaligned / masked-tail loads: no copy, no
+//  allocation, no call through the dispatcher, no shared state.
+// -------------------------------------------------------------------
 
-    float z = dot_product(buf, weights, pf) + bias;
-    aligned_free_float(buf);
+float LogisticRegression::logit(const float* x) const noexcept
+{
+    return dotu_native(x, weights, n_features) + bias;
+}
 
-    return 1.0f / (1.0f + std::exp(-z));
+float LogisticRegression::predict(const float* x) const noexcept
+{
+    return 1.0f / (1.0f + std::exp(-logit(x)));
 }
 
-int LogisticRegression::predict_class(const float* x) const
+int LogisticRegression::predict_class(const float* x) const noexcept
 {
-    return predict(x) >= 0.5f ? 1 : 0;
+    // sigmoid(z) >= 0.5  <=>  z >= 0
+    return logit(x) >= 0.0f ? 1 : 0;
 }
 
 // -------------------------------------------------------------------
 //  Batch prediction
+//  Logits are written straight into out and turned into
+//  probabilities in place, block by block, by the per-ISA loop
+//  selected in init_kernels().
 // -------------------------------------------------------------------
 
+ScoreJob LogisticRegression::score_job(const float* X, int ld, int cols,
+                                       int n_samples, float* probs,
+                                       int* labels) const
+{
+    ScoreJob job;
+    job.X               = X;
+    job.Xh              = nullptr;
+    job.storage         = STORAGE_F32;
+    job.n_samples       = n_samples;
+    job.ld              = ld;
+    job.cols            = cols;
+    job.block_rows      = block_rows(padded_features);
+    job.weights         = weights;
+    job.bias            = bias;
+    job.fast_sigmoid    = sigmoid_accuracy == SIGMOID_FAST;
+    job.probs           = probs;
+    job.labels          = labels;
+    return job;
+}
+
 void LogisticRegression::predict_batch(const float* X, float* out,
                                        int n_samples) const
 {
-    const int pf = padded_features;
+    Workspace ws;
+    predict_batch(X, out, n_samples, ws);
+}
 
-    // Aligned copy of the whole input matrix.
-    float* aligned_X = copy_to_aligned(X, n_samples, n_features, pf);
+void LogisticRegression::predict_batch(const float* X, float* out,
+                                       int n_samples, Workspace& ws) const
+{
+    predict_batch(X, n_features, out, n_samples, ws);
+}
 
-    // Compute logits into an aligned buffer.
-    float* z = aligned_alloc_float(n_samples, 32);
-    for (int i = 0; i < n_samples; ++i)
-        z[i] = dot_product(aligned_X + (size_t)i * pf,
-                           weights, pf) + bias;
+void LogisticRegression::predict_batch(const float* X, int ld, float* out,
+                                       int n_samples) const
+{
+    Workspace ws;
+    predict_batch(X, ld, out, n_samples, ws);
+}
 
-    // Vectorised sigmoid.
-    float* probs = sigmoid(z, n_samples);
-    std::memcpy(out, probs, n_samples * sizeof(float));
+void LogisticRegression::predict_batch(const float* X, int ld, float* out,
+                                       int n_samples, Workspace& ws) const
+{
+    int cols;
+    const float* rows = input_rows(X, ld, cols, n_samples, 1, ws);
+    predict_loop(score_job(rows, ld, cols, n_samples, out, nullptr), *pool);
+}
 
-    aligned_free_float(probs);
-    aligned_free_float(z);
-    aligned_free_float(aligned_X);
+void LogisticRegression::predict_class_batch(const float* X, int* out,
+                                             int n_samples) const
+{
+    Workspace ws;
+    predict_class_batch(X, out, n_samples, ws);
 }
 
 void LogisticRegression::predict_class_batch(const float* X, int* out,
+                                             int n_samples,
+                                             Workspace& ws) const
+{
+    predict_class_batch(X, n_features, out, n_samples, ws);
+}
+
+void LogisticRegression::predict_class_batch(const float* X, int ld, int* out,
                                              int n_samples) const
 {
-    float* probs = aligned_alloc_float(n_samples, 32);
-    predict_batch(X, probs, n_samples);
+    Workspace ws;
+    predict_class_batch(X, ld, out, n_samples, ws);
+}
 
-    for (int i = 0; i < n_samples; ++i)
-        out[i] = probs[i] >= 0.5f ? 1 : 0;
+void LogisticRegression::predict_class_batch(const float* X, int ld, int* out,
+                                             int n_samples,
+                                             Workspace& ws) const
+{
+    // Only the sign of the logit matters, so no probabilities are
+    // materialised.
+    int cols;
+    const float* rows = input_rows(X, ld, cols, n_samples, 1, ws);
+    classify_loop(score_job(rows, ld, cols, n_samples, nullptr, out), *pool);
+}
 
-    aligned_free_float(probs);
+void LogisticRegression::predict_batch(const Dataset& data,
+                                       float* out) const
+{
+    check_dataset(data, n_features);
+    ScoreJob job = score_job(data.X(), padded_features, padded_features,
+                             data.n_samples(), out, nullptr);
+    if (data.storage() == STORAGE_F32) {
+        predict_loop(job, *pool);
+        return;
+    }
+    job.Xh      = data.Xh();
+    job.storage = data.storage();
+    half_predict_loop(job, *pool);
+}
+
+void LogisticRegression::predict_class_batch(const Dataset& data,
+                                             int* out) const
+{
+    check_dataset(data, n_features);
+    ScoreJob job = score_job(data.X(), padded_features, padded_features,
+                             data.n_samples(), nullptr, out);
+    if (data.storage() == STORAGE_F32) {
+        classify_loop(job, *pool);
+        return;
+    }
+    job.Xh      = data.Xh();
+    job.storage = data.storage();
+    half_classify_loop(job, *pool);
+}
+
+SparseScoreJob LogisticRegression::sparse_score_job(const CsrMatrix& X,
+                                                    float* probs,
+                                                    int* labels) const
+{
+    check_csr(X, n_features);
+
+    SparseScoreJob job;
+    job.X               = X;
+    job.block_rows      = block_rows(X);
+    job.weights         = weights;
+    job.bias            = bias;
+    job.fast_sigmoid    = sigmoid_accuracy == SIGMOID_FAST;
+    job.probs           = probs;
+    job.labels          = labels;
+    return job;
+}
+
+void LogisticRegression::predict_batch(const CsrMatrix& X, float* out) const
+{
+    sparse_predict_loop(sparse_score_job(X, out, nullptr), *pool);
+}
+
+void LogisticRegression::predict_class_batch(const CsrMatrix& X,
+                                             int* out) const
+{
+    sparse_classify_loop(sparse_score_job(X, nullptr, out), *pool);
 }
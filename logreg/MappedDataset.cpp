@@ -0,0 +1,316 @@
+#include "include/MappedDataset.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+static inline int pad8(int n) { return (n + 7) & ~7; }
+
+static inline uint64_t align_up(uint64_t n)
+{
+    return (n + LOGREG_DATASET_ALIGN - 1) & ~(uint64_t)(LOGREG_DATASET_ALIGN - 1);
+}
+
+// 64-bit file positions (long is 32 bits on Windows).
+#if defined(_WIN32)
+# define lr_fseek _fseeki64
+# define lr_ftell _ftelli64
+#else
+# define lr_fseek fseeko
+# define lr_ftell ftello
+#endif
+
+static std::runtime_error file_error(const char* what, const char* path)
+{
+    return std::runtime_error(std::string(what) + ": " + path);
+}
+
+// -------------------------------------------------------------------
+//  Writing
+//  The header is written first, then the rows one at a time through
+//  a single padded row buffer, then the labels, with zero fill up to
+//  each page-aligned section start.  Memory use is one row plus
+//  stdio's buffer whatever the size of the data set.
+// -------------------------------------------------------------------
+
+namespace {
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { std::fclose(f); }
+};
+typedef std::unique_ptr<std::FILE, FileCloser> FilePtr;
+
+class DatasetWriter {
+public:
+    DatasetWriter(const char* path, int64_t n_samples, int n_features)
+        : path(path), out(std::fopen(path, "wb")),
+          row(pad8(n_features), 0.0f), n_features(n_features)
+    {
+        if (!out)
+            throw file_error("cannot create data set", path);
+
+        const uint64_t pf = row.size();
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, LOGREG_DATASET_MAGIC, sizeof(header.magic));
+        header.version         = LOGREG_DATASET_VERSION;
+        header.dtype           = DATASET_F32;
+        header.n_samples       = (uint64_t)n_samples;
+        header.n_features      = (uint32_t)n_features;
+        header.padded_features = (uint32_t)pf;
+        header.x_offset        = LOGREG_DATASET_ALIGN;
+        header.y_offset        = align_up(header.x_offset
+                                          + header.n_samples * pf * sizeof(float));
+        header.file_size       = header.y_offset + header.n_samples * sizeof(int);
+
+        pos = 0;
+        write(&header, sizeof(header));
+        zero_fill(header.x_offset);
+    }
+
+    // Append one row of n_features floats; the padding stays zero.
+    void add_row(const float* x)
+    {
+        std::memcpy(row.data(), x, n_features * sizeof(float));
+        write(row.data(), row.size() * sizeof(float));
+    }
+
+    // Called once, after the last row.
+    void begin_labels() { zero_fill(header.y_offset); }
+
+    void add_labels(const int* y, size_t n) { write(y, n * sizeof(int)); }
+
+    void finish()
+    {
+        if (pos != header.file_size)
+            throw file_error("data set size does not match its header", path);
+        if (std::fclose(out.release()) != 0)
+            throw file_error("write failed", path);
+    }
+
+private:
+    void write(const void* p, size_t bytes)
+    {
+        if (bytes && std::fwrite(p, 1, bytes, out.get()) != bytes)
+            throw file_error("write failed", path);
+        pos += bytes;
+    }
+
+    void zero_fill(uint64_t offset)
+    {
+        static const char zeros[LOGREG_DATASET_ALIGN] = {};
+        while (pos < offset)
+            write(zeros, (size_t)std::min<uint64_t>(offset - pos, sizeof(zeros)));
+    }
+
+    const char*        path;
+    FilePtr            out;
+    std::vector<float> row;
+    int                n_features;
+    DatasetHeader      header;
+    uint64_t           pos;          // bytes written so far
+};
+
+} // namespace
+
+void write_dataset(const char* path, const float* X, const int* Y,
+                   int64_t n_samples, int n_features)
+{
+    DatasetWriter w(path, n_samples, n_features);
+    for (int64_t i = 0; i < n_samples; ++i)
+        w.add_row(X + (size_t)i * n_features);
+    w.begin_labels();
+    w.add_labels(Y, (size_t)n_samples);
+    w.finish();
+}
+
+static int64_t file_size(std::FILE* f, const char* path)
+{
+    if (lr_fseek(f, 0, SEEK_END) != 0)
+        throw file_error("cannot seek", path);
+    const int64_t size = lr_ftell(f);
+    if (size < 0 || lr_fseek(f, 0, SEEK_SET) != 0)
+        throw file_error("cannot seek", path);
+    return size;
+}
+
+int64_t convert_raw_dataset(const char* x_path, const char* y_path,
+                            int n_features, const char* out_path)
+{
+    if (n_features <= 0)
+        throw std::runtime_error("n_features must be positive");
+
+    FilePtr xf(std::fopen(x_path, "rb"));
+    if (!xf) throw file_error("cannot open", x_path);
+    FilePtr yf(std::fopen(y_path, "rb"));
+    if (!yf) throw file_error("cannot open", y_path);
+
+    const int64_t row_bytes = (int64_t)n_features * sizeof(float);
+    const int64_t x_bytes   = file_size(xf.get(), x_path);
+    const int64_t n         = x_bytes / row_bytes;
+    if (x_bytes % row_bytes != 0)
+        throw file_error("size is not a multiple of n_features floats", x_path);
+    if (file_size(yf.get(), y_path) != n * (int64_t)sizeof(int))
+        throw file_error("label count does not match the rows of X", y_path);
+
+    // Rows are read in ~1 MB chunks and re-emitted one at a time.
+    const int64_t      chunk = std::max<int64_t>(1, (1 << 20) / row_bytes);
+    std::vector<float> xbuf((size_t)(chunk * n_features));
+    std::vector<int>   ybuf(1 << 18);
+
+    DatasetWriter w(out_path, n, n_features);
+    for (int64_t i = 0; i < n; i += chunk) {
+        const size_t k = (size_t)std::min(chunk, n - i);
+        if (std::fread(xbuf.data(), row_bytes, k, xf.get()) != k)
+            throw file_error("read failed", x_path);
+        for (size_t r = 0; r < k; ++r)
+            w.add_row(xbuf.data() + r * n_features);
+    }
+    w.begin_labels();
+    for (int64_t i = 0; i < n; i += (int64_t)ybuf.size()) {
+        const size_t k = (size_t)std::min<int64_t>((int64_t)ybuf.size(), n - i);
+        if (std::fread(ybuf.data(), sizeof(int), k, yf.get()) != k)
+            throw file_error("read failed", y_path);
+        w.add_labels(ybuf.data(), k);
+    }
+    w.finish();
+    return n;
+}
+
+// -------------------------------------------------------------------
+//  Mapping
+// -------------------------------------------------------------------
+
+MappedDataset::MappedDataset(const char* path, DatasetAdvice advice)
+    : base(nullptr), length(0)
+{
+#if defined(_WIN32)
+    file    = INVALID_HANDLE_VALUE;
+    mapping = nullptr;
+
+    HANDLE fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fh == INVALID_HANDLE_VALUE)
+        throw file_error("cannot open data set", path);
+    file = fh;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fh, &size) || size.QuadPart < (LONGLONG)sizeof(DatasetHeader)) {
+        CloseHandle(fh);
+        throw file_error("not a data set (too short)", path);
+    }
+    length = (size_t)size.QuadPart;
+
+    mapping = CreateFileMappingA(fh, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    base    = mapping ? MapViewOfFile((HANDLE)mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!base) {
+        if (mapping) CloseHandle((HANDLE)mapping);
+        CloseHandle(fh);
+        throw file_error("cannot map data set", path);
+    }
+#else
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        throw file_error("cannot open data set", path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(DatasetHeader)) {
+        ::close(fd);
+        throw file_error("not a data set (too short)", path);
+    }
+    length = (size_t)st.st_size;
+
+    // The mapping keeps its own reference to the file.
+    base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        throw file_error("cannot map data set", path);
+    }
+#endif
+
+    DatasetHeader h;
+    std::memcpy(&h, base, sizeof(h));
+
+    const char* bad = nullptr;
+    if (std::memcmp(h.magic, LOGREG_DATASET_MAGIC, sizeof(h.magic)) != 0)
+        bad = "not a data set (bad magic)";
+    else if (h.version != LOGREG_DATASET_VERSION)
+        bad = "unsupported data set version";
+    else if (h.dtype != DATASET_F32)
+        bad = "unsupported data set dtype";
+    else if (h.n_features == 0 || h.n_features > INT_MAX - 7
+             || h.padded_features != (uint32_t)pad8((int)h.n_features))
+        bad = "corrupt data set header (features)";
+    else if (h.n_samples > INT_MAX)
+        bad = "data set has more than INT_MAX rows";
+    else if (h.x_offset % LOGREG_DATASET_ALIGN || h.y_offset % LOGREG_DATASET_ALIGN
+             || h.x_offset < sizeof(h)
+             || h.y_offset < h.x_offset + h.n_samples * h.padded_features * sizeof(float)
+             || h.file_size != h.y_offset + h.n_samples * sizeof(int))
+        bad = "corrupt data set header (offsets)";
+    else if (h.file_size > length)
+        bad = "truncated data set";
+
+    if (bad) {
+        unmap();
+        throw file_error(bad, path);
+    }
+
+    const char* p = static_cast<const char*>(base);
+    x        = reinterpret_cast<const float*>(p + h.x_offset);
+    y        = reinterpret_cast<const int*>(p + h.y_offset);
+    rows     = (int)h.n_samples;
+    features = (int)h.n_features;
+    padded   = (int)h.padded_features;
+
+    advise(advice);
+}
+
+MappedDataset::~MappedDataset()
+{
+    unmap();
+}
+
+void MappedDataset::unmap()
+{
+#if defined(_WIN32)
+    if (base) UnmapViewOfFile(base);
+    if (mapping) CloseHandle((HANDLE)mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle((HANDLE)file);
+    mapping = nullptr;
+    file    = INVALID_HANDLE_VALUE;
+#else
+    if (base) ::munmap(base, length);
+#endif
+    base = nullptr;
+}
+
+void MappedDataset::advise(DatasetAdvice advice)
+{
+#if defined(_WIN32)
+    (void)advice;
+#else
+    int a = MADV_NORMAL;
+    switch (advice) {
+        case ADVISE_NORMAL:     a = MADV_NORMAL;     break;
+        case ADVISE_SEQUENTIAL: a = MADV_SEQUENTIAL; break;
+        case ADVISE_RANDOM:     a = MADV_RANDOM;     break;
+        case ADVISE_WILLNEED:   a = MADV_WILLNEED;   break;
+    }
+    // Only a hint: failure changes performance, never results.
+    (void)::madvise(base, length, a);
+#endif
+}
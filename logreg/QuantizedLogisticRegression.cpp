@@ -0,0 +1,248 @@
+#include "include/QuantizedLogisticRegression.hpp"
+#include "include/LogisticRegression.hpp"
+#include "include/ThreadPool.hpp"
+#include "include/logreg_dispatcher.hpp"
+#include "include/simd_fn.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+static inline int pad16(int n) { return (n + 15) & ~15; }
+static inline int pad64(int n) { return (n + 63) & ~63; }
+
+// -------------------------------------------------------------------
+//  Construction: calibration and weight quantization
+// -------------------------------------------------------------------
+
+QuantizedLogisticRegression::QuantizedLogisticRegression(
+    const LogisticRegression& model, const float* X_cal, int n_cal)
+    : QuantizedLogisticRegression(model, X_cal, model.get_n_features(), n_cal)
+{
+}
+
+QuantizedLogisticRegression::QuantizedLogisticRegression(
+    const LogisticRegression& model, const float* X_cal, int ld, int n_cal,
+    int n_threads)
+    : n_features(model.get_n_features()),
+      scale(nullptr),
+      inv_scale(nullptr),
+      zero_point(nullptr),
+      wq(nullptr),
+      weight_scale(1.0f),
+      offset(0.0f),
+      fast_sigmoid(model.get_sigmoid_accuracy() == SIGMOID_FAST),
+      own_pool(new ThreadPool(n_threads))
+{
+    if (n_cal < 1 || ld < n_features)
+        throw std::runtime_error("quantization needs >= 1 calibration row and ld >= n_features");
+
+    pool = own_pool.get();
+    const int nf = n_features;
+    scale      = aligned_alloc_float(pad16(nf), 64);
+    inv_scale  = aligned_alloc_float(pad16(nf), 64);
+    zero_point = aligned_alloc_float(pad16(nf), 64);
+    wq         = reinterpret_cast<int8_t*>(aligned_alloc_float(pad64(nf) / 4, 64));
+    std::memset(scale, 0, pad16(nf) * sizeof(float));
+    std::memset(inv_scale, 0, pad16(nf) * sizeof(float));
+    std::memset(zero_point, 0, pad16(nf) * sizeof(float));
+    std::memset(wq, 0, pad64(nf));
+
+    // Each column's [min, max] over the sample maps onto codes 0 .. 127.
+    for (int j = 0; j < nf; ++j) {
+        float lo = X_cal[j], hi = X_cal[j];
+        for (int i = 1; i < n_cal; ++i) {
+            const float v = X_cal[(size_t)i * ld + j];
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+        }
+        const float s = (hi - lo) / 127.0f;
+        scale[j]      = s > 0.0f && std::isfinite(s) ? s : 1.0f;
+        inv_scale[j]  = 1.0f / scale[j];
+        zero_point[j] = std::isfinite(lo) ? lo : 0.0f;
+    }
+
+    // logit = Σ w_j (zero_point_j + scale_j q_j) + b: the scales go
+    // into the int8 weights, the zero points into the offset.
+    const float* w = model.get_weights();
+    float  amax = 0.0f;
+    double off  = model.get_bias();
+    for (int j = 0; j < nf; ++j) {
+        amax = std::max(amax, std::fabs(w[j] * scale[j]));
+        off += (double)w[j] * zero_point[j];
+    }
+    weight_scale = amax > 0.0f ? amax / 127.0f : 1.0f;
+    offset       = (float)off;
+    for (int j = 0; j < nf; ++j)
+        wq[j] = (int8_t)std::lrint(w[j] * scale[j] / weight_scale);
+}
+
+QuantizedLogisticRegression::~QuantizedLogisticRegression()
+{
+    aligned_free_float(scale);
+    aligned_free_float(inv_scale);
+    aligned_free_float(zero_point);
+    aligned_free_float(wq);
+}
+
+void QuantizedLogisticRegression::set_thread_pool(ThreadPool* p)
+{
+    pool = p ? p : own_pool.get();
+}
+
+int QuantizedLogisticRegression::get_n_threads() const
+{
+    return pool->size();
+}
+
+// ~128 KB of rows per block, as for the float model.
+int QuantizedLogisticRegression::block_rows(int row_bytes) const
+{
+    return std::max(8, ((128 * 1024) / std::max(1, row_bytes)) & ~7);
+}
+
+// -------------------------------------------------------------------
+//  Quantization of input rows (quantize_u7, simd_fn.hpp)
+// -------------------------------------------------------------------
+
+void QuantizedLogisticRegression::quantize(const float* X, int ld,
+                                           int n_samples, uint8_t* out) const
+{
+    quantize(X, ld, n_samples, out, n_features);
+}
+
+void QuantizedLogisticRegression::quantize(const float* X, int ld,
+                                           int n_samples, uint8_t* out,
+                                           int ldq) const
+{
+    const int bs = block_rows(n_features * (int)sizeof(float));
+    const int nb = (n_samples + bs - 1) / bs;
+
+    pool->parallel_for(nb, [&](int b, int) {
+        const int begin = b * bs;
+        const int end   = std::min(n_samples, begin + bs);
+        quantize_u7(X + (size_t)begin * ld, end - begin, ld, zero_point,
+                    inv_scale, n_features, out + (size_t)begin * ldq, ldq);
+    });
+}
+
+// -------------------------------------------------------------------
+//  Scoring
+//  gemv_u8s8 gives the dequantized logits of a block; the sigmoid
+//  tier of the source model turns them into probabilities in place.
+// -------------------------------------------------------------------
+
+void QuantizedLogisticRegression::score(const uint8_t* Xq, int ldq,
+                                        float* logits, int n) const
+{
+    gemv_u8s8(Xq, n, ldq, wq, n_features, weight_scale, offset, logits);
+}
+
+void QuantizedLogisticRegression::activate(float* z, int n) const
+{
+    (fast_sigmoid ? sigmoid_fast : sigmoid)(z, z, n);
+}
+
+void QuantizedLogisticRegression::predict_batch(const uint8_t* Xq, int ldq,
+                                                float* out,
+                                                int n_samples) const
+{
+    const int bs = block_rows(ldq);
+    const int nb = (n_samples + bs - 1) / bs;
+
+    pool->parallel_for(nb, [&](int b, int) {
+        const int begin = b * bs;
+        const int n     = std::min(n_samples, begin + bs) - begin;
+        score(Xq + (size_t)begin * ldq, ldq, out + begin, n);
+        activate(out + begin, n);
+    });
+}
+
+void QuantizedLogisticRegression::predict_class_batch(const uint8_t* Xq,
+                                                      int ldq, int* out,
+                                                      int n_samples) const
+{
+    Workspace ws;
+    predict_class_batch(Xq, ldq, out, n_samples, ws);
+}
+
+void QuantizedLogisticRegression::predict_class_batch(const uint8_t* Xq,
+                                                      int ldq, int* out,
+                                                      int n_samples,
+                                                      Workspace& ws) const
+{
+    const int bs = block_rows(ldq);
+    const int nb = (n_samples + bs - 1) / bs;
+    float*    z  = ws.z_buffer((size_t)pool->size() * bs);
+
+    pool->parallel_for(nb, [&](int b, int t) {
+        const int begin = b * bs;
+        const int n     = std::min(n_samples, begin + bs) - begin;
+        float*    zt    = z + (size_t)t * bs;
+        score(Xq + (size_t)begin * ldq, ldq, zt, n);
+        for (int i = 0; i < n; ++i)
+            out[begin + i] = zt[i] >= 0.0f ? 1 : 0;
+    });
+}
+
+// Float rows: each thread quantizes its block into its own slot of
+// ws (block_rows × n_features bytes, still in L2 when it is scored).
+
+void QuantizedLogisticRegression::predict_batch(const float* X, int ld,
+                                                float* out,
+                                                int n_samples) const
+{
+    Workspace ws;
+    predict_batch(X, ld, out, n_samples, ws);
+}
+
+void QuantizedLogisticRegression::predict_batch(const float* X, int ld,
+                                                float* out, int n_samples,
+                                                Workspace& ws) const
+{
+    const int nf = n_features;
+    const int bs = block_rows(nf * (int)sizeof(float));
+    const int nb = (n_samples + bs - 1) / bs;
+    uint8_t*  xq = ws.xq_buffer((size_t)pool->size() * bs * nf);
+
+    pool->parallel_for(nb, [&](int b, int t) {
+        const int begin = b * bs;
+        const int n     = std::min(n_samples, begin + bs) - begin;
+        uint8_t*  qt    = xq + (size_t)t * bs * nf;
+        quantize_u7(X + (size_t)begin * ld, n, ld, zero_point, inv_scale,
+                    nf, qt, nf);
+        score(qt, nf, out + begin, n);
+        activate(out + begin, n);
+    });
+}
+
+void QuantizedLogisticRegression::predict_class_batch(const float* X, int ld,
+                                                      int* out,
+                                                      int n_samples) const
+{
+    Workspace ws;
+    predict_class_batch(X, ld, out, n_samples, ws);
+}
+
+void QuantizedLogisticRegression::predict_class_batch(const float* X, int ld,
+                                                      int* out, int n_samples,
+                                                      Workspace& ws) const
+{
+    const int nf = n_features;
+    const int bs = block_rows(nf * (int)sizeof(float));
+    const int nb = (n_samples + bs - 1) / bs;
+    uint8_t*  xq = ws.xq_buffer((size_t)pool->size() * bs * nf);
+    float*    z  = ws.z_buffer((size_t)pool->size() * bs);
+
+    pool->parallel_for(nb, [&](int b, int t) {
+        const int begin = b * bs;
+        const int n     = std::min(n_samples, begin + bs) - begin;
+        uint8_t*  qt    = xq + (size_t)t * bs * nf;
+        float*    zt    = z + (size_t)t * bs;
+        quantize_u7(X + (size_t)begin * ld, n, ld, zero_point, inv_scale,
+                    nf, qt, nf);
+        score(qt, nf, zt, n);
+        for (int i = 0; i < n; ++i)
+            out[begin + i] = zt[i] >= 0.0f ? 1 : 0;
+    });
+}
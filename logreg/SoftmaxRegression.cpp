@@ -0,0 +1,181 @@
+#include "include/SoftmaxRegression.hpp"
+#include "include/ThreadPool.hpp"
+#include "include/logreg_dispatcher.hpp"
+#include "include/model_loops.hpp"
+#include "include/simd_fn.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+static inline int pad8(int n) { return (n + 7) & ~7; }
+static inline int pad16(int n) { return (n + 15) & ~15; }
+
+// -------------------------------------------------------------------
+//  Construction / destruction
+// -------------------------------------------------------------------
+
+SoftmaxRegression::SoftmaxRegression(int n_features, int n_classes, float lr,
+                                     int epochs, int n_threads)
+    : n_features(n_features),
+      padded_features(pad8(n_features)),
+      n_classes(n_classes),
+      lr(lr),
+      epochs(epochs),
+      exp_accuracy(SIGMOID_ACCURATE),
+      own_pool(new ThreadPool(n_threads))
+{
+    if (n_features <= 0 || n_classes < 2)
+        throw std::runtime_error("SoftmaxRegression needs n_features >= 1 and n_classes >= 2");
+
+    pool = own_pool.get();
+    const size_t nw = (size_t)n_classes * padded_features;
+    weights = aligned_alloc_float(nw, 64);
+    bias    = aligned_alloc_float(pad16(n_classes), 64);
+    std::memset(weights, 0, nw * sizeof(float));
+    std::memset(bias, 0, pad16(n_classes) * sizeof(float));
+}
+
+SoftmaxRegression::~SoftmaxRegression()
+{
+    aligned_free_float(weights);
+    aligned_free_float(bias);
+}
+
+void SoftmaxRegression::set_thread_pool(ThreadPool* p)
+{
+    pool = p ? p : own_pool.get();
+}
+
+int SoftmaxRegression::get_n_threads() const
+{
+    return pool->size();
+}
+
+void SoftmaxRegression::set_exp_accuracy(SigmoidAccuracy accuracy)
+{
+    exp_accuracy = accuracy;
+}
+
+// A block's rows of X plus their K logits fill ~128 KB, so the
+// gradient pass re-reads them from L2.
+int SoftmaxRegression::block_rows() const
+{
+    const int per_row = (padded_features + n_classes) * (int)sizeof(float);
+    return std::max(8, ((128 * 1024) / per_row) & ~7);
+}
+
+// -------------------------------------------------------------------
+//  Training
+//  Per-thread scratch from the Workspace: K × block_rows logits and
+//  a gradient slot of K × padded_features weights plus K biases,
+//  padded to whole cache lines.
+// -------------------------------------------------------------------
+
+void SoftmaxRegression::train(const float* X, const int* Y, int n_samples)
+{
+    train(X, n_features, Y, n_samples, workspace);
+}
+
+void SoftmaxRegression::train(const float* X, int ld, const int* Y,
+                              int n_samples)
+{
+    train(X, ld, Y, n_samples, workspace);
+}
+
+void SoftmaxRegression::train(const float* X, int ld, const int* Y,
+                              int n_samples, Workspace& ws)
+{
+    for (int i = 0; i < n_samples; ++i)
+        if (Y[i] < 0 || Y[i] >= n_classes)
+            throw std::runtime_error("label outside [0, n_classes)");
+
+    const int nt   = pool->size();
+    const int bs   = block_rows();
+    const int acc  = pad16(n_classes * padded_features);
+    const int slot = acc + pad16(n_classes);
+
+    SoftmaxTrainJob job;
+    job.X               = X;
+    job.Y               = Y;
+    job.n_samples       = n_samples;
+    job.ld              = ld;
+    job.cols            = n_features;
+    job.n_classes       = n_classes;
+    job.block_rows      = bs;
+    job.logits          = ws.z_buffer((size_t)nt * n_classes * bs);
+    job.grad            = ws.grad_buffer((size_t)nt * slot);
+    job.slot            = slot;
+    job.acc             = acc;
+    job.weights         = weights;
+    job.ldw             = padded_features;
+    job.bias            = bias;
+    job.lr              = lr;
+    job.epochs          = epochs;
+    job.fast_exp        = exp_accuracy == SIGMOID_FAST;
+    softmax_train_loop(job, *pool);
+}
+
+// -------------------------------------------------------------------
+//  Prediction
+// -------------------------------------------------------------------
+
+void SoftmaxRegression::score(const float* X, int ld, int n_samples,
+                              float* probs, int* labels, Workspace& ws) const
+{
+    const int bs = block_rows();
+
+    SoftmaxScoreJob job;
+    job.X               = X;
+    job.n_samples       = n_samples;
+    job.ld              = ld;
+    job.cols            = n_features;
+    job.n_classes       = n_classes;
+    job.block_rows      = bs;
+    job.logits          = ws.z_buffer((size_t)pool->size() * n_classes * bs);
+    job.weights         = weights;
+    job.ldw             = padded_features;
+    job.bias            = bias;
+    job.fast_exp        = exp_accuracy == SIGMOID_FAST;
+    job.probs           = probs;
+    job.labels          = labels;
+    softmax_predict_loop(job, *pool);
+}
+
+void SoftmaxRegression::predict_proba(const float* X, float* out,
+                                      int n_samples) const
+{
+    predict_proba(X, n_features, out, n_samples);
+}
+
+void SoftmaxRegression::predict_proba(const float* X, int ld, float* out,
+                                      int n_samples) const
+{
+    Workspace ws;
+    predict_proba(X, ld, out, n_samples, ws);
+}
+
+void SoftmaxRegression::predict_proba(const float* X, int ld, float* out,
+                                      int n_samples, Workspace& ws) const
+{
+    score(X, ld, n_samples, out, nullptr, ws);
+}
+
+void SoftmaxRegression::predict_class_batch(const float* X, int* out,
+                                            int n_samples) const
+{
+    predict_class_batch(X, n_features, out, n_samples);
+}
+
+void SoftmaxRegression::predict_class_batch(const float* X, int ld, int* out,
+                                            int n_samples) const
+{
+    Workspace ws;
+    predict_class_batch(X, ld, out, n_samples, ws);
+}
+
+void SoftmaxRegression::predict_class_batch(const float* X, int ld, int* out,
+                                            int n_samples,
+                                            Workspace& ws) const
+{
+    score(X, ld, n_samples, nullptr, out, ws);
+}
@@ -0,0 +1,103 @@
+#include "include/ThreadPool.hpp"
+
+// -------------------------------------------------------------------
+//  Construction / destruction
+// -------------------------------------------------------------------
+
+ThreadPool::ThreadPool(int n_threads)
+    : n_threads(n_threads),
+      generation(0),
+      pending(0),
+      stopping(false),
+      job_fn(nullptr),
+      job_ctx(nullptr),
+      job_tasks(0)
+{
+    if (this->n_threads <= 0)
+        this->n_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (this->n_threads <= 0)
+        this->n_threads = 1;
+
+    // Thread 0 is the caller of parallel_for, so only n-1 workers.
+    workers.reserve(this->n_threads - 1);
+    for (int t = 1; t < this->n_threads; ++t)
+        workers.emplace_back(&ThreadPool::worker_loop, this, t);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv_start.notify_all();
+    for (std::thread& w : workers)
+        w.join();
+}
+
+// -------------------------------------------------------------------
+//  Static partitioning: thread t handles tasks [begin, end).
+// -------------------------------------------------------------------
+
+void ThreadPool::run_chunk(int thread)
+{
+    const int per   = job_tasks / n_threads;
+    const int extra = job_tasks % n_threads;
+    const int begin = thread * per + (thread < extra ? thread : extra);
+    const int end   = begin + per + (thread < extra ? 1 : 0);
+
+    for (int task = begin; task < end; ++task)
+        job_fn(job_ctx, task, thread);
+}
+
+void ThreadPool::worker_loop(int thread)
+{
+    uint64_t seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv_start.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        run_chunk(thread);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (--pending == 0)
+                cv_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(int n_tasks, TaskFn fn, void* ctx)
+{
+    if (n_tasks <= 0)
+        return;
+
+    // Nothing to hand out: run inline without touching the workers.
+    if (n_threads == 1 || n_tasks == 1) {
+        for (int task = 0; task < n_tasks; ++task)
+            fn(ctx, task, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(run_mtx);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        job_fn    = fn;
+        job_ctx   = ctx;
+        job_tasks = n_tasks;
+        pending   = n_threads - 1;
+        ++generation;
+    }
+    cv_start.notify_all();
+
+    run_chunk(0);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [&] { return pending == 0; });
+}
@@ -0,0 +1,52 @@
+#include "include/Workspace.hpp"
+#include "include/simd_fn.hpp"
+
+// Same cache-line padding as the gradient slots in LogisticRegression.
+static inline size_t pad16(size_t n) { return (n + 15) & ~(size_t)15; }
+
+Workspace::Workspace() {}
+
+Workspace::~Workspace()
+{
+    release();
+}
+
+float* Workspace::Buffer::get(size_t n)
+{
+    if (n > capacity) {
+        aligned_free_float(ptr);
+        ptr      = aligned_alloc_float(n, 64);
+        capacity = ptr ? n : 0;
+    }
+    return ptr;
+}
+
+void Workspace::Buffer::release()
+{
+    aligned_free_float(ptr);
+    ptr      = nullptr;
+    capacity = 0;
+}
+
+void Workspace::reserve(int n_samples, int padded_features, int n_threads)
+{
+    x.get((size_t)n_samples * padded_features);
+    z.get((size_t)n_samples);
+    grad.get((size_t)n_threads * (pad16(padded_features) + 16));
+}
+
+size_t Workspace::bytes() const
+{
+    return (x.capacity + z.capacity + grad.capacity
+            + batch.capacity + labels.capacity + solver.capacity) * sizeof(float);
+}
+
+void Workspace::release()
+{
+    x.release();
+    z.release();
+    grad.release();
+    batch.release();
+    labels.release();
+    solver.release();
+}
@@ -0,0 +1,94 @@
+#include "include/simd_fn.hpp"
+#include "include/isa_kernels.hpp"
+
+// BLAS-1 kernels used by the gradient reduction and the parameter
+// updates.  No pointer needs any particular alignment; the last
+// partial vector is one masked (SSE: zero-filled) step, so nothing
+// past x + n or y + n is touched.  Bodies in isa_kernels.hpp.
+
+// ---- axpy ----
+
+void	axpy_scalar(float a, const float* x, float* y, uint64_t n)
+{
+	Kernels<IsaScalar>::axpy(a, x, y, n);
+}
+
+void	axpy_sse(float a, const float* x, float* y, uint64_t n)
+{
+	Kernels<IsaSse>::axpy(a, x, y, n);
+}
+
+void	axpy_avx(float a, const float* x, float* y, uint64_t n)
+{
+	Kernels<IsaAvx>::axpy(a, x, y, n);
+}
+
+void	axpy_avx2_fma(float a, const float* x, float* y, uint64_t n)
+{
+	Kernels<IsaAvx2Fma>::axpy(a, x, y, n);
+}
+
+#if LOGREG_HAVE_AVX512
+void	axpy_avx512(float a, const float* x, float* y, uint64_t n)
+{
+	Kernels<IsaAvx512>::axpy(a, x, y, n);
+}
+#endif
+
+// ---- scal ----
+
+void	scal_scalar(float a, float* x, uint64_t n)
+{
+	Kernels<IsaScalar>::scal(a, x, n);
+}
+
+void	scal_sse(float a, float* x, uint64_t n)
+{
+	Kernels<IsaSse>::scal(a, x, n);
+}
+
+void	scal_avx(float a, float* x, uint64_t n)
+{
+	Kernels<IsaAvx>::scal(a, x, n);
+}
+
+void	scal_avx2_fma(float a, float* x, uint64_t n)
+{
+	Kernels<IsaAvx2Fma>::scal(a, x, n);
+}
+
+#if LOGREG_HAVE_AVX512
+void	scal_avx512(float a, float* x, uint64_t n)
+{
+	Kernels<IsaAvx512>::scal(a, x, n);
+}
+#endif
+
+// ---- axpby ----
+
+void	axpby_scalar(float a, const float* x, float b, float* y, uint64_t n)
+{
+	Kernels<IsaScalar>::axpby(a, x, b, y, n);
+}
+
+void	axpby_sse(float a, const float* x, float b, float* y, uint64_t n)
+{
+	Kernels<IsaSse>::axpby(a, x, b, y, n);
+}
+
+void	axpby_avx(float a, const float* x, float b, float* y, uint64_t n)
+{
+	Kernels<IsaAvx>::axpby(a, x, b, y, n);
+}
+
+void	axpby_avx2_fma(float a, const float* x, float b, float* y, uint64_t n)
+{
+	Kernels<IsaAvx2Fma>::axpby(a, x, b, y, n);
+}
+
+#if LOGREG_HAVE_AVX512
+void	axpby_avx512(float a, const float* x, float b, float* y, uint64_t n)
+{
+	Kernels<IsaAvx512>::axpby(a, x, b, y, n);
+}
+#endif
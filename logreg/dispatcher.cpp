@@ -1,46 +1,343 @@
 #include "include/logreg_dispatcher.hpp"
+#include "include/half_float.hpp"
 #include "include/simd_fn.hpp"
+#include "include/model_loops.hpp"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 // Definition of the global kernel function pointers
 float  (*dot_product)(const float* a, const float* b, uint64_t n) = nullptr;
-float* (*sigmoid)(const float* a, uint64_t n)                     = nullptr;
+void   (*axpy)(float a, const float* x, float* y, uint64_t n)     = nullptr;
+void   (*scal)(float a, float* x, uint64_t n)                     = nullptr;
+void   (*axpby)(float a, const float* x, float b, float* y,
+                uint64_t n)                                       = nullptr;
+void   (*gemv)(const float* X, uint64_t n, uint64_t pf,
+               const float* w, float b, float* out)               = nullptr;
+void   (*sigmoid)(const float* a, float* out, uint64_t n)         = nullptr;
+float  (*fused_grad)(const float* X, const int* Y, uint64_t n,
+                     uint64_t pf, const float* w, float b, float* dw) = nullptr;
+void   (*sigmoid_fast)(const float* a, float* out, uint64_t n)    = nullptr;
+float  (*fused_grad_fast)(const float* X, const int* Y, uint64_t n,
+                          uint64_t pf, const float* w, float b, float* dw) = nullptr;
+void   (*train_loop)(const TrainJob& job, ThreadPool& pool)       = nullptr;
+double (*loss_grad_loop)(const TrainJob& job, ThreadPool& pool)   = nullptr;
+double (*hessian_loop)(const TrainJob& job, ThreadPool& pool)     = nullptr;
+double (*loss_loop)(const ScoreJob& job, const int* Y, double* sums,
+                    ThreadPool& pool)                             = nullptr;
+void   (*predict_loop)(const ScoreJob& job, ThreadPool& pool)     = nullptr;
+void   (*classify_loop)(const ScoreJob& job, ThreadPool& pool)    = nullptr;
+void   (*sparse_train_loop)(const SparseTrainJob& job,
+                            ThreadPool& pool)                     = nullptr;
+void   (*sparse_predict_loop)(const SparseScoreJob& job,
+                              ThreadPool& pool)                   = nullptr;
+void   (*hogwild_loop)(const TrainJob& job, ThreadPool& pool)     = nullptr;
+void   (*sparse_hogwild_loop)(const SparseTrainJob& job,
+                              ThreadPool& pool)                   = nullptr;
+void   (*sparse_classify_loop)(const SparseScoreJob& job,
+                               ThreadPool& pool)                  = nullptr;
+void   (*softmax_train_loop)(const SoftmaxTrainJob& job,
+                             ThreadPool& pool)                    = nullptr;
+void   (*softmax_predict_loop)(const SoftmaxScoreJob& job,
+                               ThreadPool& pool)                  = nullptr;
+void   (*half_train_loop)(const TrainJob& job, ThreadPool& pool)  = nullptr;
+void   (*half_predict_loop)(const ScoreJob& job, ThreadPool& pool) = nullptr;
+void   (*half_classify_loop)(const ScoreJob& job, ThreadPool& pool) = nullptr;
+double (*half_loss_loop)(const ScoreJob& job, const int* Y, double* sums,
+                         ThreadPool& pool)                        = nullptr;
+void   (*gemv_u8s8)(const uint8_t* Xq, uint64_t n, uint64_t ld,
+                    const int8_t* wq, uint64_t nq, float scale,
+                    float offset, float* out)                     = nullptr;
+void   (*quantize_u7)(const float* X, uint64_t n, uint64_t ld,
+                      const float* zp, const float* inv_s, uint64_t nf,
+                      uint8_t* Q, uint64_t ldq)                   = nullptr;
 
-void	init_kernels()
+static KernelIsa	g_isa = ISA_SCALAR;
+static KernelIsa	g_half_isa = ISA_SCALAR;
+static const char*	g_int8_name = "scalar";
+
+static const char*	isa_name(KernelIsa isa)
 {
-	// ---- dot product ----
-	if (has_avx2() && has_fma()) {
-		dot_product = dot_avx2_fma;
-		std::cout << "[dispatcher] dot_product : AVX2 + FMA\n";
-	}
-	else if (has_avx()) {
-		dot_product = dot_avx;
-		std::cout << "[dispatcher] dot_product : AVX\n";
-	}
-	else if (has_sse()) {
-		dot_product = dot_sse;
-		std::cout << "[dispatcher] dot_product : SSE\n";
-	}
-	else {
-		dot_product = dot_scalar;
-		std::cout << "[dispatcher] dot_product : scalar\n";
+	switch (isa) {
+	case ISA_AVX512:   return ("AVX-512");
+	case ISA_AVX2_FMA: return ("AVX2 + FMA");
+	case ISA_AVX:      return ("AVX");
+	case ISA_SSE:      return ("SSE");
+	default:           return ("scalar");
 	}
+}
+
+// Parse LOGREG_MAX_ISA; unknown values leave the tier uncapped.
+static KernelIsa	isa_cap()
+{
+	const char*	env = std::getenv("LOGREG_MAX_ISA");
+
+	if (!env)                        return (ISA_AVX512);
+	if (!std::strcmp(env, "scalar")) return (ISA_SCALAR);
+	if (!std::strcmp(env, "sse"))    return (ISA_SSE);
+	if (!std::strcmp(env, "avx"))    return (ISA_AVX);
+	if (!std::strcmp(env, "avx2"))   return (ISA_AVX2_FMA);
+	return (ISA_AVX512);
+}
 
-	// ---- sigmoid ----
-	if (has_avx2() && has_fma()) {
-		sigmoid = sigmoid_avx2_fma;
-		std::cout << "[dispatcher] sigmoid      : AVX2 + FMA\n";
+KernelIsa	detect_kernel_isa()
+{
+	KernelIsa	isa;
+
+	if (LOGREG_HAVE_AVX512 && has_avx512f())
+		isa = ISA_AVX512;
+	else if (has_avx2() && has_fma())
+		isa = ISA_AVX2_FMA;
+	else if (has_avx())
+		isa = ISA_AVX;
+	else if (has_sse())
+		isa = ISA_SSE;
+	else
+		isa = ISA_SCALAR;
+
+	const KernelIsa	cap = isa_cap();
+	return (isa < cap ? isa : cap);
+}
+
+KernelIsa	active_kernel_isa()
+{
+	return (g_isa);
+}
+
+KernelIsa	active_half_isa()
+{
+	return (g_half_isa);
+}
+
+const char*	active_int8_isa_name()
+{
+	return (g_int8_name);
+}
+
+// Tier of the 16-bit row loops.  The AVX and wider traits widen fp16
+// with vcvtph2ps, which needs F16C on top of AVX; a CPU without it
+// falls back to the SSE loops (fp16 converted in software).
+static KernelIsa	half_isa(KernelIsa isa)
+{
+	if (isa >= ISA_AVX && !has_f16c())
+		return (ISA_SSE);
+	return (isa);
+}
+
+static void	init_half_loops(KernelIsa isa)
+{
+	switch (isa) {
+#if LOGREG_HAVE_AVX512
+	case ISA_AVX512:
+		half_train_loop    = half_train_loop_avx512;
+		half_predict_loop  = half_predict_loop_avx512;
+		half_classify_loop = half_classify_loop_avx512;
+		half_loss_loop     = half_loss_loop_avx512;
+		break;
+#endif
+	case ISA_AVX2_FMA:
+		half_train_loop    = half_train_loop_avx2_fma;
+		half_predict_loop  = half_predict_loop_avx2_fma;
+		half_classify_loop = half_classify_loop_avx2_fma;
+		half_loss_loop     = half_loss_loop_avx2_fma;
+		break;
+	case ISA_AVX:
+		half_train_loop    = half_train_loop_avx;
+		half_predict_loop  = half_predict_loop_avx;
+		half_classify_loop = half_classify_loop_avx;
+		half_loss_loop     = half_loss_loop_avx;
+		break;
+	case ISA_SSE:
+		half_train_loop    = half_train_loop_sse;
+		half_predict_loop  = half_predict_loop_sse;
+		half_classify_loop = half_classify_loop_sse;
+		half_loss_loop     = half_loss_loop_sse;
+		break;
+	default:
+		half_train_loop    = half_train_loop_scalar;
+		half_predict_loop  = half_predict_loop_scalar;
+		half_classify_loop = half_classify_loop_scalar;
+		half_loss_loop     = half_loss_loop_scalar;
+		break;
 	}
-	else if (has_avx()) {
-		sigmoid = sigmoid_avx;
-		std::cout << "[dispatcher] sigmoid      : AVX\n";
+}
+
+// The int8 kernel follows the float tier: the AVX-512 ones when that
+// tier is active and the CPU has AVX-512BW (VNNI if present), the AVX2
+// one from AVX2 up, else scalar.
+static void	init_int8_kernels(KernelIsa isa)
+{
+	gemv_u8s8   = gemv_u8s8_scalar;
+	quantize_u7 = quantize_u7_scalar;
+	g_int8_name = "scalar";
+#if LOGREG_HAVE_AVX512BW
+	if (isa == ISA_AVX512 && has_avx512bw()) {
+		quantize_u7 = quantize_u7_avx512;
+# if LOGREG_HAVE_AVX512VNNI
+		if (has_avx512vnni()) {
+			gemv_u8s8   = gemv_u8s8_avx512_vnni;
+			g_int8_name = "AVX-512 VNNI";
+			return;
+		}
+# endif
+		gemv_u8s8   = gemv_u8s8_avx512;
+		g_int8_name = "AVX-512BW";
+		return;
 	}
-	else if (has_sse()) {
-		sigmoid = sigmoid_sse;
-		std::cout << "[dispatcher] sigmoid      : SSE\n";
+#endif
+	if (isa >= ISA_AVX2_FMA) {
+		gemv_u8s8   = gemv_u8s8_avx2;
+		quantize_u7 = quantize_u7_avx2;
+		g_int8_name = "AVX2";
 	}
-	else {
-		sigmoid = sigmoid_scalar;
-		std::cout << "[dispatcher] sigmoid      : scalar\n";
+}
+
+void	init_kernels()
+{
+	g_isa = detect_kernel_isa();
+
+	switch (g_isa) {
+#if LOGREG_HAVE_AVX512
+	case ISA_AVX512:
+		dot_product     = dot_avx512;
+		axpy            = axpy_avx512;
+		scal            = scal_avx512;
+		axpby           = axpby_avx512;
+		gemv            = gemv_avx512;
+		sigmoid         = sigmoid_avx512;
+		fused_grad      = fused_grad_avx512;
+		sigmoid_fast    = sigmoid_fast_avx512;
+		fused_grad_fast = fused_grad_fast_avx512;
+		train_loop      = train_loop_avx512;
+		loss_grad_loop  = loss_grad_loop_avx512;
+		hessian_loop    = hessian_loop_avx512;
+		loss_loop       = loss_loop_avx512;
+		predict_loop    = predict_loop_avx512;
+		classify_loop   = classify_loop_avx512;
+		sparse_train_loop    = sparse_train_loop_avx512;
+		hogwild_loop         = hogwild_loop_avx512;
+		sparse_hogwild_loop  = sparse_hogwild_loop_avx512;
+		sparse_predict_loop  = sparse_predict_loop_avx512;
+		sparse_classify_loop = sparse_classify_loop_avx512;
+		softmax_train_loop   = softmax_train_loop_avx512;
+		softmax_predict_loop = softmax_predict_loop_avx512;
+		break;
+#endif
+	case ISA_AVX2_FMA:
+		dot_product     = dot_avx2_fma;
+		axpy            = axpy_avx2_fma;
+		scal            = scal_avx2_fma;
+		axpby           = axpby_avx2_fma;
+		gemv            = gemv_avx2_fma;
+		sigmoid         = sigmoid_avx2_fma;
+		fused_grad      = fused_grad_avx2_fma;
+		sigmoid_fast    = sigmoid_fast_avx2_fma;
+		fused_grad_fast = fused_grad_fast_avx2_fma;
+		train_loop      = train_loop_avx2_fma;
+		loss_grad_loop  = loss_grad_loop_avx2_fma;
+		hessian_loop    = hessian_loop_avx2_fma;
+		loss_loop       = loss_loop_avx2_fma;
+		predict_loop    = predict_loop_avx2_fma;
+		classify_loop   = classify_loop_avx2_fma;
+		sparse_train_loop    = sparse_train_loop_avx2_fma;
+		hogwild_loop         = hogwild_loop_avx2_fma;
+		sparse_hogwild_loop  = sparse_hogwild_loop_avx2_fma;
+		sparse_predict_loop  = sparse_predict_loop_avx2_fma;
+		sparse_classify_loop = sparse_classify_loop_avx2_fma;
+		softmax_train_loop   = softmax_train_loop_avx2_fma;
+		softmax_predict_loop = softmax_predict_loop_avx2_fma;
+		break;
+	case ISA_AVX:
+		dot_product     = dot_avx;
+		axpy            = axpy_avx;
+		scal            = scal_avx;
+		axpby           = axpby_avx;
+		gemv            = gemv_avx;
+		sigmoid         = sigmoid_avx;
+		fused_grad      = fused_grad_avx;
+		sigmoid_fast    = sigmoid_fast_avx;
+		fused_grad_fast = fused_grad_fast_avx;
+		train_loop      = train_loop_avx;
+		loss_grad_loop  = loss_grad_loop_avx;
+		hessian_loop    = hessian_loop_avx;
+		loss_loop       = loss_loop_avx;
+		predict_loop    = predict_loop_avx;
+		classify_loop   = classify_loop_avx;
+		sparse_train_loop    = sparse_train_loop_avx;
+		hogwild_loop         = hogwild_loop_avx;
+		sparse_hogwild_loop  = sparse_hogwild_loop_avx;
+		sparse_predict_loop  = sparse_predict_loop_avx;
+		sparse_classify_loop = sparse_classify_loop_avx;
+		softmax_train_loop   = softmax_train_loop_avx;
+		softmax_predict_loop = softmax_predict_loop_avx;
+		break;
+	case ISA_SSE:
+		dot_product     = dot_sse;
+		axpy            = axpy_sse;
+		scal            = scal_sse;
+		axpby           = axpby_sse;
+		gemv            = gemv_sse;
+		sigmoid         = sigmoid_sse;
+		fused_grad      = fused_grad_sse;
+		sigmoid_fast    = sigmoid_fast_sse;
+		fused_grad_fast = fused_grad_fast_sse;
+		train_loop      = train_loop_sse;
+		loss_grad_loop  = loss_grad_loop_sse;
+		hessian_loop    = hessian_loop_sse;
+		loss_loop       = loss_loop_sse;
+		predict_loop    = predict_loop_sse;
+		classify_loop   = classify_loop_sse;
+		sparse_train_loop    = sparse_train_loop_sse;
+		hogwild_loop         = hogwild_loop_sse;
+		sparse_hogwild_loop  = sparse_hogwild_loop_sse;
+		sparse_predict_loop  = sparse_predict_loop_sse;
+		sparse_classify_loop = sparse_classify_loop_sse;
+		softmax_train_loop   = softmax_train_loop_sse;
+		softmax_predict_loop = softmax_predict_loop_sse;
+		break;
+	default:
+		dot_product     = dot_scalar;
+		axpy            = axpy_scalar;
+		scal            = scal_scalar;
+		axpby           = axpby_scalar;
+		gemv            = gemv_scalar;
+		sigmoid         = sigmoid_scalar;
+		fused_grad      = fused_grad_scalar;
+		sigmoid_fast    = sigmoid_fast_scalar;
+		fused_grad_fast = fused_grad_fast_scalar;
+		train_loop      = train_loop_scalar;
+		loss_grad_loop  = loss_grad_loop_scalar;
+		hessian_loop    = hessian_loop_scalar;
+		loss_loop       = loss_loop_scalar;
+		predict_loop    = predict_loop_scalar;
+		classify_loop   = classify_loop_scalar;
+		sparse_train_loop    = sparse_train_loop_scalar;
+		hogwild_loop         = hogwild_loop_scalar;
+		sparse_hogwild_loop  = sparse_hogwild_loop_scalar;
+		sparse_predict_loop  = sparse_predict_loop_scalar;
+		sparse_classify_loop = sparse_classify_loop_scalar;
+		softmax_train_loop   = softmax_train_loop_scalar;
+		softmax_predict_loop = softmax_predict_loop_scalar;
+		break;
 	}
-}
\ No newline at end of file
+
+	g_half_isa = half_isa(g_isa);
+	init_half_loops(g_half_isa);
+	init_int8_kernels(g_isa);
+
+	const char*	name = isa_name(g_isa);
+	std::cout << "[dispatcher] dot_product : " << name << "\n";
+	std::cout << "[dispatcher] blas1        : " << name << "\n";
+	std::cout << "[dispatcher] gemv         : " << name << "\n";
+	std::cout << "[dispatcher] sigmoid      : " << name << "\n";
+	std::cout << "[dispatcher] fused_grad   : " << name << "\n";
+	std::cout << "[dispatcher] sigmoid_fast : " << name << "\n";
+	std::cout << "[dispatcher] model loops  : " << name << "\n";
+	std::cout << "[dispatcher] sparse loops : " << name << "\n";
+	std::cout << "[dispatcher] softmax loops: " << name << "\n";
+	const bool	f16c = g_half_isa == ISA_AVX512
+	                   || (g_half_isa >= ISA_AVX && LOGREG_HAVE_F16C);
+	std::cout << "[dispatcher] 16-bit rows  : " << isa_name(g_half_isa)
+	          << (f16c ? " (F16C)" : " (fp16 in software)") << "\n";
+	std::cout << "[dispatcher] int8 gemv    : " << g_int8_name << "\n";
+}
@@ -1,4 +1,5 @@
 #include "include/simd_fn.hpp"
+#include "include/isa_kernels.hpp"
 
 float dot_scalar(const float* a, const float* b, uint64_t n) {
 	uint64_t	i{0};
@@ -11,88 +12,67 @@ float dot_scalar(const float* a, const float* b, uint64_t n) {
 	return (dot);
 }
 
-float dot_sse(const float* a, const float* b, uint64_t n) {
-	alignas(16) float		temp[4];
-	__m128					acc;
-	uint64_t				i{0};
-	__m128					va;
-	__m128					vb;
-	float					sum{0};
-
-	acc = _mm_setzero_ps();
-	while (i + 4 < n) {;
-		va = _mm_load_ps(a + i);
-		vb = _mm_load_ps(b + i);
-		acc = _mm_add_ps(acc, _mm_mul_ps(va, vb));
-		i += 4;
-	}
-
-	// store in an aligned temp
-	_mm_store_ps(temp, acc);
-	sum += temp[0] + temp[1] + temp[2] + temp[3];
-
-	while (i < n) {
-		sum += a[i] * b[i];
-		i++;
-	}
-
-	return (sum);
+// ============================================================
+//  dot : <a, b> over n floats
+//
+//  dot_acc (simd_math.hpp) with each tier's default accumulator
+//  count T::ACC.  a and b may have any alignment; the tail is one
+//  masked (SSE: zero-filled) vector step, so no element is dropped
+//  or read past the end.
+// ============================================================
+
+float	dot_sse(const float* a, const float* b, uint64_t n) {
+	return (dot_acc<IsaSse, IsaSse::ACC>(a, b, n));
 }
 
-float dot_avx(const float* a, const float* b, uint64_t n) {
-	alignas(32) float		temp[8];
-	__m256					acc;
-	uint64_t				i{0};
-	__m256					va;
-	__m256					vb;
-	float					sum{0};
-
-	acc = _mm256_setzero_ps();
-	while (i + 8 <= n) {;
-		va = _mm256_load_ps(a + i);
-		vb = _mm256_load_ps(b + i);
-		acc = _mm256_add_ps(acc, _mm256_mul_ps(va, vb));
-		i += 8;
-	}
-
-	// store in an aligned temp
-	_mm256_store_ps(temp, acc);
-	sum += temp[0] + temp[1] + temp[2] + temp[3] 
-			+ temp[4] + temp[5] + temp[6] + temp[7];
-
-	while (i < n) {
-		sum += a[i] * b[i];
-		i++;
-	}
+float	dot_avx(const float* a, const float* b, uint64_t n) {
+	return (dot_acc<IsaAvx, IsaAvx::ACC>(a, b, n));
+}
 
-	return (sum);
+float	dot_avx2_fma(const float* a, const float* b, uint64_t n) {
+	return (dot_acc<IsaAvx2Fma, IsaAvx2Fma::ACC>(a, b, n));
 }
 
-float dot_avx2_fma(const float* a, const float* b, uint64_t n) {
-	alignas(32) float		temp[8];
-	__m256					acc;
-	uint64_t				i{0};
-	__m256					va;
-	__m256					vb;
-	float					sum{0};
+#if LOGREG_HAVE_AVX512
+float	dot_avx512(const float* a, const float* b, uint64_t n) {
+	return (dot_acc<IsaAvx512, IsaAvx512::ACC>(a, b, n));
+}
+#endif
+
+// ============================================================
+//  gemv : out[i] = <X_i, w> + b over n padded rows (stride pf)
+//
+//  Rows are processed 4 at a time by the register-blocked
+//  dot4_rows helper: each weight vector is loaded once for the
+//  4 rows and the 4 sums come out of a single combined horizontal
+//  reduction.  X and out may have any alignment (unaligned loads,
+//  masked tail); w must be 32-byte aligned and zero-padded to a
+//  whole vector.  Bodies in isa_kernels.hpp.
+// ============================================================
+
+void	gemv_scalar(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out) {
+	Kernels<IsaScalar>::gemv(X, n, pf, pf, w, b, out);
+}
 
-	acc = _mm256_setzero_ps();
-	while (i + 8 <= n) {;
-		va = _mm256_load_ps(a + i);
-		vb = _mm256_load_ps(b + i);
-		acc = _mm256_fmadd_ps(va, vb, acc); // acc+= va * vb
-		i += 8;
-	}
+void	gemv_sse(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out) {
+	Kernels<IsaSse>::gemv(X, n, pf, pf, w, b, out);
+}
 
-	// store in an aligned temp
-	_mm256_store_ps(temp, acc);
-	sum += temp[0] + temp[1] + temp[2] + temp[3] 
-			+ temp[4] + temp[5] + temp[6] + temp[7];
+void	gemv_avx(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out) {
+	Kernels<IsaAvx>::gemv(X, n, pf, pf, w, b, out);
+}
 
-	while (i < n) {
-		sum += a[i] * b[i];
-		i++;
-	}
+void	gemv_avx2_fma(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out) {
+	Kernels<IsaAvx2Fma>::gemv(X, n, pf, pf, w, b, out);
+}
 
-	return (sum);
-}
\ No newline at end of file
+#if LOGREG_HAVE_AVX512
+void	gemv_avx512(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out) {
+	Kernels<IsaAvx512>::gemv(X, n, pf, pf, w, b, out);
+}
+#endif
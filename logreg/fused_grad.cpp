@@ -0,0 +1,90 @@
+#include "include/simd_fn.hpp"
+#include "include/isa_kernels.hpp"
+
+// Fused logistic-regression gradient kernels.
+//
+// One sweep over a block of n rows of the padded training matrix
+// X [n × pf]: for every row
+//     p_i   = sigmoid(<w, x_i> + b)
+//     err_i = p_i - y_i
+//     dw   += err_i * x_i          (axpy)
+//     db   += err_i
+// Rows are taken a vector-width at a time: the logits of the group
+// come from the 4-row register-blocked dot products in simd_math.hpp
+// and go through one vectorised sigmoid, then each row is read a second
+// time for the axpy while it is still hot in L1, so X only crosses
+// the memory bus once per epoch.
+//
+// pf is both the row stride and the floats used per row; rows may
+// have any alignment, w and dw are 32-byte aligned and zero-padded to
+// a whole vector (the model's own buffers).  dw [pf] is accumulated
+// into, not overwritten; the return value is sum(err_i), the bias
+// gradient of the block.  Lanes past the last row are fed z = 0
+// (the bias is pre-subtracted) and their error is cleared before it
+// reaches db.
+//
+// The bodies live in isa_kernels.hpp and are instantiated twice:
+// fused_grad_<isa> uses the accurate sigmoid, fused_grad_fast_<isa>
+// the fast tier.
+
+float	fused_grad_scalar(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaScalar>::fused_grad<false>(X, Y, n, pf, pf, w, b, dw));
+}
+
+float	fused_grad_fast_scalar(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaScalar>::fused_grad<true>(X, Y, n, pf, pf, w, b, dw));
+}
+
+float	fused_grad_sse(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaSse>::fused_grad<false>(X, Y, n, pf, pf, w, b, dw));
+}
+
+float	fused_grad_fast_sse(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaSse>::fused_grad<true>(X, Y, n, pf, pf, w, b, dw));
+}
+
+float	fused_grad_avx(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaAvx>::fused_grad<false>(X, Y, n, pf, pf, w, b, dw));
+}
+
+float	fused_grad_fast_avx(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaAvx>::fused_grad<true>(X, Y, n, pf, pf, w, b, dw));
+}
+
+float	fused_grad_avx2_fma(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaAvx2Fma>::fused_grad<false>(X, Y, n, pf, pf, w, b, dw));
+}
+
+float	fused_grad_fast_avx2_fma(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaAvx2Fma>::fused_grad<true>(X, Y, n, pf, pf, w, b, dw));
+}
+
+#if LOGREG_HAVE_AVX512
+float	fused_grad_avx512(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaAvx512>::fused_grad<false>(X, Y, n, pf, pf, w, b, dw));
+}
+
+float	fused_grad_fast_avx512(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw)
+{
+	return (Kernels<IsaAvx512>::fused_grad<true>(X, Y, n, pf, pf, w, b, dw));
+}
+#endif
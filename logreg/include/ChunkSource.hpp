@@ -0,0 +1,65 @@
+#ifndef CHUNK_SOURCE_H
+# define CHUNK_SOURCE_H
+
+# include <algorithm>
+# include <cstring>
+
+// ---------------------------------------------------------------
+//  ChunkSource
+//  Training data delivered a batch at a time, for data sets that do
+//  not fit in memory (LogisticRegression::train_minibatch).  The
+//  model owns the batch buffers; the source only fills them, so
+//  peak memory is set by the batch size, not the data set.
+//
+//  next() is called from a loader thread of the model, one call at
+//  a time, while the previous batch is being trained on.
+// ---------------------------------------------------------------
+class ChunkSource {
+public:
+	virtual ~ChunkSource() {}
+
+	// Start a new pass over the data; called before every epoch.
+	virtual void	rewind() = 0;
+
+	// Write up to max_rows samples: the n_features floats of row r at
+	// X + r * stride (the stride floats past n_features must be left
+	// untouched — they hold the zero padding) and its label, 0 or 1,
+	// at Y[r].  Return the number of rows written; 0 ends the pass.
+	virtual int		next(float* X, int stride, int* Y, int max_rows) = 0;
+};
+
+// ---------------------------------------------------------------
+//  ArrayChunkSource
+//  ChunkSource over in-memory row-major arrays, read in order.
+//  Mini-batch training on it keeps only the batch buffers instead of
+//  a padded copy of the whole of X.
+// ---------------------------------------------------------------
+class ArrayChunkSource : public ChunkSource {
+public:
+	ArrayChunkSource(const float* X, const int* Y, int n_samples, int n_features)
+		: X(X), Y(Y), n_samples(n_samples), n_features(n_features), pos(0) {}
+
+	void	rewind() override { pos = 0; }
+
+	int		next(float* dst, int stride, int* labels, int max_rows) override
+	{
+		const int rows = std::min(max_rows, n_samples - pos);
+
+		for (int r = 0; r < rows; ++r)
+			std::memcpy(dst + (size_t)r * stride,
+			            X + (size_t)(pos + r) * n_features,
+			            n_features * sizeof(float));
+		std::memcpy(labels, Y + pos, rows * sizeof(int));
+		pos += rows;
+		return (rows);
+	}
+
+private:
+	const float*	X;
+	const int*		Y;
+	int				n_samples;
+	int				n_features;
+	int				pos;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef CSR_MATRIX_H
+# define CSR_MATRIX_H
+
+# include <stdint.h>
+
+// ---------------------------------------------------------------
+//  CsrMatrix
+//  Non-owning view of a sparse matrix in compressed sparse row form,
+//  the layout of scipy.sparse.csr_matrix: row i holds the values
+//  values[indptr[i] .. indptr[i + 1]) at the columns indices[...].
+//  Columns within a row need not be sorted and may repeat (their
+//  values add up).
+//
+//  LogisticRegression::train / predict_batch read it in place, so
+//  time and memory scale with the number of non-zeros rather than
+//  n_rows × n_cols.  Every index must lie in [0, n_cols); this is
+//  not checked.
+// ---------------------------------------------------------------
+struct CsrMatrix {
+	const int32_t*	indptr;     // [n_rows + 1], non-decreasing
+	const int32_t*	indices;    // [nnz]
+	const float*	values;     // [nnz]
+	int				n_rows;
+	int				n_cols;
+
+	int64_t	nnz() const { return (n_rows ? indptr[n_rows] - indptr[0] : 0); }
+};
+
+#endif
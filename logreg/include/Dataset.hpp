@@ -0,0 +1,86 @@
+#ifndef DATASET_H
+# define DATASET_H
+
+# include <stdint.h>
+# include <memory>
+# include <mutex>
+# include <vector>
+# include "logreg_dispatcher.hpp"
+
+// Per-column statistics of a Dataset (population std, ddof = 0).
+struct ColumnStats {
+	std::vector<float>	mean;
+	std::vector<float>	stddev;
+	std::vector<float>	min;
+	std::vector<float>	max;
+};
+
+// ---------------------------------------------------------------
+//  Dataset
+//  Training / scoring data in the layout the kernels read: rows of
+//  padded_features floats (n_features rounded up to 8, zero past
+//  n_features), 64-byte aligned, plus int32 labels.  The copy is made
+//  once, in the constructor; LogisticRegression::train, predict_batch
+//  and predict_class_batch take a Dataset and read it in place, so
+//  sweeps and repeated scoring over the same matrix pay the O(n·f)
+//  copy only once.  MappedDataset is a Dataset whose rows live in a
+//  memory-mapped file instead.
+//
+//  With STORAGE_F16 or STORAGE_BF16 the rows are kept as 16-bit
+//  values instead (half_float.hpp): half the memory and half the
+//  bytes per epoch, at fp16 / bf16 precision.  The kernels widen
+//  them to float32 as they load them.
+//
+//  A Dataset is immutable and may be used by any number of models
+//  and threads at once.
+// ---------------------------------------------------------------
+class Dataset {
+public:
+	// Copy X [n_samples × n_features] (row-major, rows ld floats
+	// apart, ld = n_features when omitted) and Y [n_samples], X
+	// rounded to `storage`.  Y may be null for scoring-only data.
+	Dataset(const float* X, const int* Y, int n_samples, int n_features,
+	        FeatureStorage storage = STORAGE_F32);
+	Dataset(const float* X, int ld, const int* Y, int n_samples, int n_features,
+	        FeatureStorage storage = STORAGE_F32);
+	virtual ~Dataset();
+
+	Dataset(const Dataset&)            = delete;
+	Dataset& operator=(const Dataset&) = delete;
+
+	int				n_samples() const { return rows; }
+	int				n_features() const { return features; }
+	int				padded_features() const { return padded; }
+	FeatureStorage	storage() const { return format; }
+
+	// The rows, [n_samples × padded_features]: X() for STORAGE_F32,
+	// Xh() for the 16-bit formats; the other one is null.
+	const float*	X() const { return x; }
+	const uint16_t*	Xh() const { return xh; }
+	const int*		Y() const { return y; }   // [n_samples], or null
+
+	// Mean, std, min and max of every column, computed on first use
+	// (one pass over X, thread-safe) and cached.
+	const ColumnStats&	column_stats() const;
+
+protected:
+	// For subclasses that provide the rows themselves.
+	Dataset();
+
+	const float*	x;
+	const uint16_t*	xh;
+	FeatureStorage	format;
+	const int*		y;
+	int				rows;
+	int				features;
+	int				padded;
+
+private:
+	float*			own_x;      // aligned_alloc_float, or null
+	std::vector<int>	own_y;
+
+	mutable std::once_flag					stats_once;
+	mutable std::unique_ptr<ColumnStats>	stats;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef FIXED_LOG_REG_H
+# define FIXED_LOG_REG_H
+
+# include <algorithm>
+# include <cmath>
+# include <type_traits>
+# include "simd_math.hpp"
+
+// Widest vector traits the build targets whose register holds at most
+// N floats (SSE below 8): a 4-feature model is one 128-bit multiply,
+// not a masked 512-bit one.
+template <int N, class Wide, class Narrow>
+using FixedFit = typename std::conditional<(N >= (int)Wide::W), Wide, Narrow>::type;
+
+# if LOGREG_HAVE_AVX512
+template <int N>
+using FixedIsa = FixedFit<N, IsaAvx512, FixedFit<N, IsaAvx2Fma, IsaSse>>;
+# elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+template <int N>
+using FixedIsa = FixedFit<N, IsaAvx2Fma, IsaSse>;
+# elif defined(__AVX__)
+template <int N>
+using FixedIsa = FixedFit<N, IsaAvx, IsaSse>;
+# else
+template <int N>
+using FixedIsa = IsaSse;
+# endif
+
+// ---------------------------------------------------------------
+//  FixedLogisticRegression<N>
+//  LogisticRegression with the feature count fixed at compile time,
+//  for the small models (a few dozen features) where the dynamic
+//  class's padding copy, dispatch and runtime loop bounds cost more
+//  than the arithmetic.  The weights live inline in the object, every
+//  loop over features has a constant trip count and is unrolled by
+//  the compiler, and rows are read in place (stride N, any
+//  alignment) — train and predict_batch copy nothing and allocate
+//  nothing.  Single-threaded; the widest kernels the build targets
+//  are called directly, so init_kernels() is not required.
+//
+//  Same model and update rule as LogisticRegression: full-batch
+//  gradient descent, accurate-tier SIMD sigmoid for train and
+//  predict_batch, libm exp for the single-sample calls.
+// ---------------------------------------------------------------
+template <int N>
+class FixedLogisticRegression {
+	static_assert(N > 0, "FixedLogisticRegression needs at least one feature");
+
+public:
+	typedef FixedIsa<N>	Isa;
+	typedef typename Isa::vec	vec;
+
+	static constexpr int	W  = (int)Isa::W;
+	static constexpr int	PF = (N + W - 1) / W * W;   // N rounded up to whole registers
+
+	explicit FixedLogisticRegression(float lr = 0.1f, int epochs = 1000)
+		: bias(0.0f), lr(lr), epochs(epochs)
+	{
+		std::fill(weights, weights + PF, 0.0f);
+	}
+
+	// Train on a flat row-major matrix X [n_samples × N] and integer
+	// labels Y [n_samples] ∈ {0, 1}.
+	void	train(const float* X, const int* Y, int n_samples)
+	{
+		const float	step = lr / static_cast<float>(n_samples);
+
+		for (int epoch = 0; epoch < epochs; ++epoch) {
+			alignas(64) float	dw[PF] = {};
+			alignas(64) float	p[W];
+			float				db{0};
+
+			for (int i = 0; i < n_samples; i += W) {
+				const int k = std::min(W, n_samples - i);
+
+				group_probs(X, i, n_samples, p);
+				for (int r = 0; r < k; ++r) {
+					const float err = p[r] - static_cast<float>(Y[i + r]);
+					axpy(err, X + (size_t)(i + r) * N, dw);
+					db += err;
+				}
+			}
+			for (int j = 0; j < PF; ++j)
+				weights[j] -= step * dw[j];
+			bias -= step * db;
+		}
+	}
+
+	// ---- single-sample scoring: x points at N floats, any alignment ----
+
+	float	logit(const float* x) const noexcept
+	{
+		return (Isa::hsum(dot(x)) + bias);
+	}
+
+	float	predict(const float* x) const noexcept
+	{
+		return (1.0f / (1.0f + std::exp(-logit(x))));
+	}
+
+	int		predict_class(const float* x) const noexcept
+	{
+		// sigmoid(z) >= 0.5  <=>  z >= 0
+		return (logit(x) >= 0.0f ? 1 : 0);
+	}
+
+	// Batch prediction: write P(y=1|x_i) into out[0..n_samples-1].
+	void	predict_batch(const float* X, float* out, int n_samples) const
+	{
+		for (int i = 0; i < n_samples; i += W) {
+			const int k = std::min(W, n_samples - i);
+
+			if (k == W)
+				group_probs(X, i, n_samples, out + i);
+			else {
+				alignas(64) float p[W];
+				group_probs(X, i, n_samples, p);
+				std::copy(p, p + k, out + i);
+			}
+		}
+	}
+
+	// Batch classification: write 0/1 into out[0..n_samples-1].
+	void	predict_class_batch(const float* X, int* out, int n_samples) const
+	{
+		for (int i = 0; i < n_samples; ++i)
+			out[i] = predict_class(X + (size_t)i * N);
+	}
+
+	static constexpr int	get_n_features() { return N; }
+	const float*			get_weights() const { return weights; }
+	float					get_bias() const { return bias; }
+
+private:
+	alignas(64) float	weights[PF];   // zero past N
+	float				bias;
+	float				lr;
+	int					epochs;
+
+	// Per-lane partial sums of <x, w>.  Two accumulators, constant trip
+	// count: for N <= 64 this is at most a handful of unrolled FMAs,
+	// plus one masked (SSE: zero-filled) load when W does not divide N.
+	vec		dot(const float* x) const
+	{
+		vec	acc0 = Isa::zero();
+		vec	acc1 = Isa::zero();
+		int	j{0};
+
+		for (; j + 2 * W <= N; j += 2 * W) {
+			acc0 = Isa::fmadd(Isa::loadu(x + j), Isa::load(weights + j), acc0);
+			acc1 = Isa::fmadd(Isa::loadu(x + j + W), Isa::load(weights + j + W), acc1);
+		}
+		if (j + W <= N) {
+			acc0 = Isa::fmadd(Isa::loadu(x + j), Isa::load(weights + j), acc0);
+			j += W;
+		}
+		if (j < N)
+			acc1 = Isa::fmadd(Isa::load_partial(x + j, N - j), Isa::load(weights + j), acc1);
+		return (Isa::add(acc0, acc1));
+	}
+
+	// dw[0:PF] += a * x[0:N]  (dw is zero past N and stays so)
+	static void	axpy(float a, const float* x, float* dw)
+	{
+		const vec	va = Isa::set1(a);
+		int			j{0};
+
+		for (; j + W <= N; j += W)
+			Isa::store(dw + j, Isa::fmadd(va, Isa::loadu(x + j), Isa::load(dw + j)));
+		if (j < N)
+			Isa::store(dw + j, Isa::fmadd(va, Isa::load_partial(x + j, N - j),
+			                              Isa::load(dw + j)));
+	}
+
+	// Probabilities of rows i .. i+W-1 into p[0..W-1] with one
+	// vector sigmoid.  Rows past n_samples repeat the last one; callers
+	// ignore those lanes.
+	void	group_probs(const float* X, int i, int n_samples, float* p) const
+	{
+		__m128	q[W / 4];
+
+		for (int g = 0; g < W / 4; ++g) {
+			vec	d[4];
+			for (int r = 0; r < 4; ++r) {
+				const int row = std::min(i + 4 * g + r, n_samples - 1);
+				d[r] = dot(X + (size_t)row * N);
+			}
+			q[g] = Isa::hsum4(d[0], d[1], d[2], d[3]);
+		}
+		vec z = Isa::add(Isa::from4(q), Isa::set1(bias));
+		Isa::storeu(p, vect_sigmoid<Isa, false>(z));
+	}
+};
+
+#endif
@@ -2,22 +2,59 @@
 # define LOG_REG_H
 
 # include <cstdint>
+# include <functional>
+# include <memory>
+# include "Workspace.hpp"
+# include "logreg_dispatcher.hpp"
+
+class ThreadPool;
+class ChunkSource;
+class Dataset;
+struct CsrMatrix;
+
+// Progress of one gradient-descent epoch, passed to the epoch
+// callback.  Losses are mean log-losses.  A full-batch epoch reports
+// the loss and gradient at the weights it started from, i.e. the
+// forward pass the epoch already made; train_minibatch reports the
+// averages over its batches, each at the weights its step started
+// from.
+struct EpochStats {
+	int		epoch;            // 0-based
+	double	loss;             // training rows
+	double	grad_norm;        // L2 norm of the mean gradient (w and b)
+	double	val_loss;         // validation set, NaN without one
+	double	seconds;          // wall time of this epoch
+	double	elapsed;          // since the train call started
+};
+
+// Returns true to stop training after this epoch.
+typedef std::function<bool(const EpochStats&)>	EpochCallback;
 
 // ---------------------------------------------------------------
 //  LogisticRegression
-//  Binary classifier trained with full-batch gradient descent.
-//  All internal buffers are 32-byte aligned so AVX loads never
-//  split a cache line.  The dispatcher (init_kernels) must be
-//  called before constructing this object.
+//  Binary classifier trained with full-batch gradient descent, or
+//  with L-BFGS / IRLS (set_solver).
+//  Input matrices are read in place at any alignment and row stride;
+//  they are copied into a padded, 32-byte-aligned buffer only when
+//  that is cheaper over the passes a call makes (many epochs over
+//  rows with a ragged vector tail).  The dispatcher (init_kernels)
+//  must be called before constructing this object.
+//
+//  train / predict_batch / predict_class_batch split the rows into
+//  cache-sized blocks and spread them over a ThreadPool, either one
+//  owned by the model (n_threads) or one supplied by the caller.
 // ---------------------------------------------------------------
 class LogisticRegression {
 public:
 	// n_features : number of input features (excluding bias)
 	// lr         : learning rate  (default 0.1)
 	// epochs     : full passes over the training set (default 1000)
+	// n_threads  : size of the model's own thread pool (default 1,
+	//              <= 0 means one thread per hardware core)
 	LogisticRegression(int n_features,
-	                   float lr     = 0.1f,
-	                   int   epochs = 1000);
+	                   float lr        = 0.1f,
+	                   int   epochs    = 1000,
+	                   int   n_threads = 1);
 
 	~LogisticRegression();
 
@@ -25,22 +62,209 @@ public:
 	LogisticRegression& operator=(const LogisticRegression&) = delete;
 
 	// Train on a flat row-major matrix X  [n_samples × n_features]
-	// and integer labels Y [n_samples] ∈ {0, 1}.
+	// and integer labels Y [n_samples] ∈ {0, 1}.  Scratch memory comes
+	// from the model's own Workspace, or from ws when given.
 	void	train(const float* X, const int* Y, int n_samples);
+	void	train(const float* X, const int* Y, int n_samples,
+			      Workspace& ws);
+
+	// As above with the rows of X ld >= n_features floats apart, e.g.
+	// a column slice of a wider matrix.  The overloads without ld use
+	// ld = n_features.
+	void	train(const float* X, int ld, const int* Y, int n_samples);
+	void	train(const float* X, int ld, const int* Y, int n_samples,
+			      Workspace& ws);
+
+	// Mini-batch gradient descent on data streamed from src
+	// (ChunkSource.hpp): every epoch rewinds src and takes one step per
+	// batch of up to batch_size rows.  A loader thread fills the next
+	// batch while the current one trains, and only two padded batches
+	// are held at a time, so X never has to fit in memory.
+	void	train_minibatch(ChunkSource& src, int batch_size);
+	void	train_minibatch(ChunkSource& src, int batch_size,
+			                Workspace& ws);
+
+	// Online (incremental) learning: `steps` gradient steps over the
+	// n_samples rows given, starting from the current weights and the
+	// optimizer state left by the previous partial_fit or train call,
+	// so a live model can be refreshed batch by batch.  The step size
+	// follows the rows seen so far: lr / (1 + lr_decay × samples_seen)
+	// (set_lr_decay).  Rows are read in place at any alignment, and a
+	// call of a shape already seen allocates nothing.  Always takes
+	// gradient steps on float32 rows: the solver, the feature storage
+	// and the convergence monitoring do not apply.
+	void	partial_fit(const float* X, const int* Y, int n_samples,
+			            int steps = 1);
+	void	partial_fit(const float* X, int ld, const int* Y, int n_samples,
+			            int steps = 1);
+	void	partial_fit(const CsrMatrix& X, const int* Y, int steps = 1);
+
+	// Decay of the partial_fit step size with the rows it has seen
+	// (default 0: constant lr).
+	void	set_lr_decay(float decay);
+	float	get_lr_decay() const { return lr_decay; }
+	int64_t	get_samples_seen() const { return samples_seen; }
+
+	// Zero the optimizer state and samples_seen, keeping the weights:
+	// the next partial_fit restarts its schedule (warm start).
+	void	reset_online_state();
+
+	// Train / score on a Dataset (Dataset.hpp), in memory or mapped
+	// from disk.  Its rows are already in the padded layout and are
+	// read in place: no copy per call, and nothing allocated beyond
+	// the gradient slots.  Throws std::runtime_error when
+	// data.n_features() != n_features, or when training on a Dataset
+	// without labels.
+	void	train(const Dataset& data);
+	void	predict_batch(const Dataset& data, float* out) const;
+	void	predict_class_batch(const Dataset& data, int* out) const;
+
+	// Train / score on sparse rows (CsrMatrix.hpp), read in place.
+	// Each epoch costs O(X.nnz() + n_features): logits are gathered
+	// dot products and the gradient is scatter-added, so no dense row
+	// is formed.  Throws std::runtime_error when X.n_cols !=
+	// n_features.
+	void	train(const CsrMatrix& X, const int* Y);
+	void	train(const CsrMatrix& X, const int* Y, Workspace& ws);
+	void	predict_batch(const CsrMatrix& X, float* out) const;
+	void	predict_class_batch(const CsrMatrix& X, int* out) const;
+
+	// ---- single-sample (online) scoring ----
+	// x points at n_features floats of any alignment.  These read x in
+	// place, allocate nothing, call the widest SIMD kernel the build
+	// targets directly (no function-pointer dispatch) and touch no
+	// mutable state, so any number of threads may score concurrently
+	// on a const model.
 
 	// Returns P(y=1 | x)  ∈ (0, 1)  for a single sample.
-	float	predict(const float* x) const;
+	float	predict(const float* x) const noexcept;
 
 	// Returns the predicted class label (0 or 1) for a single sample.
-	int		predict_class(const float* x) const;
+	int		predict_class(const float* x) const noexcept;
+
+	// Returns the logit <w, x> + b for a single sample.
+	float	logit(const float* x) const noexcept;
 
 	// Batch prediction: write P(y=1|x_i) into out[0..n_samples-1].
+	// A padded copy of X, when one is made, goes to ws or else to a
+	// temporary Workspace; pass a reused one to keep repeated scoring
+	// allocation-free.
 	void	predict_batch(const float* X, float* out, int n_samples) const;
+	void	predict_batch(const float* X, float* out, int n_samples,
+			              Workspace& ws) const;
+	void	predict_batch(const float* X, int ld, float* out, int n_samples) const;
+	void	predict_batch(const float* X, int ld, float* out, int n_samples,
+			              Workspace& ws) const;
 
 	// Batch classification: write 0/1 into out[0..n_samples-1].
 	void	predict_class_batch(const float* X, int* out, int n_samples) const;
+	void	predict_class_batch(const float* X, int* out, int n_samples,
+			                    Workspace& ws) const;
+	void	predict_class_batch(const float* X, int ld, int* out, int n_samples) const;
+	void	predict_class_batch(const float* X, int ld, int* out, int n_samples,
+			                    Workspace& ws) const;
+
+	// Run on a caller-owned pool instead of the model's own one.  The
+	// pool must outlive the model (or the next set_thread_pool call);
+	// nullptr switches back to the model's own pool.
+	void	set_thread_pool(ThreadPool* pool);
 
 	int		get_n_features() const { return n_features; }
+	int		get_n_threads() const;
+
+	// Trained parameters: padded_features weights (zero past
+	// n_features) and the bias.
+	const float*	get_weights() const { return weights; }
+	float			get_bias() const { return bias; }
+
+	// Sigmoid tier used by train and predict_batch (default
+	// SIGMOID_ACCURATE).  The single-sample path always uses libm exp.
+	void			set_sigmoid_accuracy(SigmoidAccuracy accuracy);
+	SigmoidAccuracy	get_sigmoid_accuracy() const { return sigmoid_accuracy; }
+
+	// Row format train(X, ...) works on (default STORAGE_F32).  With
+	// STORAGE_F16 / STORAGE_BF16 each call rounds X once into a padded
+	// 16-bit copy in the Workspace and every epoch streams half the
+	// bytes; weights and sums stay float32.  Scoring float arrays
+	// always reads them as float32; a Dataset carries its own format.
+	void			set_feature_storage(FeatureStorage storage);
+	FeatureStorage	get_feature_storage() const { return feature_storage; }
+
+	// Optimiser of train on dense float32 rows (default SOLVER_GD;
+	// solvers.hpp).  SOLVER_LBFGS and SOLVER_IRLS ignore lr and run
+	// at most `epochs` iterations, each usually one pass over X, until
+	// every component of the mean log-loss gradient is within tol
+	// (default 1e-4).  They throw std::runtime_error from train on
+	// 16-bit or sparse rows; set_solver(SOLVER_IRLS) throws when
+	// n_features > IRLS_MAX_FEATURES.  SOLVER_HOGWILD (set_hogwild)
+	// also trains on sparse rows.  train_minibatch always takes
+	// gradient steps.
+	void			set_solver(Solver solver);
+	Solver			get_solver() const { return solver; }
+	void			set_tolerance(float tol);
+	float			get_tolerance() const { return tol; }
+
+	// Update rule of gradient descent (default OPTIMIZER_SGD): train
+	// with SOLVER_GD on any row format, and train_minibatch.  Each
+	// step is one fused SIMD pass over the gradient, the state and the
+	// weights.  Momentum and Nesterov use beta1 as the momentum, Adam
+	// both betas; eps offsets the AdaGrad / Adam denominators.  The
+	// state (one or, for Adam, two vectors like the weights) is
+	// allocated here and starts from zero at every train call;
+	// partial_fit carries it on from call to call.
+	void		set_optimizer(Optimizer opt, float beta1 = 0.9f,
+			              float beta2 = 0.999f, float eps = 1e-8f);
+	Optimizer	get_optimizer() const { return opt_state.kind; }
+
+	// SOLVER_HOGWILD: each of n_threads pool threads (0: the whole pool,
+	// capped at its size) takes one contiguous shard of the rows and
+	// runs `epochs` passes over it, stepping w -= step (p - y) x per
+	// row on the shared weights without locks; the threads meet only
+	// when train returns.  step is per row and per thread, not scaled
+	// by the row count as lr is (default 0.01).  Hogwild! ignores the
+	// optimizer and the convergence monitoring below, and is not
+	// deterministic with more than one thread.
+	void	set_hogwild(float step, int n_threads = 0);
+	float	get_hogwild_step() const { return hogwild_step; }
+	int		get_hogwild_threads() const { return hogwild_threads; }
+
+	// Passes over the training rows made by the last train call.
+	int				get_n_passes() const { return n_passes; }
+
+	// Training rows processed per second by the last train call
+	// (n_passes × rows over its wall time, any copy of X included).
+	double			get_samples_per_second() const { return samples_per_sec; }
+
+	// ---- convergence monitoring (gradient descent) ----
+	// When any of these is set, every epoch of train / train_minibatch
+	// with SOLVER_GD also sums the log-loss of its rows in the same
+	// sweep (the vectorised loss of the logits the epoch computes
+	// anyway) and takes the gradient norm from its reduction; a
+	// validation set costs one more forward pass over its rows.
+	// Nothing is computed when none is set.
+
+	// Stop once the monitored loss (validation loss when a validation
+	// set is given, else training loss) has not fallen below its best
+	// by more than loss_tol for `patience` epochs in a row, or once
+	// EpochStats::grad_norm <= grad_tol.  0 disables a test (default:
+	// both off, every epoch runs).
+	void	set_early_stopping(float loss_tol, float grad_tol = 0.0f,
+			                   int patience = 5);
+	float	get_loss_tolerance() const { return stop_loss_tol; }
+	float	get_grad_tolerance() const { return stop_grad_tol; }
+	int		get_patience() const { return stop_patience; }
+
+	// Held-out rows scored after every epoch, read in place (nullptr:
+	// none).  data must have labels, match n_features and outlive its
+	// use.  Training then ends on the weights of the epoch with the
+	// lowest validation loss.  Throws std::runtime_error on a
+	// mismatching or unlabelled Dataset.
+	void			set_validation(const Dataset* data);
+	const Dataset*	get_validation() const { return validation; }
+
+	// Called after every epoch on the training thread; returning true
+	// stops training.  An empty function removes it.
+	void	set_epoch_callback(EpochCallback callback);
 
 private:
 	int		n_features;
@@ -50,6 +274,67 @@ private:
 
 	float*	weights;           // 32-byte aligned, length = padded_features
 	float	bias;
+	float*	opt_buffer;        // optimizer state: 2 × padded_features, or null
+	OptState	opt_state;
+	float	lr_decay;
+	int64_t	samples_seen;      // rows stepped on by partial_fit
+
+	SigmoidAccuracy	sigmoid_accuracy;
+	FeatureStorage	feature_storage;
+	Solver			solver;
+	float			tol;
+	int				n_passes;
+	double			samples_per_sec;
+	float			hogwild_step;
+	int				hogwild_threads;
+
+	float			stop_loss_tol;
+	float			stop_grad_tol;
+	int				stop_patience;
+	const Dataset*	validation;
+	EpochCallback	epoch_callback;
+
+	// Rows the kernels read for `passes` sweeps over X: X itself or
+	// its padded copy in ws (updates ld, sets cols).
+	const float*	input_rows(const float* X, int& ld, int& cols,
+			                   int n_samples, int passes, Workspace& ws) const;
+
+	// Arguments of train_loop / predict_loop / classify_loop for rows
+	// ld floats apart of which the kernels read cols.
+	TrainJob	train_job(const float* X, int ld, int cols, const int* Y,
+			          int n_samples, Workspace& ws);
+	ScoreJob	score_job(const float* X, int ld, int cols, int n_samples,
+			          float* probs, int* labels) const;
+	SparseTrainJob	sparse_train_job(const CsrMatrix& X, const int* Y,
+			                 Workspace& ws);
+	SparseScoreJob	sparse_score_job(const CsrMatrix& X, float* probs,
+			                 int* labels) const;
+
+	// Zeroed optimizer state for a new train call; null for SGD.
+	OptState*	fresh_opt_state();
+	OptState*	live_opt_state();
+
+	// partial_fit's step size for its next step.
+	float		online_lr() const;
+
+	// Run the selected solver on a float32 job.
+	void		solve(TrainJob job, Workspace& ws);
+	int			hogwild_shards() const;
+	void		check_gd_solver() const;
+
+	// Gradient descent through loop (train_loop, half_train_loop or
+	// sparse_train_loop), watched by an EpochMonitor when monitoring
+	// is on; sets n_passes.
+	bool		monitoring() const;
+	ScoreJob	validation_job() const;
+	template <class Job>
+	void		descend(Job job, void (*loop)(const Job&, ThreadPool&),
+			        Workspace& ws);
+
+	std::unique_ptr<ThreadPool>	own_pool;
+	ThreadPool*					pool;      // own_pool or caller's, never null
+
+	Workspace					workspace; // scratch for train(X, Y, n)
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef MAPPED_DATASET_H
+# define MAPPED_DATASET_H
+
+# include <cstddef>
+# include <cstdint>
+# include "Dataset.hpp"
+
+// ---------------------------------------------------------------
+//  On-disk data set format (.lrds)
+//  Laid out exactly as the kernels want it, so training can read
+//  rows straight from the page cache with no padding copy:
+//
+//    [0, 64)              DatasetHeader
+//    [x_offset, ...)      n_samples rows of padded_features floats,
+//                         zero past n_features
+//    [y_offset, ...)      n_samples int32 labels
+//
+//  padded_features is n_features rounded up to a multiple of 8 and
+//  both sections start on a 4096-byte boundary, so every row of a
+//  mapping is 32-byte aligned.  Fields are little-endian.
+// ---------------------------------------------------------------
+
+# define LOGREG_DATASET_MAGIC	"LOGREGDS"
+# define LOGREG_DATASET_VERSION	1
+# define LOGREG_DATASET_ALIGN	4096
+
+enum DatasetDtype {
+	DATASET_F32 = 0     // float32 rows, int32 labels
+};
+
+struct DatasetHeader {
+	char		magic[8];           // LOGREG_DATASET_MAGIC, no terminator
+	uint32_t	version;
+	uint32_t	dtype;              // DatasetDtype
+	uint64_t	n_samples;
+	uint32_t	n_features;
+	uint32_t	padded_features;
+	uint64_t	x_offset;           // bytes from the start of the file
+	uint64_t	y_offset;
+	uint64_t	file_size;
+	uint64_t	reserved;
+};
+
+static_assert(sizeof(DatasetHeader) == 64, "DatasetHeader is 64 bytes on disk");
+
+// Write X [n_samples × n_features] (row-major, any alignment) and
+// Y [n_samples] to path in the format above.  Streams one row at a
+// time; throws std::runtime_error on I/O failure.
+void	write_dataset(const char* path, const float* X, const int* Y,
+		              int64_t n_samples, int n_features);
+
+// Convert raw files — x_path: row-major float32 [n × n_features],
+// y_path: int32 [n] — to the format above without loading either
+// into memory.  n is taken from the file sizes.  Returns n.
+int64_t	convert_raw_dataset(const char* x_path, const char* y_path,
+		                    int n_features, const char* out_path);
+
+// Page-cache access hints for a mapped data set (madvise).
+enum DatasetAdvice {
+	ADVISE_NORMAL,
+	ADVISE_SEQUENTIAL,  // read ahead aggressively, pages may be dropped
+	                    // soon after use: single passes over sets
+	                    // larger than RAM
+	ADVISE_RANDOM,      // no read-ahead
+	ADVISE_WILLNEED     // start reading the whole file in the background
+};
+
+// ---------------------------------------------------------------
+//  MappedDataset
+//  Dataset backed by a read-only memory mapping of a .lrds file.
+//  X() and Y() point into the mapping, so train / predict_batch on a
+//  MappedDataset neither copy nor allocate for the data: cold start
+//  is the mmap call, and RSS is whatever part of the file the page
+//  cache holds.
+//
+//  The constructor validates the header and throws
+//  std::runtime_error on a missing, truncated or foreign file.
+// ---------------------------------------------------------------
+class MappedDataset : public Dataset {
+public:
+	explicit MappedDataset(const char* path,
+	                       DatasetAdvice advice = ADVISE_WILLNEED);
+	~MappedDataset() override;
+
+	// Apply an access hint to the whole mapping (no-op where the
+	// platform has no madvise).
+	void	advise(DatasetAdvice advice);
+
+	size_t	size_bytes() const { return length; }
+
+private:
+	void*	base;
+	size_t	length;
+# if defined(_WIN32)
+	void*			file;
+	void*			mapping;
+# endif
+
+	void	unmap();
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef QUANT_LOG_REG_H
+# define QUANT_LOG_REG_H
+
+# include <stdint.h>
+# include <memory>
+# include "Workspace.hpp"
+# include "logreg_dispatcher.hpp"
+
+class ThreadPool;
+class LogisticRegression;
+
+// ---------------------------------------------------------------
+//  QuantizedLogisticRegression
+//  Int8 scoring copy of a trained LogisticRegression.  Each feature
+//  j gets an affine 7-bit code calibrated on a sample of rows,
+//
+//      x_j ≈ zero_point_j + scale_j * q_j,    q_j ∈ [0, 127],
+//
+//  spanning the sample's [min, max] of the column (values outside
+//  are clamped).  The feature scales fold into the weights, which
+//  are rounded to int8 with one shared weight_scale, and the zero
+//  points fold into the bias, so a logit is
+//
+//      weight_scale * Σ_j wq_j q_j + offset
+//
+//  with the sum exact in int32 (gemv_u8s8: vpmaddubsw, or vpdpbusd
+//  with AVX-512 VNNI) and the model's vectorised sigmoid after it.
+//
+//  quantize() stores rows as n_features bytes, a quarter of their
+//  float32 size, and scoring those codes reads a quarter of the
+//  bytes.  Float rows can also be scored directly; they are then
+//  quantized block by block into the Workspace.  The model is
+//  immutable after construction, so any number of threads may score
+//  on it with their own Workspace.
+// ---------------------------------------------------------------
+class QuantizedLogisticRegression {
+public:
+	// Quantize `model` with feature ranges taken from X_cal [n_cal ×
+	// n_features] (rows ld floats apart, ld = n_features when
+	// omitted).  Throws std::runtime_error when n_cal < 1 or ld <
+	// n_features.  Its sigmoid tier is copied from the model.
+	QuantizedLogisticRegression(const LogisticRegression& model,
+	                            const float* X_cal, int n_cal);
+	QuantizedLogisticRegression(const LogisticRegression& model,
+	                            const float* X_cal, int ld, int n_cal,
+	                            int n_threads = 1);
+
+	~QuantizedLogisticRegression();
+
+	QuantizedLogisticRegression(const QuantizedLogisticRegression&)            = delete;
+	QuantizedLogisticRegression& operator=(const QuantizedLogisticRegression&) = delete;
+
+	// Codes of X [n_samples × n_features] (rows ld floats apart) into
+	// out, n_samples rows ldq >= n_features bytes apart (ldq =
+	// n_features when omitted).
+	void	quantize(const float* X, int ld, int n_samples, uint8_t* out) const;
+	void	quantize(const float* X, int ld, int n_samples, uint8_t* out,
+			         int ldq) const;
+
+	// Score quantized rows Xq, ldq >= n_features bytes apart.
+	// predict_batch writes P(y=1|x_i), predict_class_batch 0/1; the
+	// latter keeps its logits in ws (or a temporary Workspace).
+	void	predict_batch(const uint8_t* Xq, int ldq, float* out,
+			              int n_samples) const;
+	void	predict_class_batch(const uint8_t* Xq, int ldq, int* out,
+			                    int n_samples) const;
+	void	predict_class_batch(const uint8_t* Xq, int ldq, int* out,
+			                    int n_samples, Workspace& ws) const;
+
+	// Score float rows (ld floats apart), quantizing each block into
+	// ws first.
+	void	predict_batch(const float* X, int ld, float* out,
+			              int n_samples) const;
+	void	predict_batch(const float* X, int ld, float* out,
+			              int n_samples, Workspace& ws) const;
+	void	predict_class_batch(const float* X, int ld, int* out,
+			                    int n_samples) const;
+	void	predict_class_batch(const float* X, int ld, int* out,
+			                    int n_samples, Workspace& ws) const;
+
+	// Run on a caller-owned pool (see LogisticRegression).
+	void	set_thread_pool(ThreadPool* pool);
+
+	int		get_n_features() const { return n_features; }
+	int		get_n_threads() const;
+
+	// Calibration and quantized parameters.
+	const float*	get_scale() const { return scale; }           // [n_features]
+	const float*	get_zero_point() const { return zero_point; } // [n_features]
+	const int8_t*	get_weights() const { return wq; }            // [n_features]
+	float			get_weight_scale() const { return weight_scale; }
+	float			get_offset() const { return offset; }
+
+private:
+	int		n_features;
+
+	float*	scale;             // [n_features], zero-padded to 16
+	float*	inv_scale;         // 1 / scale, likewise
+	float*	zero_point;        // the value of code 0, likewise
+	int8_t*	wq;                // zero-padded to a multiple of 64 bytes
+	float	weight_scale;
+	float	offset;            // bias + Σ w_j zero_point_j
+
+	bool	fast_sigmoid;
+
+	// Rows per parallel block.
+	int		block_rows(int row_bytes) const;
+
+	void	score(const uint8_t* Xq, int ldq, float* logits, int n) const;
+	void	activate(float* z, int n) const;
+
+	std::unique_ptr<ThreadPool>	own_pool;
+	ThreadPool*					pool;      // own_pool or caller's, never null
+};
+
+#endif
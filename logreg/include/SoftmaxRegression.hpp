@@ -0,0 +1,102 @@
+#ifndef SOFTMAX_REG_H
+# define SOFTMAX_REG_H
+
+# include <memory>
+# include "Workspace.hpp"
+# include "logreg_dispatcher.hpp"
+
+class ThreadPool;
+
+// ---------------------------------------------------------------
+//  SoftmaxRegression
+//  Multinomial logistic regression over K classes, trained with
+//  full-batch gradient descent on the cross-entropy loss.  Weights
+//  are a K × padded_features matrix (rows 32-byte aligned, zero past
+//  n_features) plus K biases.
+//
+//  Every epoch is one sweep over X for all classes at once: a
+//  register-tiled GEMM kernel gives the K logits of a block of rows,
+//  a vectorised softmax (the exp of simd_math.hpp) turns them into
+//  probabilities, and every class gradient is accumulated from the
+//  same block while it is in cache.  K one-vs-rest LogisticRegression
+//  models would read X K times per epoch instead.
+//
+//  Input rows are read in place at any alignment and row stride.
+//  Threads, Workspace and init_kernels() as for LogisticRegression.
+// ---------------------------------------------------------------
+class SoftmaxRegression {
+public:
+	// n_classes >= 2; labels are 0 .. n_classes - 1.
+	SoftmaxRegression(int n_features,
+	                  int   n_classes,
+	                  float lr        = 0.1f,
+	                  int   epochs    = 1000,
+	                  int   n_threads = 1);
+
+	~SoftmaxRegression();
+
+	SoftmaxRegression(const SoftmaxRegression&)            = delete;
+	SoftmaxRegression& operator=(const SoftmaxRegression&) = delete;
+
+	// Train on X [n_samples × n_features] (rows ld floats apart, ld =
+	// n_features when omitted) and Y [n_samples].  Throws
+	// std::runtime_error if a label is outside [0, n_classes).
+	void	train(const float* X, const int* Y, int n_samples);
+	void	train(const float* X, int ld, const int* Y, int n_samples);
+	void	train(const float* X, int ld, const int* Y, int n_samples,
+			      Workspace& ws);
+
+	// out [n_samples × n_classes], row-major: P(y = k | x_i).
+	void	predict_proba(const float* X, float* out, int n_samples) const;
+	void	predict_proba(const float* X, int ld, float* out, int n_samples) const;
+	void	predict_proba(const float* X, int ld, float* out, int n_samples,
+			              Workspace& ws) const;
+
+	// out [n_samples]: the most likely class of each row (the largest
+	// logit, so no softmax is evaluated).
+	void	predict_class_batch(const float* X, int* out, int n_samples) const;
+	void	predict_class_batch(const float* X, int ld, int* out, int n_samples) const;
+	void	predict_class_batch(const float* X, int ld, int* out, int n_samples,
+			                    Workspace& ws) const;
+
+	// Run on a caller-owned pool (see LogisticRegression).
+	void	set_thread_pool(ThreadPool* pool);
+
+	int		get_n_features() const { return n_features; }
+	int		get_n_classes() const { return n_classes; }
+	int		get_n_threads() const;
+
+	// Weight row of class k (padded_features floats) and the biases.
+	const float*	get_weights(int k) const { return weights + (size_t)k * padded_features; }
+	const float*	get_bias() const { return bias; }
+
+	// exp tier of the softmax (default SIGMOID_ACCURATE): the same
+	// two polynomials the sigmoid tiers use.
+	void			set_exp_accuracy(SigmoidAccuracy accuracy);
+	SigmoidAccuracy	get_exp_accuracy() const { return exp_accuracy; }
+
+private:
+	int		n_features;
+	int		padded_features;   // n_features rounded up to next multiple of 8
+	int		n_classes;
+	float	lr;
+	int		epochs;
+
+	float*	weights;           // [n_classes × padded_features], 64-byte aligned
+	float*	bias;              // [n_classes]
+
+	SigmoidAccuracy	exp_accuracy;
+
+	// Rows per parallel block: X block and its K logits in ~128 KB.
+	int		block_rows() const;
+
+	void	score(const float* X, int ld, int n_samples, float* probs,
+			      int* labels, Workspace& ws) const;
+
+	std::unique_ptr<ThreadPool>	own_pool;
+	ThreadPool*					pool;      // own_pool or caller's, never null
+
+	Workspace					workspace; // scratch for train
+};
+
+#endif
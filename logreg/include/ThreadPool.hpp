@@ -0,0 +1,73 @@
+#ifndef THREAD_POOL_H
+# define THREAD_POOL_H
+
+# include <condition_variable>
+# include <cstdint>
+# include <mutex>
+# include <thread>
+# include <type_traits>
+# include <vector>
+
+// ---------------------------------------------------------------
+//  ThreadPool
+//  Persistent pool of worker threads.  The calling thread always
+//  takes part in the work as thread 0, so a pool of size 1 owns no
+//  workers at all and runs everything inline.
+//
+//  parallel_for() splits [0, n_tasks) into contiguous, equally
+//  sized chunks (one per thread).  Thread t always receives the
+//  same chunk for a given n_tasks, which keeps floating-point
+//  reductions reproducible from run to run.
+// ---------------------------------------------------------------
+class ThreadPool {
+public:
+	// n_threads <= 0 selects std::thread::hardware_concurrency().
+	explicit ThreadPool(int n_threads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&)            = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Number of threads taking part in parallel_for (caller included).
+	int		size() const { return n_threads; }
+
+	// Call fn(task, thread) for every task in [0, n_tasks) and block
+	// until all of them have finished.  fn must not throw and must
+	// not call parallel_for on the same pool.  Concurrent callers
+	// from different threads are serialised.
+	template <class F>
+	void	parallel_for(int n_tasks, F&& fn)
+	{
+		using Fn = typename std::remove_reference<F>::type;
+		run(n_tasks,
+		    [](void* ctx, int task, int thread) {
+		        (*static_cast<Fn*>(ctx))(task, thread);
+		    },
+		    static_cast<void*>(&fn));
+	}
+
+private:
+	typedef void (*TaskFn)(void* ctx, int task, int thread);
+
+	void	run(int n_tasks, TaskFn fn, void* ctx);
+	void	run_chunk(int thread);
+	void	worker_loop(int thread);
+
+	int							n_threads;
+	std::vector<std::thread>	workers;
+
+	std::mutex					run_mtx;     // one parallel_for at a time
+	std::mutex					mtx;
+	std::condition_variable		cv_start;
+	std::condition_variable		cv_done;
+	uint64_t					generation;  // bumped once per parallel_for
+	int							pending;     // workers still busy
+	bool						stopping;
+
+	// Current job (valid while a parallel_for is in flight).
+	TaskFn						job_fn;
+	void*						job_ctx;
+	int							job_tasks;
+};
+
+#endif
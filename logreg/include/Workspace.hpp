@@ -0,0 +1,84 @@
+#ifndef WORKSPACE_H
+# define WORKSPACE_H
+
+# include <cstddef>
+# include <stdint.h>
+
+// ---------------------------------------------------------------
+//  Workspace
+//  Scratch memory for LogisticRegression: the padded, aligned copy
+//  of X (float32, 16-bit or int8 codes), the logits, the per-thread
+//  gradient slots, the mini-batch buffers of train_minibatch and
+//  the state of the L-BFGS / IRLS solvers or of early stopping.
+//  Buffers only ever grow, so once a Workspace has seen the largest
+//  batch every later train / predict_batch call on it is
+//  allocation-free.
+//
+//  A Workspace may be shared by several models but not used by two
+//  calls at the same time.
+// ---------------------------------------------------------------
+class Workspace {
+public:
+	Workspace();
+	~Workspace();
+
+	Workspace(const Workspace&)            = delete;
+	Workspace& operator=(const Workspace&) = delete;
+
+	// Grow every buffer up front for n_samples rows of padded_features
+	// floats and n_threads gradient slots.
+	void	reserve(int n_samples, int padded_features, int n_threads);
+
+	// Each returns a 64-byte aligned buffer of at least n floats,
+	// reallocating (contents discarded) only when it is too small.
+	float*	x_buffer(size_t n)    { return x.get(n); }
+	float*	z_buffer(size_t n)    { return z.get(n); }
+	float*	grad_buffer(size_t n) { return grad.get(n); }
+	float*	batch_buffer(size_t n) { return batch.get(n); }
+	float*	solver_buffer(size_t n) { return solver.get(n); }
+	int*	label_buffer(size_t n)
+	{
+		static_assert(sizeof(int) == sizeof(float), "labels share float storage");
+		return reinterpret_cast<int*>(labels.get(n));
+	}
+
+	// The 16-bit copy of X (STORAGE_F16 / STORAGE_BF16) in the same
+	// memory as x_buffer: n elements.
+	uint16_t*	xh_buffer(size_t n)
+	{
+		return reinterpret_cast<uint16_t*>(x.get((n + 1) / 2));
+	}
+
+	// int8 codes of X (QuantizedLogisticRegression), also in x_buffer's
+	// memory: n bytes.
+	uint8_t*	xq_buffer(size_t n)
+	{
+		return reinterpret_cast<uint8_t*>(x.get((n + 3) / 4));
+	}
+
+	// Total bytes currently held.
+	size_t	bytes() const;
+
+	// Return all memory to the allocator.
+	void	release();
+
+private:
+	struct Buffer {
+		float*	ptr      = nullptr;
+		size_t	capacity = 0;     // in floats
+
+		float*	get(size_t n);
+		void	release();
+	};
+
+	Buffer	x;      // padded copy of X   [n_samples × padded_features]
+	                //   (float32, 16-bit elements or int8 codes)
+	Buffer	z;      // logits / probabilities  [n_samples]
+	Buffer	grad;   // per-thread dw + db slots
+	Buffer	batch;  // train_minibatch: two padded batches of X
+	Buffer	labels; // train_minibatch: two batches of Y
+	Buffer	solver; // L-BFGS history / IRLS Hessian slots and factor,
+	                //   or the best weights of early stopping
+};
+
+#endif
@@ -88,12 +88,81 @@ static inline bool	has_fma() {
 	return (result[2] & (1 << 12));
 }
 
+// F16C is VEX-encoded, so it also needs the OS to save the YMM state.
+static inline bool	has_f16c() {
+	int		result[4];
+
+	if (!has_avx()) { return (false); }
+
+	cpuid(result, 1);
+	return (result[2] & (1 << 29)); // ecx bit 29 = f16c
+}
+
+// AVX-512 needs the OS to save the opmask (XCR0 bit 5) and both halves
+// of the extended ZMM state (bits 6 and 7) on top of SSE/AVX (bits 1-2).
+static inline bool	os_avx512() {
+	if (!has_avx()) { return (false); }
+
+	return ((xgetbv(0) & 0xE6) == 0xE6);
+}
+
+static inline bool	has_avx512f() {
+	int		result[4];
+
+	if (!os_avx512()) { return (false); }
+
+	cpuid(result, 7);
+	return (result[1] & (1 << 16)); // ebx bit 16 = avx512f
+}
+
+static inline bool	has_avx512dq() {
+	int		result[4];
+
+	if (!has_avx512f()) { return (false); }
+
+	cpuid(result, 7);
+	return (result[1] & (1 << 17)); // ebx bit 17 = avx512dq
+}
+
+static inline bool	has_avx512vl() {
+	int		result[4];
+
+	if (!has_avx512f()) { return (false); }
+
+	cpuid(result, 7);
+	return (result[1] & (1u << 31)); // ebx bit 31 = avx512vl
+}
+
+static inline bool	has_avx512bw() {
+	int		result[4];
+
+	if (!has_avx512f()) { return (false); }
+
+	cpuid(result, 7);
+	return (result[1] & (1 << 30)); // ebx bit 30 = avx512bw
+}
+
+static inline bool	has_avx512vnni() {
+	int		result[4];
+
+	if (!has_avx512f()) { return (false); }
+
+	cpuid(result, 7);
+	return (result[2] & (1 << 11)); // ecx bit 11 = avx512_vnni
+}
+
 # else // sse and avx doesn't exist on non x86 cpus
 
 static inline bool	has_sse() { return (false); }
 static inline bool	has_sse2() { return (false); }
 static inline bool	has_avx() { return (false); }
 static inline bool	has_avx2() { return (false); }
+static inline bool	has_avx512f() { return (false); }
+static inline bool	has_avx512dq() { return (false); }
+static inline bool	has_avx512vl() { return (false); }
+static inline bool	has_avx512bw() { return (false); }
+static inline bool	has_avx512vnni() { return (false); }
+static inline bool	has_f16c() { return (false); }
 static inline bool has_fma() {
 	#if defined(__aarch64__)
 		return (true); // ARMv8 always has FMA 
@@ -0,0 +1,131 @@
+// half_float.hpp file
+//
+// 16-bit storage formats for feature rows, with float32 as the
+// arithmetic type:
+//
+//   IEEE binary16 (fp16)  1 sign, 5 exponent, 10 mantissa bits: about
+//                         3.3 decimal digits, |x| up to 65504
+//   bfloat16 (bf16)       the top half of a float32: the same range
+//                         as float, 8 mantissa bits (2.4 digits)
+//
+// The scalar conversions below are the reference (round to nearest,
+// ties to even; NaN stays NaN, fp16 overflow becomes infinity).  The
+// vector kernels widen rows with the traits' load_f16 / load_bf16
+// (simd_traits.hpp); the row converters here narrow a whole row once,
+// with F16C when the build targets it.
+
+#ifndef HALF_FLOAT_H
+# define HALF_FLOAT_H
+# include <stdint.h>
+# include <string.h>
+# include <immintrin.h>
+
+// F16C (vcvtph2ps / vcvtps2ph) is only used when the compiler targets
+// it (-march=native on any AVX2 host); the dispatcher also checks the
+// CPU before selecting kernels that use it.
+# if defined(__F16C__)
+#  define LOGREG_HAVE_F16C 1
+# else
+#  define LOGREG_HAVE_F16C 0
+# endif
+
+static inline uint32_t	float_bits(float f)
+{
+	uint32_t	u;
+
+	memcpy(&u, &f, sizeof(u));
+	return (u);
+}
+
+static inline float	bits_float(uint32_t u)
+{
+	float	f;
+
+	memcpy(&f, &u, sizeof(f));
+	return (f);
+}
+
+// ---- bfloat16 ----
+
+static inline float	bf16_to_float(uint16_t h)
+{
+	return (bits_float((uint32_t)h << 16));
+}
+
+static inline uint16_t	float_to_bf16(float f)
+{
+	const uint32_t	u = float_bits(f);
+
+	if ((u & 0x7FFFFFFFu) > 0x7F800000u)                 // NaN: keep it quiet
+		return ((uint16_t)((u >> 16) | 0x0040u));
+	return ((uint16_t)((u + 0x7FFFu + ((u >> 16) & 1u)) >> 16));
+}
+
+// ---- IEEE fp16 ----
+
+static inline float	half_to_float(uint16_t h)
+{
+	const uint32_t	sign = (uint32_t)(h & 0x8000u) << 16;
+	const uint32_t	exp  = (h >> 10) & 0x1Fu;
+	const uint32_t	man  = h & 0x3FFu;
+
+	if (exp == 0x1F)                                      // inf / NaN
+		return (bits_float(sign | 0x7F800000u | (man << 13)));
+	if (exp != 0)                                         // normal
+		return (bits_float(sign | ((exp + 112) << 23) | (man << 13)));
+	// zero / subnormal: man * 2^-24, exact in float
+	const float	v = (float)man * 5.9604644775390625e-8f;
+	return (sign ? -v : v);
+}
+
+static inline uint16_t	float_to_half(float f)
+{
+	const uint32_t	u    = float_bits(f);
+	const uint16_t	sign = (uint16_t)((u >> 16) & 0x8000u);
+	const uint32_t	a    = u & 0x7FFFFFFFu;
+
+	if (a > 0x7F800000u)                                  // NaN
+		return ((uint16_t)(sign | 0x7E00u | ((a >> 13) & 0x3FFu)));
+	if (a >= 0x477FF000u)                                 // rounds past 65504
+		return ((uint16_t)(sign | 0x7C00u));
+	if (a >= 0x38800000u) {                               // normal fp16
+		const uint32_t	r = a + 0x0FFFu + ((a >> 13) & 1u) - (112u << 23);
+		return ((uint16_t)(sign | (r >> 13)));
+	}
+	if (a < 0x33000001u)                                  // below half the
+		return (sign);                                    // smallest subnormal
+	// subnormal fp16: shift the implicit-one mantissa into place
+	const uint32_t	e     = a >> 23;
+	const uint32_t	m     = (a & 0x7FFFFFu) | 0x800000u;
+	const uint32_t	shift = 126 - e;                      // 14 .. 24
+	const uint32_t	half  = 1u << (shift - 1);
+	uint32_t		v     = m >> shift;
+	const uint32_t	rem   = m & ((1u << shift) - 1u);
+	if (rem > half || (rem == half && (v & 1u)))
+		++v;
+	return ((uint16_t)(sign | v));
+}
+
+// ---- whole rows ----
+
+static inline void	float_to_half_row(const float* x, uint16_t* out, uint64_t n)
+{
+	uint64_t	j{0};
+
+# if LOGREG_HAVE_F16C
+	for (; j + 8 <= n; j += 8)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + j),
+			_mm256_cvtps_ph(_mm256_loadu_ps(x + j),
+			                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+# endif
+	for (; j < n; ++j)
+		out[j] = float_to_half(x[j]);
+}
+
+static inline void	float_to_bf16_row(const float* x, uint16_t* out, uint64_t n)
+{
+	for (uint64_t j = 0; j < n; ++j)
+		out[j] = float_to_bf16(x[j]);
+}
+
+#endif
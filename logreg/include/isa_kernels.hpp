@@ -0,0 +1,854 @@
+// isa_kernels.hpp file
+//
+// BLAS-1 (axpy, scal, axpby) and block kernels (gemv, sigmoid,
+// log-loss, fused gradient) written once over the vector traits of simd_traits.hpp.
+// Kernels<T> bundles them as inline static members, so code templated
+// on the ISA — the training and scoring loops in model_loops.cpp — is
+// compiled once per tier with every kernel call inlined.  The exported
+// functions of simd_fn.hpp are thin wrappers around these.
+//
+// Block layout: X is n rows whose starts are ld floats apart, of which
+// the first nf are used.  Rows are read with unaligned loads and a
+// masked tail, so X may be the caller's own row-major matrix
+// (ld = nf = n_features) as well as the padded copy made by
+// copy_to_aligned (ld = nf = pf).  w and dw are the model's padded,
+// aligned vectors.  The FAST template argument selects the fast
+// sigmoid tier; the row format R (simd_math.hpp) lets gemv and
+// fused_grad read 16-bit rows, ld then counting elements, not floats.
+//
+// Sparse kernels take n CSR rows (CsrMatrix.hpp): indptr points at the
+// first row's entry, indices / values are the whole arrays.
+//
+// Softmax kernels work on class-major logits: Z[k * ldz + i] is the
+// logit of row i for class k, so the softmax of W rows runs in one
+// vector per class whatever the number of classes.
+
+#ifndef ISA_KERNELS_H
+# define ISA_KERNELS_H
+# include "logreg_dispatcher.hpp"
+# include "simd_math.hpp"
+# include <algorithm>
+# include <cmath>
+
+// dw[idx[k]] += a * val[k] for the nnz entries of a sparse row.  A
+// scalar loop on every tier: AVX2 has no scatter, and a vector one
+// would lose updates when a row repeats a column.
+static inline void	sparse_axpy_row(float a, const float* val, const int32_t* idx,
+			uint64_t nnz, float* dw)
+{
+	for (uint64_t k = 0; k < nnz; ++k)
+		dw[idx[k]] += a * val[k];
+}
+
+// Coefficients of one optimizer step (Optimizer, logreg_dispatcher.hpp)
+// over the summed gradient dw: g = scale * dw.  For Adam, lr and eps
+// already carry the bias correction of the step,
+// lr √(1 - β2^t) / (1 - β1^t) and ε √(1 - β2^t).
+struct OptStep {
+	float	scale;
+	float	lr;
+	float	beta1;
+	float	beta2;
+	float	eps;
+};
+
+// One weight of an optimizer step: the bias on every tier and the
+// weights on the scalar one.  v is used by Adam only.
+template <Optimizer OPT>
+static inline void	opt_update1(const OptStep& s, float g, float& w, float& m, float& v)
+{
+	if (OPT == OPTIMIZER_SGD) {
+		w -= s.lr * g;
+	}
+	else if (OPT == OPTIMIZER_MOMENTUM) {
+		m  = s.beta1 * m + g;
+		w -= s.lr * m;
+	}
+	else if (OPT == OPTIMIZER_NESTEROV) {
+		m  = s.beta1 * m + g;
+		w -= s.lr * (g + s.beta1 * m);
+	}
+	else if (OPT == OPTIMIZER_ADAGRAD) {
+		m += g * g;
+		w -= s.lr * g / (std::sqrt(m) + s.eps);
+	}
+	else {
+		m  = s.beta1 * m + (1.0f - s.beta1) * g;
+		v  = s.beta2 * v + (1.0f - s.beta2) * g * g;
+		w -= s.lr * m / (std::sqrt(v) + s.eps);
+	}
+}
+
+// Feature tile of the softmax GEMM: 4 rows and every class's weights
+// over KC floats stay in L1 while the tile is multiplied out.
+static const uint64_t	GEMM_KC = 512;
+
+// ============================================================
+//  Vector tiers  (T::W rows per group)
+// ============================================================
+
+template <class T>
+struct Kernels {
+	typedef typename T::vec	vec;
+
+	// dw[0:nf] += a * x[0:nf]
+	template <class R = RowsF32>
+	static inline void	axpy_row(float a, const typename R::elem* x, float* dw, uint64_t nf)
+	{
+		const vec	va = T::set1(a);
+		uint64_t	j{0};
+
+		for (; j + T::W <= nf; j += T::W)
+			T::store(dw + j, T::fmadd(va, R::template load<T>(x + j), T::load(dw + j)));
+		if (j < nf) {
+			const uint64_t k = nf - j;
+			T::store_partial(dw + j, T::fmadd(va, R::template load_partial<T>(x + j, k),
+			                                  T::load_partial(dw + j, k)), k);
+		}
+	}
+
+	// ---- BLAS-1 over n floats, any alignment, one masked tail step ----
+
+	// y += a * x
+	static inline void	axpy(float a, const float* x, float* y, uint64_t n)
+	{
+		const vec	va = T::set1(a);
+		uint64_t	i{0};
+
+		for (; i + T::W <= n; i += T::W)
+			T::storeu(y + i, T::fmadd(va, T::loadu(x + i), T::loadu(y + i)));
+		if (i < n)
+			T::store_partial(y + i, T::fmadd(va, T::load_partial(x + i, n - i),
+			                                 T::load_partial(y + i, n - i)), n - i);
+	}
+
+	// x *= a
+	static inline void	scal(float a, float* x, uint64_t n)
+	{
+		const vec	va = T::set1(a);
+		uint64_t	i{0};
+
+		for (; i + T::W <= n; i += T::W)
+			T::storeu(x + i, T::mul(va, T::loadu(x + i)));
+		if (i < n)
+			T::store_partial(x + i, T::mul(va, T::load_partial(x + i, n - i)), n - i);
+	}
+
+	// y = a * x + b * y
+	static inline void	axpby(float a, const float* x, float b, float* y, uint64_t n)
+	{
+		const vec	va = T::set1(a);
+		const vec	vb = T::set1(b);
+		uint64_t	i{0};
+
+		for (; i + T::W <= n; i += T::W)
+			T::storeu(y + i, T::fmadd(va, T::loadu(x + i), T::mul(vb, T::loadu(y + i))));
+		if (i < n)
+			T::store_partial(y + i, T::fmadd(va, T::load_partial(x + i, n - i),
+			                                 T::mul(vb, T::load_partial(y + i, n - i))), n - i);
+	}
+
+	// ---- fused optimizer step over n weights ----
+	// One pass reads dw, w and the state (m; v for Adam only) and
+	// writes the new state and weights, as opt_update1.
+
+	template <Optimizer OPT>
+	static inline void	opt_update(const OptStep& s, vec g, vec& w, vec& m, vec& v)
+	{
+		const vec	lr = T::set1(s.lr);
+		const vec	b1 = T::set1(s.beta1);
+
+		if (OPT == OPTIMIZER_MOMENTUM) {
+			m = T::fmadd(b1, m, g);
+			w = T::fnmadd(lr, m, w);
+		}
+		else if (OPT == OPTIMIZER_NESTEROV) {
+			m = T::fmadd(b1, m, g);
+			w = T::fnmadd(lr, T::fmadd(b1, m, g), w);
+		}
+		else if (OPT == OPTIMIZER_ADAGRAD) {
+			m = T::fmadd(g, g, m);
+			w = T::fnmadd(lr, T::div(g, T::add(T::sqrt(m), T::set1(s.eps))), w);
+		}
+		else {
+			const vec	b2 = T::set1(s.beta2);
+			m = T::fmadd(b1, m, T::mul(T::set1(1.0f - s.beta1), g));
+			v = T::fmadd(b2, v, T::mul(T::set1(1.0f - s.beta2), T::mul(g, g)));
+			w = T::fnmadd(lr, T::div(m, T::add(T::sqrt(v), T::set1(s.eps))), w);
+		}
+	}
+
+	template <Optimizer OPT>
+	static inline void	opt_step(const OptStep& s, const float* dw, float* w,
+				float* m, float* v, uint64_t n)
+	{
+		static_assert(OPT != OPTIMIZER_SGD, "an SGD step is an axpy");
+		const bool	adam = OPT == OPTIMIZER_ADAM;
+		const vec	vs = T::set1(s.scale);
+		vec			vv = T::zero();
+		uint64_t	i{0};
+
+		for (; i + T::W <= n; i += T::W) {
+			vec	wv = T::loadu(w + i);
+			vec	mv = T::loadu(m + i);
+			if (adam)
+				vv = T::loadu(v + i);
+			opt_update<OPT>(s, T::mul(vs, T::loadu(dw + i)), wv, mv, vv);
+			T::storeu(w + i, wv);
+			T::storeu(m + i, mv);
+			if (adam)
+				T::storeu(v + i, vv);
+		}
+		if (i < n) {
+			const uint64_t	k = n - i;
+			vec	wv = T::load_partial(w + i, k);
+			vec	mv = T::load_partial(m + i, k);
+			if (adam)
+				vv = T::load_partial(v + i, k);
+			opt_update<OPT>(s, T::mul(vs, T::load_partial(dw + i, k)), wv, mv, vv);
+			T::store_partial(w + i, wv, k);
+			T::store_partial(m + i, mv, k);
+			if (adam)
+				T::store_partial(v + i, vv, k);
+		}
+	}
+
+	// ---- block kernels over padded rows ----
+
+	template <class R = RowsF32>
+	static inline void	gemv(const typename R::elem* X, uint64_t n, uint64_t ld,
+				uint64_t nf, const float* w, float b, float* out)
+	{
+		const __m128	vb = _mm_set1_ps(b);
+		uint64_t		i{0};
+
+		for (; i + 4 <= n; i += 4)
+			_mm_storeu_ps(out + i, _mm_add_ps(dot4_rows<T, R>(X + i * ld, ld, w, nf), vb));
+		for (; i < n; ++i)
+			out[i] = dot_row<T, R>(X + i * ld, w, nf) + b;
+	}
+
+	// The tail goes through the vector code on zero-filled lanes, so
+	// a value's result does not depend on its position in the array.
+	template <bool FAST>
+	static inline void	sigmoid(const float* a, float* out, uint64_t n)
+	{
+		uint64_t i{0};
+
+		for (; i + T::W <= n; i += T::W)
+			T::storeu(out + i, vect_sigmoid<T, FAST>(T::loadu(a + i)));
+		if (i < n)
+			T::store_partial(out + i,
+				vect_sigmoid<T, FAST>(T::load_partial(a + i, n - i)), n - i);
+	}
+
+	// Summed log-loss of the logits z against the labels Y; the tail
+	// lanes are zeroed before they are added.
+	static inline float	logloss(const float* z, const int* Y, uint64_t n)
+	{
+		alignas(64) float	buf[T::W];
+		vec					lsum = T::zero();
+		uint64_t			i{0};
+
+		for (; i + T::W <= n; i += T::W)
+			lsum = T::add(lsum, vect_logloss<T>(T::loadu(z + i), T::labels(Y + i)));
+		if (i < n) {
+			for (uint64_t r = 0; r < T::W; ++r)
+				buf[r] = (i + r < n) ? static_cast<float>(Y[i + r]) : 0.0f;
+			const vec l = vect_logloss<T>(T::load_partial(z + i, n - i), T::load(buf));
+			T::store(buf, l);
+			for (uint64_t r = n - i; r < T::W; ++r)
+				buf[r] = 0.0f;
+			lsum = T::add(lsum, T::load(buf));
+		}
+		return (T::hsum(lsum));
+	}
+
+	// With LOSS the rows' summed log-loss is also added to *loss.
+	template <bool FAST, class R = RowsF32, bool LOSS = false>
+	static inline float	fused_grad(const typename R::elem* X, const int* Y, uint64_t n,
+				uint64_t ld, uint64_t nf, const float* w, float b, float* dw,
+				float* loss = nullptr)
+	{
+		alignas(64) float	z[T::W];
+		alignas(64) float	y[T::W];
+		alignas(64) float	err[T::W];
+		const vec			vb = T::set1(b);
+		vec					db = T::zero();
+		vec					lsum = T::zero();
+
+		for (uint64_t i = 0; i < n; i += T::W) {
+			const uint64_t	k = (n - i < T::W) ? n - i : T::W;
+
+			vec zv;
+			vec yv;
+			if (k == T::W) {
+				__m128 q[T::W / 4];
+				for (uint64_t g = 0; g < T::W / 4; ++g)
+					q[g] = dot4_rows<T, R>(X + (i + 4 * g) * ld, ld, w, nf);
+				zv = T::from4(q);
+				yv = T::labels(Y + i);
+			}
+			else {
+				for (uint64_t r = 0; r < T::W; ++r) {
+					z[r] = (r < k) ? dot_row<T, R>(X + (i + r) * ld, w, nf) : -b;
+					y[r] = (r < k) ? static_cast<float>(Y[i + r]) : 0.0f;
+				}
+				zv = T::load(z);
+				yv = T::load(y);
+			}
+
+			zv = T::add(zv, vb);
+			vec e = T::sub(vect_sigmoid<T, FAST>(zv), yv);
+			T::store(err, e);
+			if (k < T::W) {
+				for (uint64_t r = k; r < T::W; ++r)
+					err[r] = 0.0f;
+				e = T::load(err);
+			}
+			db = T::add(db, e);
+			if (LOSS) {
+				vec l = vect_logloss<T>(zv, yv);
+				if (k < T::W) {
+					T::store(z, l);
+					for (uint64_t r = k; r < T::W; ++r)
+						z[r] = 0.0f;
+					l = T::load(z);
+				}
+				lsum = T::add(lsum, l);
+			}
+
+			for (uint64_t r = 0; r < k; ++r)
+				axpy_row<R>(err[r], X + (i + r) * ld, dw, nf);
+		}
+		if (LOSS)
+			*loss += T::hsum(lsum);
+		return (T::hsum(db));
+	}
+
+	// ---- block kernels over CSR rows ----
+
+	static inline void	sparse_gemv(const int32_t* indptr, const int32_t* indices,
+				const float* values, uint64_t n, const float* w, float b, float* out)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+			out[i] = sparse_dot<T>(values + indptr[i], indices + indptr[i],
+			                       indptr[i + 1] - indptr[i], w) + b;
+	}
+
+	// fused_grad over sparse rows: the logits of W rows go through one
+	// vectorised sigmoid, then each row is scattered into dw.  LOSS as
+	// for fused_grad.
+	template <bool FAST, bool LOSS = false>
+	static inline float	sparse_fused_grad(const int32_t* indptr, const int32_t* indices,
+				const float* values, const int* Y, uint64_t n, const float* w,
+				float b, float* dw, float* loss = nullptr)
+	{
+		alignas(64) float	z[T::W];
+		alignas(64) float	y[T::W];
+		alignas(64) float	err[T::W];
+		const vec			vb = T::set1(b);
+		vec					db = T::zero();
+		vec					lsum = T::zero();
+
+		for (uint64_t i = 0; i < n; i += T::W) {
+			const uint64_t	k = (n - i < T::W) ? n - i : T::W;
+
+			for (uint64_t r = 0; r < T::W; ++r) {
+				if (r < k) {
+					const int32_t p = indptr[i + r];
+					z[r] = sparse_dot<T>(values + p, indices + p,
+					                     indptr[i + r + 1] - p, w);
+					y[r] = static_cast<float>(Y[i + r]);
+				}
+				else {
+					z[r] = -b;
+					y[r] = 0.0f;
+				}
+			}
+
+			const vec	zv = T::add(T::load(z), vb);
+			const vec	yv = T::load(y);
+			vec			e  = T::sub(vect_sigmoid<T, FAST>(zv), yv);
+			T::store(err, e);
+			if (k < T::W) {
+				for (uint64_t r = k; r < T::W; ++r)
+					err[r] = 0.0f;
+				e = T::load(err);
+			}
+			db = T::add(db, e);
+			if (LOSS) {
+				vec l = vect_logloss<T>(zv, yv);
+				if (k < T::W) {
+					T::store(z, l);
+					for (uint64_t r = k; r < T::W; ++r)
+						z[r] = 0.0f;
+					l = T::load(z);
+				}
+				lsum = T::add(lsum, l);
+			}
+
+			for (uint64_t r = 0; r < k; ++r) {
+				const int32_t p = indptr[i + r];
+				sparse_axpy_row(err[r], values + p, indices + p,
+				                indptr[i + r + 1] - p, dw);
+			}
+		}
+		if (LOSS)
+			*loss += T::hsum(lsum);
+		return (T::hsum(db));
+	}
+
+	// ---- Hogwild! steps: straight into the shared w and *b ----
+
+	// SGD over n rows: for each group of W rows, the logits at w and
+	// *b as they are, then w += -step (p - y) x one row at a time and
+	// *b once.  Other threads may be stepping on w and *b meanwhile;
+	// every access is a plain load or store (model_loops.cpp).
+	template <bool FAST>
+	static inline void	sgd_rows(const float* X, const int* Y, uint64_t n,
+				uint64_t ld, uint64_t nf, float step, float* w, float* b)
+	{
+		alignas(64) float	z[T::W];
+		alignas(64) float	err[T::W];
+		const vec			vs = T::set1(-step);
+
+		for (uint64_t i = 0; i < n; i += T::W) {
+			const uint64_t	k  = (n - i < T::W) ? n - i : T::W;
+			const float		b0 = *b;
+
+			vec zv;
+			if (k == T::W) {
+				__m128 q[T::W / 4];
+				for (uint64_t g = 0; g < T::W / 4; ++g)
+					q[g] = dot4_rows<T, RowsF32>(X + (i + 4 * g) * ld, ld, w, nf);
+				zv = T::from4(q);
+			}
+			else {
+				for (uint64_t r = 0; r < T::W; ++r)
+					z[r] = (r < k) ? dot_row<T, RowsF32>(X + (i + r) * ld, w, nf) : 0.0f;
+				zv = T::load(z);
+			}
+			zv = vect_sigmoid<T, FAST>(T::add(zv, T::set1(b0)));
+			T::store(err, T::mul(vs, zv));
+
+			float db{0};
+			for (uint64_t r = 0; r < k; ++r) {
+				if (Y[i + r])
+					err[r] += step;
+				axpy_row(err[r], X + (i + r) * ld, w, nf);
+				db += err[r];
+			}
+			*b += db;
+		}
+	}
+
+	// sgd_rows over CSR rows: gathered logits, scattered steps.
+	template <bool FAST>
+	static inline void	sparse_sgd_rows(const int32_t* indptr, const int32_t* indices,
+				const float* values, const int* Y, uint64_t n, float step,
+				float* w, float* b)
+	{
+		alignas(64) float	z[T::W];
+		const vec			vs = T::set1(-step);
+
+		for (uint64_t i = 0; i < n; i += T::W) {
+			const uint64_t	k  = (n - i < T::W) ? n - i : T::W;
+			const float		b0 = *b;
+
+			for (uint64_t r = 0; r < T::W; ++r) {
+				if (r < k) {
+					const int32_t p = indptr[i + r];
+					z[r] = sparse_dot<T>(values + p, indices + p,
+					                     indptr[i + r + 1] - p, w);
+				}
+				else
+					z[r] = 0.0f;
+			}
+			const vec zv = vect_sigmoid<T, FAST>(T::add(T::load(z), T::set1(b0)));
+			T::store(z, T::mul(vs, zv));
+
+			float db{0};
+			for (uint64_t r = 0; r < k; ++r) {
+				const int32_t p = indptr[i + r];
+				if (Y[i + r])
+					z[r] += step;
+				sparse_axpy_row(z[r], values + p, indices + p,
+				                indptr[i + r + 1] - p, w);
+				db += z[r];
+			}
+			*b += db;
+		}
+	}
+
+	// ---- softmax (multinomial) block kernels ----
+
+	// Z[k * ldz + i] = <row i, Wm row k> + b[k] for n rows (ld apart,
+	// nf used) and K weight rows (ldw apart, aligned).  Tiled over
+	// GEMM_KC features, with 4 rows × 2 classes per register tile.
+	static inline void	gemm_nt(const float* X, uint64_t n, uint64_t ld, uint64_t nf,
+				const float* Wm, uint64_t ldw, uint64_t K, const float* b,
+				float* Z, uint64_t ldz)
+	{
+		for (uint64_t k = 0; k < K; ++k)
+			for (uint64_t i = 0; i < n; ++i)
+				Z[k * ldz + i] = b[k];
+
+		for (uint64_t j0 = 0; j0 < nf; j0 += GEMM_KC) {
+			const uint64_t	len = (nf - j0 < GEMM_KC) ? nf - j0 : GEMM_KC;
+			uint64_t		i{0};
+
+			for (; i + 4 <= n; i += 4) {
+				const float*	x = X + i * ld + j0;
+				uint64_t		k{0};
+
+				for (; k + 2 <= K; k += 2) {
+					__m128	z0;
+					__m128	z1;
+					dot4x2_rows<T>(x, ld, Wm + k * ldw + j0, Wm + (k + 1) * ldw + j0,
+					               len, z0, z1);
+					float*	o0 = Z + k * ldz + i;
+					float*	o1 = o0 + ldz;
+					_mm_storeu_ps(o0, _mm_add_ps(_mm_loadu_ps(o0), z0));
+					_mm_storeu_ps(o1, _mm_add_ps(_mm_loadu_ps(o1), z1));
+				}
+				if (k < K) {
+					float*	o = Z + k * ldz + i;
+					_mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o),
+						dot4_rows<T>(x, ld, Wm + k * ldw + j0, len)));
+				}
+			}
+			for (; i < n; ++i)
+				for (uint64_t k = 0; k < K; ++k)
+					Z[k * ldz + i] += dot_row<T>(X + i * ld + j0, Wm + k * ldw + j0, len);
+		}
+	}
+
+	// Logits to probabilities in place, W rows at a time: max over the
+	// classes, exp(z - max), one reciprocal of the sum per row.
+	template <bool FAST>
+	static inline void	softmax(float* Z, uint64_t ldz, uint64_t K, uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; i += T::W) {
+			const uint64_t	r = (n - i < T::W) ? n - i : T::W;
+			vec				m = T::load_partial(Z + i, r);
+
+			for (uint64_t k = 1; k < K; ++k)
+				m = T::max(m, T::load_partial(Z + k * ldz + i, r));
+
+			vec	sum = T::zero();
+			for (uint64_t k = 0; k < K; ++k) {
+				const vec	v = T::sub(T::load_partial(Z + k * ldz + i, r), m);
+				const vec	e = FAST ? vector_exp_fast<T>(v) : vector_exp<T>(v);
+				T::store_partial(Z + k * ldz + i, e, r);
+				sum = T::add(sum, e);
+			}
+
+			const vec	inv = FAST ? rcp_nr<T>(sum) : T::div(T::set1(1.0f), sum);
+			for (uint64_t k = 0; k < K; ++k)
+				T::store_partial(Z + k * ldz + i,
+				                 T::mul(T::load_partial(Z + k * ldz + i, r), inv), r);
+		}
+	}
+
+	// dw[0:nf] += e[0] x_0 + e[1] x_1 + e[2] x_2 + e[3] x_3 for 4 rows
+	// ld apart: one load and store of dw per 4 multiply-adds.
+	static inline void	axpy4_rows(const float* e, const float* x, uint64_t ld,
+				float* dw, uint64_t nf)
+	{
+		const vec	e0 = T::set1(e[0]);
+		const vec	e1 = T::set1(e[1]);
+		const vec	e2 = T::set1(e[2]);
+		const vec	e3 = T::set1(e[3]);
+		uint64_t	j{0};
+
+		for (; j + T::W <= nf; j += T::W) {
+			vec	d = T::load(dw + j);
+			d = T::fmadd(e0, T::loadu(x + j), d);
+			d = T::fmadd(e1, T::loadu(x + ld + j), d);
+			d = T::fmadd(e2, T::loadu(x + 2 * ld + j), d);
+			d = T::fmadd(e3, T::loadu(x + 3 * ld + j), d);
+			T::store(dw + j, d);
+		}
+		if (j < nf) {
+			const uint64_t	k = nf - j;
+			vec	d = T::load_partial(dw + j, k);
+			d = T::fmadd(e0, T::load_partial(x + j, k), d);
+			d = T::fmadd(e1, T::load_partial(x + ld + j, k), d);
+			d = T::fmadd(e2, T::load_partial(x + 2 * ld + j, k), d);
+			d = T::fmadd(e3, T::load_partial(x + 3 * ld + j, k), d);
+			T::store_partial(dw + j, d, k);
+		}
+	}
+
+	// Curvature of n rows for the IRLS solver: H += Σ_i s_i x_i x_iᵀ
+	// over the upper triangle (row j from column j, rounded down to a
+	// 64-byte boundary so the stores stay aligned), and the bias row
+	// H[nf] += Σ_i s_i [x_i 1].  H is nf + 1 rows ldh floats apart,
+	// ldh a multiple of 16.  Four rows at a time share each load and
+	// store of H through axpy4_rows.
+	static inline void	hess_rows(const float* s, const float* X, uint64_t n,
+				uint64_t ld, uint64_t nf, float* H, uint64_t ldh)
+	{
+		float*		hb = H + nf * ldh;
+		uint64_t	i{0};
+
+		for (; i + 4 <= n; i += 4) {
+			const float*	x = X + i * ld;
+			alignas(16) float	e[4];
+
+			for (uint64_t j = 0; j < nf; ++j) {
+				const uint64_t	j0 = j & ~(uint64_t)15;
+				e[0] = s[i] * x[j];
+				e[1] = s[i + 1] * x[ld + j];
+				e[2] = s[i + 2] * x[2 * ld + j];
+				e[3] = s[i + 3] * x[3 * ld + j];
+				axpy4_rows(e, x + j0, ld, H + j * ldh + j0, nf - j0);
+			}
+			axpy4_rows(s + i, x, ld, hb, nf);
+			hb[nf] += s[i] + s[i + 1] + s[i + 2] + s[i + 3];
+		}
+		for (; i < n; ++i) {
+			const float*	x = X + i * ld;
+
+			for (uint64_t j = 0; j < nf; ++j) {
+				const uint64_t	j0 = j & ~(uint64_t)15;
+				axpy_row(s[i] * x[j], x + j0, H + j * ldh + j0, nf - j0);
+			}
+			axpy_row(s[i], x, hb, nf);
+			hb[nf] += s[i];
+		}
+	}
+};
+
+// ============================================================
+//  Scalar (reference)
+// ============================================================
+
+template <>
+struct Kernels<IsaScalar> {
+	static inline float	sigmoid1(float z)
+	{
+		return (1.0f / (1.0f + std::exp(-z)));
+	}
+
+	static inline void	axpy(float a, const float* x, float* y, uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+			y[i] += a * x[i];
+	}
+
+	static inline void	scal(float a, float* x, uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+			x[i] *= a;
+	}
+
+	static inline void	axpby(float a, const float* x, float b, float* y, uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+			y[i] = a * x[i] + b * y[i];
+	}
+
+	template <Optimizer OPT>
+	static inline void	opt_step(const OptStep& s, const float* dw, float* w,
+				float* m, float* v, uint64_t n)
+	{
+		float	unused{0};
+
+		for (uint64_t i = 0; i < n; ++i)
+			opt_update1<OPT>(s, s.scale * dw[i], w[i], m[i],
+			                 OPT == OPTIMIZER_ADAM ? v[i] : unused);
+	}
+
+	template <class R = RowsF32>
+	static inline void	gemv(const typename R::elem* X, uint64_t n, uint64_t ld,
+				uint64_t nf, const float* w, float b, float* out)
+	{
+		for (uint64_t i = 0; i < n; ++i) {
+			const typename R::elem*	xi = X + i * ld;
+			float					z{0};
+
+			for (uint64_t j = 0; j < nf; ++j)
+				z += R::get(xi + j) * w[j];
+			out[i] = z + b;
+		}
+	}
+
+	// The scalar tier has no cheaper sigmoid than libm: FAST is ignored.
+	template <bool FAST>
+	static inline void	sigmoid(const float* a, float* out, uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+			out[i] = sigmoid1(a[i]);
+	}
+
+	// max(z, 0) - y z + log1p(exp(-|z|)), as vect_logloss.
+	static inline float	logloss1(float z, float y)
+	{
+		return (std::max(z, 0.0f) - y * z + std::log1p(std::exp(-std::fabs(z))));
+	}
+
+	static inline float	logloss(const float* z, const int* Y, uint64_t n)
+	{
+		float	sum{0};
+
+		for (uint64_t i = 0; i < n; ++i)
+			sum += logloss1(z[i], static_cast<float>(Y[i]));
+		return (sum);
+	}
+
+	template <bool FAST, class R = RowsF32, bool LOSS = false>
+	static inline float	fused_grad(const typename R::elem* X, const int* Y, uint64_t n,
+				uint64_t ld, uint64_t nf, const float* w, float b, float* dw,
+				float* loss = nullptr)
+	{
+		float	db{0};
+
+		for (uint64_t i = 0; i < n; ++i) {
+			const typename R::elem*	xi = X + i * ld;
+			float					z = b;
+
+			for (uint64_t j = 0; j < nf; ++j)
+				z += R::get(xi + j) * w[j];
+
+			float err = sigmoid1(z) - static_cast<float>(Y[i]);
+			for (uint64_t j = 0; j < nf; ++j)
+				dw[j] += err * R::get(xi + j);
+			db += err;
+			if (LOSS)
+				*loss += logloss1(z, static_cast<float>(Y[i]));
+		}
+		return (db);
+	}
+
+	static inline float	sparse_dot1(const int32_t* indptr, const int32_t* indices,
+				const float* values, uint64_t i, const float* w)
+	{
+		float	z{0};
+
+		for (int32_t p = indptr[i]; p < indptr[i + 1]; ++p)
+			z += values[p] * w[indices[p]];
+		return (z);
+	}
+
+	static inline void	sparse_gemv(const int32_t* indptr, const int32_t* indices,
+				const float* values, uint64_t n, const float* w, float b, float* out)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+			out[i] = sparse_dot1(indptr, indices, values, i, w) + b;
+	}
+
+	template <bool FAST, bool LOSS = false>
+	static inline float	sparse_fused_grad(const int32_t* indptr, const int32_t* indices,
+				const float* values, const int* Y, uint64_t n, const float* w,
+				float b, float* dw, float* loss = nullptr)
+	{
+		float	db{0};
+
+		for (uint64_t i = 0; i < n; ++i) {
+			const float	z   = sparse_dot1(indptr, indices, values, i, w) + b;
+			const float	err = sigmoid1(z) - static_cast<float>(Y[i]);
+
+			sparse_axpy_row(err, values + indptr[i], indices + indptr[i],
+			                indptr[i + 1] - indptr[i], dw);
+			db += err;
+			if (LOSS)
+				*loss += logloss1(z, static_cast<float>(Y[i]));
+		}
+		return (db);
+	}
+
+	template <bool FAST>
+	static inline void	sgd_rows(const float* X, const int* Y, uint64_t n,
+				uint64_t ld, uint64_t nf, float step, float* w, float* b)
+	{
+		for (uint64_t i = 0; i < n; ++i) {
+			const float*	x   = X + i * ld;
+			float			z   = *b;
+
+			for (uint64_t j = 0; j < nf; ++j)
+				z += x[j] * w[j];
+			const float	err = -step * (sigmoid1(z) - static_cast<float>(Y[i]));
+			axpy(err, x, w, nf);
+			*b += err;
+		}
+	}
+
+	template <bool FAST>
+	static inline void	sparse_sgd_rows(const int32_t* indptr, const int32_t* indices,
+				const float* values, const int* Y, uint64_t n, float step,
+				float* w, float* b)
+	{
+		for (uint64_t i = 0; i < n; ++i) {
+			const float	z   = sparse_dot1(indptr, indices, values, i, w) + *b;
+			const float	err = -step * (sigmoid1(z) - static_cast<float>(Y[i]));
+
+			sparse_axpy_row(err, values + indptr[i], indices + indptr[i],
+			                indptr[i + 1] - indptr[i], w);
+			*b += err;
+		}
+	}
+
+	static inline void	gemm_nt(const float* X, uint64_t n, uint64_t ld, uint64_t nf,
+				const float* Wm, uint64_t ldw, uint64_t K, const float* b,
+				float* Z, uint64_t ldz)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+			for (uint64_t k = 0; k < K; ++k) {
+				const float*	xi = X + i * ld;
+				const float*	wk = Wm + k * ldw;
+				float			z{0};
+
+				for (uint64_t j = 0; j < nf; ++j)
+					z += xi[j] * wk[j];
+				Z[k * ldz + i] = z + b[k];
+			}
+	}
+
+	// libm exp and division; FAST is ignored, as for sigmoid.
+	template <bool FAST>
+	static inline void	softmax(float* Z, uint64_t ldz, uint64_t K, uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i) {
+			float	m = Z[i];
+			float	sum{0};
+
+			for (uint64_t k = 1; k < K; ++k)
+				m = std::max(m, Z[k * ldz + i]);
+			for (uint64_t k = 0; k < K; ++k) {
+				Z[k * ldz + i] = std::exp(Z[k * ldz + i] - m);
+				sum += Z[k * ldz + i];
+			}
+			for (uint64_t k = 0; k < K; ++k)
+				Z[k * ldz + i] /= sum;
+		}
+	}
+
+	static inline void	axpy4_rows(const float* e, const float* x, uint64_t ld,
+				float* dw, uint64_t nf)
+	{
+		for (uint64_t j = 0; j < nf; ++j)
+			dw[j] += e[0] * x[j] + e[1] * x[ld + j] + e[2] * x[2 * ld + j]
+			       + e[3] * x[3 * ld + j];
+	}
+
+	static inline void	hess_rows(const float* s, const float* X, uint64_t n,
+				uint64_t ld, uint64_t nf, float* H, uint64_t ldh)
+	{
+		float*	hb = H + nf * ldh;
+
+		for (uint64_t i = 0; i < n; ++i) {
+			const float*	x = X + i * ld;
+
+			for (uint64_t j = 0; j < nf; ++j)
+				for (uint64_t k = j; k < nf; ++k)
+					H[j * ldh + k] += s[i] * x[j] * x[k];
+			for (uint64_t j = 0; j < nf; ++j)
+				hb[j] += s[i] * x[j];
+			hb[nf] += s[i];
+		}
+	}
+};
+
+#endif
@@ -7,9 +7,161 @@
 # include "cpu_features.hpp"
 # include <stdint.h>
 
+// Kernel tiers, lowest to highest.
+enum KernelIsa {
+	ISA_SCALAR = 0,
+	ISA_SSE,
+	ISA_AVX,
+	ISA_AVX2_FMA,
+	ISA_AVX512
+};
+
+// Accuracy tier of the vectorised sigmoid, chosen per model.
+//   SIGMOID_ACCURATE : degree-6 exp polynomial, IEEE division, < 2.5 ulp
+//   SIGMOID_FAST     : degree-4 exp2 polynomial, rcp + Newton, < 1e-5 rel.
+enum SigmoidAccuracy {
+	SIGMOID_ACCURATE = 0,
+	SIGMOID_FAST
+};
+
+// Element type of the rows a model trains on (half_float.hpp).  The
+// 16-bit formats halve the bytes read per epoch; weights, products
+// and sums stay float32 in every case.
+//   STORAGE_F32  : float32 (the input read in place, or padded)
+//   STORAGE_F16  : IEEE fp16, 11-bit significand, |x| <= 65504
+//   STORAGE_BF16 : bfloat16, 8-bit significand, float32 range
+enum FeatureStorage {
+	STORAGE_F32 = 0,
+	STORAGE_F16,
+	STORAGE_BF16
+};
+
+// Optimiser of LogisticRegression::train on dense rows (solvers.hpp;
+// Hogwild! in model_loops.cpp).
+//   SOLVER_GD    : `epochs` steps of full-batch gradient descent at lr
+//   SOLVER_LBFGS : limited-memory BFGS with a backtracking line search
+//   SOLVER_IRLS  : Newton / iteratively reweighted least squares, the
+//                  Hessian solved by Cholesky; for n_features <= 1024
+//   SOLVER_HOGWILD : `epochs` passes of lock-free asynchronous SGD
+//                    (Hogwild!): every thread steps through its own
+//                    shard of the rows on the shared weights; dense
+//                    float32 or CSR rows
+enum Solver {
+	SOLVER_GD = 0,
+	SOLVER_LBFGS,
+	SOLVER_IRLS,
+	SOLVER_HOGWILD
+};
+
+// Update rule of the gradient-descent steps (SOLVER_GD and
+// train_minibatch), with g the mean gradient and lr the learning rate.
+//   OPTIMIZER_SGD      : w -= lr g
+//   OPTIMIZER_MOMENTUM : m = β1 m + g,  w -= lr m
+//   OPTIMIZER_NESTEROV : m = β1 m + g,  w -= lr (g + β1 m)
+//   OPTIMIZER_ADAGRAD  : m += g²,  w -= lr g / (√m + ε)
+//   OPTIMIZER_ADAM     : m = β1 m + (1-β1) g,  v = β2 v + (1-β2) g²,
+//                        w -= lr m̂ / (√v̂ + ε), m̂ v̂ bias-corrected
+enum Optimizer {
+	OPTIMIZER_SGD = 0,
+	OPTIMIZER_MOMENTUM,
+	OPTIMIZER_NESTEROV,
+	OPTIMIZER_ADAGRAD,
+	OPTIMIZER_ADAM
+};
+
+// State of an Optimizer, owned by the model and carried from step to
+// step by the gradient-descent loops: m and v hold padded_features
+// floats each, aligned like the weights (m: the velocity, AdaGrad's
+// sum of squares or Adam's first moment; v: Adam's second moment),
+// mb and vb the same for the bias, and t counts the steps taken for
+// Adam's bias correction.
+struct OptState {
+	Optimizer		kind;
+	float			beta1;
+	float			beta2;
+	float			eps;
+	float*			m;
+	float*			v;
+	float			mb;
+	float			vb;
+	int64_t			t;
+};
+
+// IRLS builds and factors a dense (n_features + 1)² Hessian, and keeps
+// one float copy of it per pool thread while accumulating.
+# define IRLS_MAX_FEATURES 1024
+
 // External function pointers for the selected kernel implementations
 extern float  (*dot_product)(const float* a, const float* b, uint64_t n);
-extern float* (*sigmoid)(const float* a, uint64_t n);
+extern void   (*axpy)(float a, const float* x, float* y, uint64_t n);
+extern void   (*scal)(float a, float* x, uint64_t n);
+extern void   (*axpby)(float a, const float* x, float b, float* y, uint64_t n);
+extern void   (*gemv)(const float* X, uint64_t n, uint64_t pf,
+                      const float* w, float b, float* out);
+extern void   (*sigmoid)(const float* a, float* out, uint64_t n);
+extern float  (*fused_grad)(const float* X, const int* Y, uint64_t n,
+                            uint64_t pf, const float* w, float b, float* dw);
+extern void   (*sigmoid_fast)(const float* a, float* out, uint64_t n);
+extern float  (*fused_grad_fast)(const float* X, const int* Y, uint64_t n,
+                                 uint64_t pf, const float* w, float b, float* dw);
+
+// Whole training / scoring routines of the selected tier, with its
+// kernels inlined (model_loops.hpp).  LogisticRegression goes through
+// these, so there is one indirect call per train or batch.
+struct TrainJob;
+struct ScoreJob;
+struct SparseTrainJob;
+struct SparseScoreJob;
+struct SoftmaxTrainJob;
+struct SoftmaxScoreJob;
+class ThreadPool;
+extern void   (*train_loop)(const TrainJob& job, ThreadPool& pool);
+extern double (*loss_grad_loop)(const TrainJob& job, ThreadPool& pool);
+extern double (*hessian_loop)(const TrainJob& job, ThreadPool& pool);
+extern double (*loss_loop)(const ScoreJob& job, const int* Y, double* sums,
+                           ThreadPool& pool);
+extern void   (*predict_loop)(const ScoreJob& job, ThreadPool& pool);
+extern void   (*classify_loop)(const ScoreJob& job, ThreadPool& pool);
+extern void   (*sparse_train_loop)(const SparseTrainJob& job, ThreadPool& pool);
+extern void   (*sparse_predict_loop)(const SparseScoreJob& job, ThreadPool& pool);
+extern void   (*sparse_classify_loop)(const SparseScoreJob& job, ThreadPool& pool);
+extern void   (*hogwild_loop)(const TrainJob& job, ThreadPool& pool);
+extern void   (*sparse_hogwild_loop)(const SparseTrainJob& job, ThreadPool& pool);
+extern void   (*softmax_train_loop)(const SoftmaxTrainJob& job, ThreadPool& pool);
+extern void   (*softmax_predict_loop)(const SoftmaxScoreJob& job, ThreadPool& pool);
+
+// The same loops over 16-bit rows (TrainJob / ScoreJob with Xh set).
+// fp16 is widened with F16C where the CPU has it; otherwise these come
+// from the SSE tier, which converts in software.
+extern void   (*half_train_loop)(const TrainJob& job, ThreadPool& pool);
+extern void   (*half_predict_loop)(const ScoreJob& job, ThreadPool& pool);
+extern void   (*half_classify_loop)(const ScoreJob& job, ThreadPool& pool);
+extern double (*half_loss_loop)(const ScoreJob& job, const int* Y, double* sums,
+                                ThreadPool& pool);
+
+// int8 scoring (QuantizedLogisticRegression): vpmaddubsw on AVX2 and
+// AVX-512BW, vpdpbusd where the CPU has AVX-512 VNNI, and the matching
+// float -> 7-bit code conversion (simd_fn.hpp).
+extern void   (*gemv_u8s8)(const uint8_t* Xq, uint64_t n, uint64_t ld,
+                           const int8_t* wq, uint64_t nq, float scale,
+                           float offset, float* out);
+extern void   (*quantize_u7)(const float* X, uint64_t n, uint64_t ld,
+                             const float* zp, const float* inv_s,
+                             uint64_t nf, uint8_t* Q, uint64_t ldq);
+
+// Best tier supported by both this CPU and this build.  The environment
+// variable LOGREG_MAX_ISA (scalar | sse | avx | avx2 | avx512) caps the
+// result, e.g. LOGREG_MAX_ISA=avx2 forces the AVX-512 tier off.
+KernelIsa	detect_kernel_isa();
+
+// Tier chosen by the last init_kernels() call, and the tier of the
+// 16-bit row loops (the same unless the CPU lacks F16C).
+KernelIsa	active_kernel_isa();
+KernelIsa	active_half_isa();
+
+// Name of the int8 kernel selected by init_kernels(): "scalar", "AVX2",
+// "AVX-512BW" or "AVX-512 VNNI".
+const char*	active_int8_isa_name();
 
 void	init_kernels();
-#endif
\ No newline at end of file
+#endif
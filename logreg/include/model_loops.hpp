@@ -0,0 +1,271 @@
+// model_loops.hpp file
+//
+// Algorithm-level routines of LogisticRegression, compiled once per
+// ISA.  Each *_loop_<isa> runs a whole training run or batch over the
+// padded matrix with that tier's kernels inlined into the loop body;
+// init_kernels() picks one of each through train_loop, predict_loop
+// and classify_loop (logreg_dispatcher.hpp), so the only remaining
+// indirection is a single call per train / predict_batch.
+
+#ifndef MODEL_LOOPS_H
+# define MODEL_LOOPS_H
+# include <stdint.h>
+# include "CsrMatrix.hpp"
+# include "logreg_dispatcher.hpp"
+# include "simd_fn.hpp"
+
+class ThreadPool;
+
+// Rows of X start ld floats apart and the kernels read the first cols
+// of each: the padded copy (ld = cols = padded_features) or the
+// caller's matrix in place (cols = n_features).  The half_*_loop
+// entry points read the 16-bit rows Xh instead (format `storage`,
+// ld and cols in elements) and ignore X.
+
+// Observer of the gradient-descent loops (EpochMonitor in
+// LogisticRegression.cpp).  When a job has one, each epoch also sums
+// the log-loss of its n rows at the weights it started from, and
+// after the reduction end_epoch gets that sum with the summed
+// gradient (dw in the first n_features floats, then db).  Returning
+// true stops the loop once the epoch's step is taken.
+class EpochHook {
+public:
+	virtual			~EpochHook() {}
+	virtual bool	end_epoch(double loss, const float* dw, float db, int n) = 0;
+};
+
+// Full-batch gradient descent over X.
+struct TrainJob {
+	const float*	X;                // [n_samples × ld]
+	const uint16_t*	Xh;               // [n_samples × ld], half loops only
+	FeatureStorage	storage;          // format of Xh
+	const int*		Y;                // [n_samples]
+	int				n_samples;
+	int				n_features;
+	int				ld;
+	int				cols;
+	int				block_rows;       // rows per parallel task
+	float*			grad;             // one slot per pool thread
+	int				slot;             // floats per slot (dw, then db)
+	int				acc;              // offset of db inside a slot
+	float*			weights;          // updated in place
+	float*			bias;             // updated in place
+	float			lr;
+	int				epochs;
+	bool			fast_sigmoid;
+	float*			hess;             // hessian_loop: one slot per pool thread,
+	int				ldh;              //   n_features + 1 rows ldh floats apart
+	EpochHook*		hook;             // null: no per-epoch loss
+	OptState*		opt;              // null: plain SGD steps
+	int				shards;           // hogwild_loop: concurrent threads
+};
+
+// Scoring of X: probabilities go to probs (predict_loop), labels to
+// labels (classify_loop).
+struct ScoreJob {
+	const float*	X;                // [n_samples × ld]
+	const uint16_t*	Xh;
+	FeatureStorage	storage;
+	int				n_samples;
+	int				ld;
+	int				cols;
+	int				block_rows;
+	const float*	weights;
+	float			bias;
+	bool			fast_sigmoid;
+	float*			probs;
+	int*			labels;
+};
+
+// The same over CSR rows: per epoch, time is linear in X.nnz() and
+// n_features, and nothing the size of a dense row is ever formed.
+struct SparseTrainJob {
+	CsrMatrix		X;
+	const int*		Y;                // [X.n_rows]
+	int				n_features;
+	int				block_rows;
+	float*			grad;
+	int				slot;
+	int				acc;
+	float*			weights;
+	float*			bias;
+	float			lr;
+	int				epochs;
+	bool			fast_sigmoid;
+	EpochHook*		hook;
+	OptState*		opt;
+	int				shards;
+};
+
+struct SparseScoreJob {
+	CsrMatrix		X;
+	int				block_rows;
+	const float*	weights;
+	float			bias;
+	bool			fast_sigmoid;
+	float*			probs;
+	int*			labels;
+};
+
+// Softmax regression (SoftmaxRegression): K weight rows ldw floats
+// apart and K biases.  Each thread gets a logits scratch of
+// n_classes × block_rows floats at logits + t * n_classes * block_rows
+// and a gradient slot holding dW (n_classes × ldw) then, at acc, db.
+struct SoftmaxTrainJob {
+	const float*	X;                // [n_samples × ld]
+	const int*		Y;                // [n_samples], in [0, n_classes)
+	int				n_samples;
+	int				ld;
+	int				cols;
+	int				n_classes;
+	int				block_rows;
+	float*			logits;
+	float*			grad;
+	int				slot;
+	int				acc;
+	float*			weights;          // [n_classes × ldw], updated in place
+	int				ldw;
+	float*			bias;             // [n_classes], updated in place
+	float			lr;
+	int				epochs;
+	bool			fast_exp;
+};
+
+// Probabilities go to probs [n_samples × n_classes] (row-major), or,
+// when probs is null, the most likely class to labels.
+struct SoftmaxScoreJob {
+	const float*	X;
+	int				n_samples;
+	int				ld;
+	int				cols;
+	int				n_classes;
+	int				block_rows;
+	float*			logits;
+	const float*	weights;
+	int				ldw;
+	const float*	bias;
+	bool			fast_exp;
+	float*			probs;
+	int*			labels;
+};
+
+void	train_loop_scalar(const TrainJob& job, ThreadPool& pool);
+void	train_loop_sse(const TrainJob& job, ThreadPool& pool);
+void	train_loop_avx(const TrainJob& job, ThreadPool& pool);
+void	train_loop_avx2_fma(const TrainJob& job, ThreadPool& pool);
+
+// One sweep over X at the current weights for the solvers of
+// solvers.hpp: the gradient sums reduced into slot 0 of grad (dw, then
+// db at acc) and the summed log-loss as the result; job.epochs and
+// job.lr are ignored.  hessian_loop also reduces the curvature
+// Σ p(1-p) [x 1][x 1]ᵀ (upper triangle, bias row last) into the first
+// hess slot.  Per thread, the loss sum is kept as a double in the grad
+// slot, at acc + 2.
+double	loss_grad_loop_scalar(const TrainJob& job, ThreadPool& pool);
+double	loss_grad_loop_sse(const TrainJob& job, ThreadPool& pool);
+double	loss_grad_loop_avx(const TrainJob& job, ThreadPool& pool);
+double	loss_grad_loop_avx2_fma(const TrainJob& job, ThreadPool& pool);
+
+double	hessian_loop_scalar(const TrainJob& job, ThreadPool& pool);
+double	hessian_loop_sse(const TrainJob& job, ThreadPool& pool);
+double	hessian_loop_avx(const TrainJob& job, ThreadPool& pool);
+double	hessian_loop_avx2_fma(const TrainJob& job, ThreadPool& pool);
+
+// Summed log-loss of the rows of a ScoreJob against the labels Y
+// (probs and labels are unused); sums holds 8 doubles per pool
+// thread.  half_loss_loop reads the 16-bit rows.
+double	loss_loop_scalar(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+double	loss_loop_sse(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+double	loss_loop_avx(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+double	loss_loop_avx2_fma(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+
+double	half_loss_loop_scalar(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+double	half_loss_loop_sse(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+double	half_loss_loop_avx(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+double	half_loss_loop_avx2_fma(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+
+// Hogwild!: job.shards pool threads (at most pool.size()) each run
+// job.epochs SGD passes over their own contiguous shard of the rows,
+// stepping lr (p - y) x per row straight into the shared weights and
+// bias without locks; grad, slot, hook and opt are unused.
+void	hogwild_loop_scalar(const TrainJob& job, ThreadPool& pool);
+void	hogwild_loop_sse(const TrainJob& job, ThreadPool& pool);
+void	hogwild_loop_avx(const TrainJob& job, ThreadPool& pool);
+void	hogwild_loop_avx2_fma(const TrainJob& job, ThreadPool& pool);
+
+void	sparse_hogwild_loop_scalar(const SparseTrainJob& job, ThreadPool& pool);
+void	sparse_hogwild_loop_sse(const SparseTrainJob& job, ThreadPool& pool);
+void	sparse_hogwild_loop_avx(const SparseTrainJob& job, ThreadPool& pool);
+void	sparse_hogwild_loop_avx2_fma(const SparseTrainJob& job, ThreadPool& pool);
+
+void	predict_loop_scalar(const ScoreJob& job, ThreadPool& pool);
+void	predict_loop_sse(const ScoreJob& job, ThreadPool& pool);
+void	predict_loop_avx(const ScoreJob& job, ThreadPool& pool);
+void	predict_loop_avx2_fma(const ScoreJob& job, ThreadPool& pool);
+
+void	classify_loop_scalar(const ScoreJob& job, ThreadPool& pool);
+void	classify_loop_sse(const ScoreJob& job, ThreadPool& pool);
+void	classify_loop_avx(const ScoreJob& job, ThreadPool& pool);
+void	classify_loop_avx2_fma(const ScoreJob& job, ThreadPool& pool);
+
+void	sparse_train_loop_scalar(const SparseTrainJob& job, ThreadPool& pool);
+void	sparse_train_loop_sse(const SparseTrainJob& job, ThreadPool& pool);
+void	sparse_train_loop_avx(const SparseTrainJob& job, ThreadPool& pool);
+void	sparse_train_loop_avx2_fma(const SparseTrainJob& job, ThreadPool& pool);
+
+void	sparse_predict_loop_scalar(const SparseScoreJob& job, ThreadPool& pool);
+void	sparse_predict_loop_sse(const SparseScoreJob& job, ThreadPool& pool);
+void	sparse_predict_loop_avx(const SparseScoreJob& job, ThreadPool& pool);
+void	sparse_predict_loop_avx2_fma(const SparseScoreJob& job, ThreadPool& pool);
+
+void	sparse_classify_loop_scalar(const SparseScoreJob& job, ThreadPool& pool);
+void	sparse_classify_loop_sse(const SparseScoreJob& job, ThreadPool& pool);
+void	sparse_classify_loop_avx(const SparseScoreJob& job, ThreadPool& pool);
+void	sparse_classify_loop_avx2_fma(const SparseScoreJob& job, ThreadPool& pool);
+
+void	softmax_train_loop_scalar(const SoftmaxTrainJob& job, ThreadPool& pool);
+void	softmax_train_loop_sse(const SoftmaxTrainJob& job, ThreadPool& pool);
+void	softmax_train_loop_avx(const SoftmaxTrainJob& job, ThreadPool& pool);
+void	softmax_train_loop_avx2_fma(const SoftmaxTrainJob& job, ThreadPool& pool);
+
+void	softmax_predict_loop_scalar(const SoftmaxScoreJob& job, ThreadPool& pool);
+void	softmax_predict_loop_sse(const SoftmaxScoreJob& job, ThreadPool& pool);
+void	softmax_predict_loop_avx(const SoftmaxScoreJob& job, ThreadPool& pool);
+void	softmax_predict_loop_avx2_fma(const SoftmaxScoreJob& job, ThreadPool& pool);
+
+void	half_train_loop_scalar(const TrainJob& job, ThreadPool& pool);
+void	half_train_loop_sse(const TrainJob& job, ThreadPool& pool);
+void	half_train_loop_avx(const TrainJob& job, ThreadPool& pool);
+void	half_train_loop_avx2_fma(const TrainJob& job, ThreadPool& pool);
+
+void	half_predict_loop_scalar(const ScoreJob& job, ThreadPool& pool);
+void	half_predict_loop_sse(const ScoreJob& job, ThreadPool& pool);
+void	half_predict_loop_avx(const ScoreJob& job, ThreadPool& pool);
+void	half_predict_loop_avx2_fma(const ScoreJob& job, ThreadPool& pool);
+
+void	half_classify_loop_scalar(const ScoreJob& job, ThreadPool& pool);
+void	half_classify_loop_sse(const ScoreJob& job, ThreadPool& pool);
+void	half_classify_loop_avx(const ScoreJob& job, ThreadPool& pool);
+void	half_classify_loop_avx2_fma(const ScoreJob& job, ThreadPool& pool);
+
+# if LOGREG_HAVE_AVX512
+void	train_loop_avx512(const TrainJob& job, ThreadPool& pool);
+double	loss_grad_loop_avx512(const TrainJob& job, ThreadPool& pool);
+double	hessian_loop_avx512(const TrainJob& job, ThreadPool& pool);
+double	loss_loop_avx512(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+double	half_loss_loop_avx512(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool);
+void	hogwild_loop_avx512(const TrainJob& job, ThreadPool& pool);
+void	sparse_hogwild_loop_avx512(const SparseTrainJob& job, ThreadPool& pool);
+void	predict_loop_avx512(const ScoreJob& job, ThreadPool& pool);
+void	classify_loop_avx512(const ScoreJob& job, ThreadPool& pool);
+void	sparse_train_loop_avx512(const SparseTrainJob& job, ThreadPool& pool);
+void	sparse_predict_loop_avx512(const SparseScoreJob& job, ThreadPool& pool);
+void	sparse_classify_loop_avx512(const SparseScoreJob& job, ThreadPool& pool);
+void	softmax_train_loop_avx512(const SoftmaxTrainJob& job, ThreadPool& pool);
+void	softmax_predict_loop_avx512(const SoftmaxScoreJob& job, ThreadPool& pool);
+void	half_train_loop_avx512(const TrainJob& job, ThreadPool& pool);
+void	half_predict_loop_avx512(const ScoreJob& job, ThreadPool& pool);
+void	half_classify_loop_avx512(const ScoreJob& job, ThreadPool& pool);
+# endif
+
+#endif
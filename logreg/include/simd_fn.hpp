@@ -6,19 +6,170 @@
 # include <immintrin.h>
 # include <cmath>
 
+// AVX-512 kernels are only built when the compiler targets AVX-512F
+// (the build uses -march=native, or pass -mavx512f to run them under
+// Intel SDE).  The dispatcher never selects them otherwise.
+# if defined(__AVX512F__)
+#  define LOGREG_HAVE_AVX512 1
+# else
+#  define LOGREG_HAVE_AVX512 0
+# endif
+
+// The AVX-512 int8 kernels additionally need AVX-512BW (byte / word
+// lanes) and, for vpdpbusd, AVX-512 VNNI.
+# if defined(__AVX512BW__)
+#  define LOGREG_HAVE_AVX512BW 1
+# else
+#  define LOGREG_HAVE_AVX512BW 0
+# endif
+# if defined(__AVX512BW__) && defined(__AVX512VNNI__)
+#  define LOGREG_HAVE_AVX512VNNI 1
+# else
+#  define LOGREG_HAVE_AVX512VNNI 0
+# endif
+
 float* aligned_alloc_float(size_t n, size_t alignment);
 void aligned_free_float(void* ptr);
 
+// Number of aligned_alloc_float calls since program start.  Every heap
+// buffer in the library goes through it, so a stable count across a
+// call proves that call allocated nothing.
+uint64_t aligned_alloc_count();
+
 // Dot product functions
 float	dot_scalar(const float* a, const float* b, uint64_t n);
 float	dot_sse(const float* a, const float* b, uint64_t n);
 float	dot_avx(const float* a, const float* b, uint64_t n);
 float	dot_avx2_fma(const float* a, const float* b, uint64_t n);
+# if LOGREG_HAVE_AVX512
+float	dot_avx512(const float* a, const float* b, uint64_t n);
+# endif
+
+// BLAS-1 functions over n floats of any alignment:
+//   axpy  : y = a * x + y
+//   scal  : x = a * x
+//   axpby : y = a * x + b * y
+void	axpy_scalar(float a, const float* x, float* y, uint64_t n);
+void	axpy_sse(float a, const float* x, float* y, uint64_t n);
+void	axpy_avx(float a, const float* x, float* y, uint64_t n);
+void	axpy_avx2_fma(float a, const float* x, float* y, uint64_t n);
+# if LOGREG_HAVE_AVX512
+void	axpy_avx512(float a, const float* x, float* y, uint64_t n);
+# endif
+
+void	scal_scalar(float a, float* x, uint64_t n);
+void	scal_sse(float a, float* x, uint64_t n);
+void	scal_avx(float a, float* x, uint64_t n);
+void	scal_avx2_fma(float a, float* x, uint64_t n);
+# if LOGREG_HAVE_AVX512
+void	scal_avx512(float a, float* x, uint64_t n);
+# endif
+
+void	axpby_scalar(float a, const float* x, float b, float* y, uint64_t n);
+void	axpby_sse(float a, const float* x, float b, float* y, uint64_t n);
+void	axpby_avx(float a, const float* x, float b, float* y, uint64_t n);
+void	axpby_avx2_fma(float a, const float* x, float b, float* y, uint64_t n);
+# if LOGREG_HAVE_AVX512
+void	axpby_avx512(float a, const float* x, float b, float* y, uint64_t n);
+# endif
+
+// Matrix-vector functions: out[i] = <X_i, w> + b for n padded rows
+void	gemv_scalar(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out);
+void	gemv_sse(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out);
+void	gemv_avx(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out);
+void	gemv_avx2_fma(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out);
+# if LOGREG_HAVE_AVX512
+void	gemv_avx512(const float* X, uint64_t n, uint64_t pf,
+			const float* w, float b, float* out);
+# endif
+
+// Sigmoid functions: out[i] = sigmoid(a[i]); out may alias a
+void	sigmoid_scalar(const float* a, float* out, uint64_t n);
+void	sigmoid_sse(const float* a, float* out, uint64_t n);
+void	sigmoid_avx(const float* a, float* out, uint64_t n);
+void	sigmoid_avx2_fma(const float* a, float* out, uint64_t n);
+# if LOGREG_HAVE_AVX512
+void	sigmoid_avx512(const float* a, float* out, uint64_t n);
+# endif
+
+// Fast-tier sigmoid: lower-degree exp polynomial and an rcp estimate
+// with one Newton step instead of a division (see simd_math.hpp)
+void	sigmoid_fast_scalar(const float* a, float* out, uint64_t n);
+void	sigmoid_fast_sse(const float* a, float* out, uint64_t n);
+void	sigmoid_fast_avx(const float* a, float* out, uint64_t n);
+void	sigmoid_fast_avx2_fma(const float* a, float* out, uint64_t n);
+# if LOGREG_HAVE_AVX512
+void	sigmoid_fast_avx512(const float* a, float* out, uint64_t n);
+# endif
+
+// Fused gradient functions: one pass over n padded rows of X computing
+// sigmoid(<w, x_i> + b) - y_i, accumulating it into dw (length pf) and
+// returning its sum (the bias gradient).
+float	fused_grad_scalar(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+float	fused_grad_sse(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+float	fused_grad_avx(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+float	fused_grad_avx2_fma(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+# if LOGREG_HAVE_AVX512
+float	fused_grad_avx512(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+# endif
+
+// Same, with the fast-tier sigmoid
+float	fused_grad_fast_scalar(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+float	fused_grad_fast_sse(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+float	fused_grad_fast_avx(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+float	fused_grad_fast_avx2_fma(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+# if LOGREG_HAVE_AVX512
+float	fused_grad_fast_avx512(const float* X, const int* Y, uint64_t n,
+			uint64_t pf, const float* w, float b, float* dw);
+# endif
+
+// Quantized matrix-vector functions: out[i] = scale * <Xq_i, wq> +
+// offset for n rows of 7-bit activations (ld bytes apart, nq read)
+// and signed 8-bit weights zero-padded to a multiple of 64 bytes.
+// The int32 dot products are exact, so all tiers agree bit for bit.
+void	gemv_u8s8_scalar(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out);
+void	gemv_u8s8_avx2(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out);
+# if LOGREG_HAVE_AVX512BW
+void	gemv_u8s8_avx512(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out);
+# endif
+# if LOGREG_HAVE_AVX512VNNI
+void	gemv_u8s8_avx512_vnni(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out);
+# endif
 
-// Exp functions
-float*	sigmoid_scalar(const float* a, uint64_t n);
-float*	sigmoid_sse(const float* a, uint64_t n);
-float*	sigmoid_avx(const float* a, uint64_t n);
-float*	sigmoid_avx2_fma(const float* a, uint64_t n);
+// Quantization to 7-bit codes: Q_i[j] = clamp(round((X_i[j] - zp[j]) *
+// inv_s[j]), 0, 127) for n rows of nf floats (ld floats / ldq bytes
+// apart); zp and inv_s zero-padded to a multiple of 16.
+void	quantize_u7_scalar(const float* X, uint64_t n, uint64_t ld,
+			const float* zp, const float* inv_s, uint64_t nf,
+			uint8_t* Q, uint64_t ldq);
+void	quantize_u7_avx2(const float* X, uint64_t n, uint64_t ld,
+			const float* zp, const float* inv_s, uint64_t nf,
+			uint8_t* Q, uint64_t ldq);
+# if LOGREG_HAVE_AVX512BW
+void	quantize_u7_avx512(const float* X, uint64_t n, uint64_t ld,
+			const float* zp, const float* inv_s, uint64_t nf,
+			uint8_t* Q, uint64_t ldq);
+# endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,381 @@
+// simd_math.hpp file
+//
+// Inline vector building blocks shared by the SIMD kernels:
+// range-reduced exp(), sigmoid() and log-loss on whole registers,
+// single-row / 4-row blocked dot products over padded rows (float32
+// or 16-bit), a gathered dot product over sparse rows and a
+// multi-accumulator dot product.  Each is written once as a template over the vector traits
+// of simd_traits.hpp (T = IsaSse, IsaAvx, ...).  Every translation
+// unit that includes this gets its own inlined copy, so the fused
+// kernels can keep intermediate values in registers.
+
+#ifndef SIMD_MATH_H
+# define SIMD_MATH_H
+# include "simd_traits.hpp"
+
+// ---- exp / sigmoid constants ----
+//
+// Accurate tier: Cody-Waite reduction v = n*ln2 + r (ln2 split so that
+// n*LN2_HI is exact) and the Cephes expf polynomial
+//     exp(r) ≈ 1 + r + r^2 * P(r),  deg P = 5, minimax on |r| <= ln2/2
+// (about 1 ulp).  The argument is clamped to [EXP_ARG_MIN, EXP_ARG_MAX]
+// so the (n + 127) << 23 exponent trick can never wrap; sigmoid(x)
+// then saturates at 1 above x = 87 and at sigmoid(-88) ≈ 6e-39 below.
+//
+// Fast tier: 2^t with t = v*log2(e) = n + f, |f| <= 1/2, and a degree-4
+// minimax polynomial for 2^f (relative error 2.6e-6), followed by an
+// rcp estimate refined with one Newton step instead of a division.
+static const float	EXP_ARG_MAX  = 88.0f;
+static const float	EXP_ARG_MIN  = -87.0f;
+static const float	EXP2_ARG_MAX = 126.0f;
+static const float	EXP2_ARG_MIN = -126.0f;
+static const float	EXP_LOG2E    = 1.44269504088896341f;
+static const float	EXP_LN2_HI   = 0.693359375f;
+static const float	EXP_LN2_LO   = -2.12194440e-4f;
+
+static const float	EXP_P0 = 1.9875691500e-4f;
+static const float	EXP_P1 = 1.3981999507e-3f;
+static const float	EXP_P2 = 8.3334519073e-3f;
+static const float	EXP_P3 = 4.1665795894e-2f;
+static const float	EXP_P4 = 1.6666665459e-1f;
+static const float	EXP_P5 = 5.0000001201e-1f;
+
+static const float	EXP2_F0 = 9.999992614e-1f;
+static const float	EXP2_F1 = 6.931218147e-1f;
+static const float	EXP2_F2 = 2.402474483e-1f;
+static const float	EXP2_F3 = 5.591786032e-2f;
+static const float	EXP2_F4 = 9.570101908e-3f;
+
+// ============================================================
+//  exp / sigmoid
+// ============================================================
+
+// exp(r) ≈ 1 + r + r^2 * P(r) for |r| <= ln2/2 (Horner on P)
+template <class T>
+static inline typename T::vec	exp_poly(typename T::vec r)
+{
+	typename T::vec p = T::set1(EXP_P0);
+	p = T::fmadd(p, r, T::set1(EXP_P1));
+	p = T::fmadd(p, r, T::set1(EXP_P2));
+	p = T::fmadd(p, r, T::set1(EXP_P3));
+	p = T::fmadd(p, r, T::set1(EXP_P4));
+	p = T::fmadd(p, r, T::set1(EXP_P5));
+
+	p = T::fmadd(p, T::mul(r, r), r);
+	return (T::add(p, T::set1(1.0f)));
+}
+
+template <class T>
+static inline typename T::vec	vector_exp(typename T::vec v)
+{
+	v = T::min(T::max(v, T::set1(EXP_ARG_MIN)), T::set1(EXP_ARG_MAX));
+
+	typename T::vec n = T::round(T::mul(v, T::set1(EXP_LOG2E)));
+
+	// r = v - n * ln2  (two steps, n * LN2_HI is exact)
+	typename T::vec r = T::fnmadd(n, T::set1(EXP_LN2_HI), v);
+	r = T::fnmadd(n, T::set1(EXP_LN2_LO), r);
+
+	// exp(v) = exp(r) * 2^n
+	return (T::pow2n(exp_poly<T>(r), n));
+}
+
+// 2^f for |f| <= 1/2, degree-4 minimax
+template <class T>
+static inline typename T::vec	exp2_poly_fast(typename T::vec f)
+{
+	typename T::vec p = T::set1(EXP2_F4);
+	p = T::fmadd(p, f, T::set1(EXP2_F3));
+	p = T::fmadd(p, f, T::set1(EXP2_F2));
+	p = T::fmadd(p, f, T::set1(EXP2_F1));
+	p = T::fmadd(p, f, T::set1(EXP2_F0));
+	return (p);
+}
+
+template <class T>
+static inline typename T::vec	vector_exp_fast(typename T::vec v)
+{
+	typename T::vec t = T::mul(v, T::set1(EXP_LOG2E));
+	t = T::min(T::max(t, T::set1(EXP2_ARG_MIN)), T::set1(EXP2_ARG_MAX));
+
+	typename T::vec n = T::round(t);
+	return (T::pow2n(exp2_poly_fast<T>(T::sub(t, n)), n));
+}
+
+// 1 / d from the rcp estimate and one Newton step: r + r (1 - d r)
+template <class T>
+static inline typename T::vec	rcp_nr(typename T::vec d)
+{
+	typename T::vec r = T::rcp(d);
+	return (T::fmadd(r, T::fnmadd(d, r, T::set1(1.0f)), r));
+}
+
+// sigmoid(v) = 1 / (1 + exp(-v)); FAST selects the fast tier.
+template <class T, bool FAST>
+static inline typename T::vec	vect_sigmoid(typename T::vec v)
+{
+	const typename T::vec	one = T::set1(1.0f);
+	const typename T::vec	neg_v = T::sub(T::zero(), v);
+
+	if (FAST)
+		return (rcp_nr<T>(T::add(one, vector_exp_fast<T>(neg_v))));
+	return (T::div(one, T::add(one, vector_exp<T>(neg_v))));
+}
+
+// log(1 + u) for 0 <= u <= 1 as 2 atanh(s), s = u / (2 + u) <= 1/3:
+// the odd series of atanh to s^13 leaves < 1e-8 relative error, and
+// needs nothing beyond the arithmetic every tier has.
+template <class T>
+static inline typename T::vec	log1p_unit(typename T::vec u)
+{
+	const typename T::vec	s  = T::div(u, T::add(u, T::set1(2.0f)));
+	const typename T::vec	s2 = T::mul(s, s);
+
+	typename T::vec p = T::set1(1.0f / 13.0f);
+	p = T::fmadd(p, s2, T::set1(1.0f / 11.0f));
+	p = T::fmadd(p, s2, T::set1(1.0f / 9.0f));
+	p = T::fmadd(p, s2, T::set1(1.0f / 7.0f));
+	p = T::fmadd(p, s2, T::set1(1.0f / 5.0f));
+	p = T::fmadd(p, s2, T::set1(1.0f / 3.0f));
+	p = T::fmadd(p, s2, T::set1(1.0f));
+	return (T::mul(T::add(s, s), p));
+}
+
+// Log-loss of logit z for label y in {0, 1}:
+//     -[y log p + (1 - y) log(1 - p)] = max(z, 0) - y z + log(1 + exp(-|z|))
+// which neither overflows nor loses precision for large |z|.
+template <class T>
+static inline typename T::vec	vect_logloss(typename T::vec z, typename T::vec y)
+{
+	const typename T::vec	neg_abs = T::min(z, T::sub(T::zero(), z));
+	const typename T::vec	lin     = T::fnmadd(y, z, T::max(z, T::zero()));
+
+	return (T::add(lin, log1p_unit<T>(vector_exp<T>(neg_abs))));
+}
+
+// ============================================================
+//  Row formats
+//  Element type of the rows of X and how a vector of them is read:
+//  float32 (the caller's matrix or the padded copy), or one of the
+//  16-bit formats of half_float.hpp, widened to float as they are
+//  loaded so w, the products and the sums stay float32.  The row
+//  kernels take the format as a template argument defaulting to
+//  RowsF32.
+// ============================================================
+
+struct RowsF32 {
+	typedef float	elem;
+
+	template <class T>
+	static inline typename T::vec	load(const float* p) { return (T::loadu(p)); }
+	template <class T>
+	static inline typename T::vec	load_partial(const float* p, uint64_t n)
+	{
+		return (T::load_partial(p, n));
+	}
+	static inline float	get(const float* p) { return (*p); }
+};
+
+struct RowsF16 {
+	typedef uint16_t	elem;
+
+	template <class T>
+	static inline typename T::vec	load(const uint16_t* p) { return (T::load_f16(p)); }
+	template <class T>
+	static inline typename T::vec	load_partial(const uint16_t* p, uint64_t n)
+	{
+		return (T::load_f16_partial(p, n));
+	}
+	static inline float	get(const uint16_t* p) { return (half_to_float(*p)); }
+};
+
+struct RowsBf16 {
+	typedef uint16_t	elem;
+
+	template <class T>
+	static inline typename T::vec	load(const uint16_t* p) { return (T::load_bf16(p)); }
+	template <class T>
+	static inline typename T::vec	load_partial(const uint16_t* p, uint64_t n)
+	{
+		return (T::load_bf16_partial(p, n));
+	}
+	static inline float	get(const uint16_t* p) { return (bf16_to_float(*p)); }
+};
+
+// ============================================================
+//  Row dot products
+//  x is read with unaligned loads and the last partial vector is a
+//  masked (SSE: zero-filled) load, so rows may sit anywhere and n
+//  need not be a multiple of the vector width.  w is the model's
+//  padded weight vector (aligned, zero past n_features).  On the
+//  padded layout (n = pf, rows 32-byte aligned) only the 512-bit
+//  tier ever takes the tail step.
+// ============================================================
+
+template <class T, class R = RowsF32>
+static inline float	dot_row(const typename R::elem* x, const float* w, uint64_t n)
+{
+	typename T::vec	acc = T::zero();
+	uint64_t		j{0};
+
+	for (; j + T::W <= n; j += T::W)
+		acc = T::fmadd(R::template load<T>(x + j), T::load(w + j), acc);
+	if (j < n)
+		acc = T::fmadd(R::template load_partial<T>(x + j, n - j),
+		               T::load_partial(w + j, n - j), acc);
+	return (T::hsum(acc));
+}
+
+// Dot products of 4 consecutive rows (ld elements apart, n used) with
+// w.  Each weight vector is loaded once and shared by the 4 rows, the
+// 4 accumulators are independent chains, and one combined reduction
+// produces all four sums (lane r = <row r, w>).
+template <class T, class R = RowsF32>
+static inline __m128	dot4_rows(const typename R::elem* x, uint64_t ld, const float* w,
+			uint64_t n)
+{
+	typename T::vec	acc0 = T::zero();
+	typename T::vec	acc1 = T::zero();
+	typename T::vec	acc2 = T::zero();
+	typename T::vec	acc3 = T::zero();
+	uint64_t		j{0};
+
+	for (; j + T::W <= n; j += T::W) {
+		typename T::vec wv = T::load(w + j);
+		acc0 = T::fmadd(R::template load<T>(x + j), wv, acc0);
+		acc1 = T::fmadd(R::template load<T>(x + ld + j), wv, acc1);
+		acc2 = T::fmadd(R::template load<T>(x + 2 * ld + j), wv, acc2);
+		acc3 = T::fmadd(R::template load<T>(x + 3 * ld + j), wv, acc3);
+	}
+	if (j < n) {
+		const uint64_t	k = n - j;
+		typename T::vec	wv = T::load_partial(w + j, k);
+		acc0 = T::fmadd(R::template load_partial<T>(x + j, k), wv, acc0);
+		acc1 = T::fmadd(R::template load_partial<T>(x + ld + j, k), wv, acc1);
+		acc2 = T::fmadd(R::template load_partial<T>(x + 2 * ld + j, k), wv, acc2);
+		acc3 = T::fmadd(R::template load_partial<T>(x + 3 * ld + j, k), wv, acc3);
+	}
+	return (T::hsum4(acc0, acc1, acc2, acc3));
+}
+
+// 4 rows × 2 weight vectors: lane r of z0 is <row r, w0>, of z1
+// <row r, w1>.  The register tile of the softmax GEMM: 8 independent
+// accumulators, and each step's 4 row loads and 2 weight loads feed 8
+// multiply-adds instead of the 5 loads per 4 of dot4_rows.
+template <class T>
+static inline void	dot4x2_rows(const float* x, uint64_t ld, const float* w0,
+			const float* w1, uint64_t n, __m128& z0, __m128& z1)
+{
+	typename T::vec	a00 = T::zero(), a01 = T::zero();
+	typename T::vec	a10 = T::zero(), a11 = T::zero();
+	typename T::vec	a20 = T::zero(), a21 = T::zero();
+	typename T::vec	a30 = T::zero(), a31 = T::zero();
+	uint64_t		j{0};
+
+	for (; j + T::W <= n; j += T::W) {
+		const typename T::vec	v0 = T::load(w0 + j);
+		const typename T::vec	v1 = T::load(w1 + j);
+		typename T::vec			xr;
+
+		xr = T::loadu(x + j);          a00 = T::fmadd(xr, v0, a00); a01 = T::fmadd(xr, v1, a01);
+		xr = T::loadu(x + ld + j);     a10 = T::fmadd(xr, v0, a10); a11 = T::fmadd(xr, v1, a11);
+		xr = T::loadu(x + 2 * ld + j); a20 = T::fmadd(xr, v0, a20); a21 = T::fmadd(xr, v1, a21);
+		xr = T::loadu(x + 3 * ld + j); a30 = T::fmadd(xr, v0, a30); a31 = T::fmadd(xr, v1, a31);
+	}
+	if (j < n) {
+		const uint64_t			k  = n - j;
+		const typename T::vec	v0 = T::load_partial(w0 + j, k);
+		const typename T::vec	v1 = T::load_partial(w1 + j, k);
+		typename T::vec			xr;
+
+		xr = T::load_partial(x + j, k);          a00 = T::fmadd(xr, v0, a00); a01 = T::fmadd(xr, v1, a01);
+		xr = T::load_partial(x + ld + j, k);     a10 = T::fmadd(xr, v0, a10); a11 = T::fmadd(xr, v1, a11);
+		xr = T::load_partial(x + 2 * ld + j, k); a20 = T::fmadd(xr, v0, a20); a21 = T::fmadd(xr, v1, a21);
+		xr = T::load_partial(x + 3 * ld + j, k); a30 = T::fmadd(xr, v0, a30); a31 = T::fmadd(xr, v1, a31);
+	}
+	z0 = T::hsum4(a00, a10, a20, a30);
+	z1 = T::hsum4(a01, a11, a21, a31);
+}
+
+// ============================================================
+//  Sparse row dot product
+//  <x, w> for a CSR row: nnz values and the column of each.  Where
+//  the tier has a gather instruction the weights of W non-zeros are
+//  fetched at once and multiplied against W contiguous values, with
+//  a masked gather for the last partial group; rows shorter than one
+//  vector, and tiers that would only emulate the gather, use the
+//  scalar loop.  Columns may repeat (their terms are summed) and
+//  need not be sorted.
+// ============================================================
+
+template <class T>
+static inline float	sparse_dot(const float* val, const int32_t* idx, uint64_t nnz,
+			const float* w)
+{
+	if (!T::GATHER || nnz < T::W) {
+		float	z{0};
+
+		for (uint64_t k = 0; k < nnz; ++k)
+			z += val[k] * w[idx[k]];
+		return (z);
+	}
+
+	typename T::vec	acc = T::zero();
+	uint64_t		k{0};
+
+	for (; k + T::W <= nnz; k += T::W)
+		acc = T::fmadd(T::loadu(val + k), T::gather(w, idx + k), acc);
+	if (k < nnz)
+		acc = T::fmadd(T::load_partial(val + k, nnz - k),
+		               T::gather_partial(w, idx + k, nnz - k), acc);
+	return (T::hsum(acc));
+}
+
+// ============================================================
+//  dot_acc : <a, b> over n floats with ACC independent accumulators
+//
+//  One accumulator serialises every multiply-add behind the previous
+//  one, so the loop runs at the add latency (3-4 cycles) rather than
+//  the 1-2 FMAs per cycle the core can issue.  ACC registers in
+//  flight hide that latency; they are combined pairwise at the end.
+//  Neither pointer needs any alignment and nothing past a + n or
+//  b + n is read: the last partial vector is a masked (or, on SSE,
+//  zero-filled) load.
+// ============================================================
+
+template <class T, int ACC>
+static inline float	dot_acc(const float* a, const float* b, uint64_t n)
+{
+	static_assert(ACC > 0 && (ACC & (ACC - 1)) == 0, "ACC must be a power of two");
+
+	typename T::vec	acc[ACC];
+	uint64_t		i{0};
+
+	for (int k = 0; k < ACC; ++k)
+		acc[k] = T::zero();
+	for (; i + ACC * T::W <= n; i += ACC * T::W)
+		for (int k = 0; k < ACC; ++k)
+			acc[k] = T::fmadd(T::loadu(a + i + k * T::W), T::loadu(b + i + k * T::W), acc[k]);
+	for (; i + T::W <= n; i += T::W)
+		acc[0] = T::fmadd(T::loadu(a + i), T::loadu(b + i), acc[0]);
+	if (i < n)
+		acc[ACC - 1] = T::fmadd(T::load_partial(a + i, n - i),
+		                        T::load_partial(b + i, n - i), acc[ACC - 1]);
+
+	for (int step = 1; step < ACC; step *= 2)
+		for (int k = 0; k + step < ACC; k += 2 * step)
+			acc[k] = T::add(acc[k], acc[k + step]);
+	return (T::hsum(acc[0]));
+}
+
+// Online scoring: x is caller memory of exactly n floats with any
+// alignment, w a padded model row.  Selected at compile time (the
+// build targets the host), so the single-sample path is a direct,
+// inlinable call rather than a jump through the dispatcher; two
+// accumulators suit the short rows of online requests.
+static inline float	dotu_native(const float* x, const float* w, uint64_t n)
+{
+	return (dot_acc<IsaNative, 2>(x, w, n));
+}
+
+#endif // SIMD_MATH_H
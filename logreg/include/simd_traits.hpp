@@ -0,0 +1,571 @@
+// simd_traits.hpp file
+//
+// Vector traits: one struct per ISA describing its register type and
+// the handful of operations the kernels are written in (loads and
+// stores, arithmetic, fused multiply-add, rounding, 2^n scaling and
+// horizontal reductions).  simd_math.hpp and isa_kernels.hpp build
+// every exp / sigmoid / dot / gemv / gradient kernel once as a
+// template over these structs, so supporting a new ISA means adding
+// one struct here.
+//
+// Conventions shared by every struct:
+//     vec                      register type
+//     W                        floats per register
+//     ACC                      accumulators used by dot_acc by default
+//     load / store             p aligned to min(32, 4 W) bytes
+//     loadu / storeu           any alignment
+//     load_partial(p, n)       lanes [0, n) from p, the rest zero
+//     store_partial(p, v, n)   lanes [0, n) to p; n < W, nothing past
+//                              p + n is read or written
+//     fmadd(a, b, c)           a * b + c
+//     fnmadd(a, b, c)          c - a * b
+//     round(v)                 nearest integer, ties to even
+//     pow2n(p, n)              p * 2^n for integral n in [-126, 127]
+//     rcp(v)                   reciprocal estimate (12 or 14 bits)
+//     sqrt(v)                  correctly rounded square root
+//     labels(y)                W int labels converted to float
+//     hsum(v)                  sum of the lanes
+//     hsum4(a0, a1, a2, a3)    lane r = hsum(a_r)
+//     from4(q)                 W / 4 __m128 concatenated
+//     gather(p, idx)           lane k = p[idx[k]], idx W int32
+//     gather_partial(p, idx, n)  lanes [0, n) gathered, the rest zero;
+//                              idx[n..] is not read
+//     GATHER                   true when gather is one instruction
+//                              rather than W scalar loads
+//     load_f16(p)              W IEEE fp16 values (half_float.hpp)
+//                              widened to float, any alignment
+//     load_bf16(p)             W bfloat16 values widened to float
+//     load_f16_partial(p, n), load_bf16_partial(p, n)
+//                              lanes [0, n), the rest zero; nothing
+//                              past p + n is read
+//     F16C                     true when load_f16 is one conversion
+//                              instruction rather than W scalar ones
+//
+// SSE and AVX have no fused multiply-add: their fmadd / fnmadd are a
+// separate multiply and add, which keeps the results of those tiers
+// identical to the hand-written kernels they replace.
+
+#ifndef SIMD_TRAITS_H
+# define SIMD_TRAITS_H
+# include <stdint.h>
+# include <xmmintrin.h>
+# include <emmintrin.h>
+# include <immintrin.h>
+# include "simd_fn.hpp"
+# include "half_float.hpp"
+
+// The scalar tier has no vector traits: Kernels<IsaScalar> in
+// isa_kernels.hpp is the hand-written libm reference.
+struct IsaScalar {};
+
+// The first n (< W) 16-bit values of p in a zero-filled buffer of W,
+// for the partial loads of the 16-bit formats.
+template <uint64_t W>
+static inline void	copy_u16_partial(uint16_t (&buf)[W], const uint16_t* p, uint64_t n)
+{
+	for (uint64_t k = 0; k < W; ++k)
+		buf[k] = (k < n) ? p[k] : 0;
+}
+
+// ============================================================
+//  SSE2  (128-bit, 4 floats)
+// ============================================================
+
+struct IsaSse {
+	typedef __m128	vec;
+	static constexpr uint64_t	W = 4;
+	static constexpr int		ACC = 4;
+
+	static inline vec	zero() { return (_mm_setzero_ps()); }
+	static inline vec	set1(float a) { return (_mm_set1_ps(a)); }
+	static inline vec	load(const float* p) { return (_mm_load_ps(p)); }
+	static inline vec	loadu(const float* p) { return (_mm_loadu_ps(p)); }
+	static inline void	store(float* p, vec v) { _mm_store_ps(p, v); }
+	static inline void	storeu(float* p, vec v) { _mm_storeu_ps(p, v); }
+
+	static inline vec	load_partial(const float* p, uint64_t n)
+	{
+		alignas(16) float	buf[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+		for (uint64_t k = 0; k < n; ++k)
+			buf[k] = p[k];
+		return (_mm_load_ps(buf));
+	}
+
+	static inline void	store_partial(float* p, vec v, uint64_t n)
+	{
+		alignas(16) float	buf[4];
+
+		_mm_store_ps(buf, v);
+		for (uint64_t k = 0; k < n; ++k)
+			p[k] = buf[k];
+	}
+
+	static inline vec	add(vec a, vec b) { return (_mm_add_ps(a, b)); }
+	static inline vec	sub(vec a, vec b) { return (_mm_sub_ps(a, b)); }
+	static inline vec	mul(vec a, vec b) { return (_mm_mul_ps(a, b)); }
+	static inline vec	div(vec a, vec b) { return (_mm_div_ps(a, b)); }
+	static inline vec	sqrt(vec a) { return (_mm_sqrt_ps(a)); }
+	static inline vec	min(vec a, vec b) { return (_mm_min_ps(a, b)); }
+	static inline vec	max(vec a, vec b) { return (_mm_max_ps(a, b)); }
+	static inline vec	fmadd(vec a, vec b, vec c) { return (_mm_add_ps(_mm_mul_ps(a, b), c)); }
+	static inline vec	fnmadd(vec a, vec b, vec c) { return (_mm_sub_ps(c, _mm_mul_ps(a, b))); }
+	static inline vec	rcp(vec a) { return (_mm_rcp_ps(a)); }
+
+	// SSE2 has no roundps: convert through int32 (MXCSR round-to-nearest)
+	static inline vec	round(vec v) { return (_mm_cvtepi32_ps(_mm_cvtps_epi32(v))); }
+
+	// 2^n via IEEE 754 bit manipulation: (n + 127) << 23
+	static inline vec	pow2n(vec p, vec n)
+	{
+		__m128i e = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+		return (_mm_mul_ps(p, _mm_castsi128_ps(_mm_slli_epi32(e, 23))));
+	}
+
+	static inline vec	labels(const int* y)
+	{
+		return (_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y))));
+	}
+
+	// Horizontal sum of the 4 lanes without going through memory.
+	static inline float	hsum(vec v)
+	{
+		__m128 hi = _mm_movehl_ps(v, v);          // [2 3 2 3]
+		__m128 s  = _mm_add_ps(v, hi);            // [0+2 1+3 . .]
+		hi = _mm_shuffle_ps(s, s, 0x1);           // [1+3 . . .]
+		s  = _mm_add_ss(s, hi);
+		return (_mm_cvtss_f32(s));
+	}
+
+	// One transpose reduces all four accumulators.
+	static inline __m128	hsum4(vec a0, vec a1, vec a2, vec a3)
+	{
+		_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+		return (_mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3)));
+	}
+
+	static inline vec	from4(const __m128* q) { return (q[0]); }
+
+	static constexpr bool	GATHER = false;
+
+	static inline vec	gather(const float* p, const int32_t* idx)
+	{
+		return (_mm_setr_ps(p[idx[0]], p[idx[1]], p[idx[2]], p[idx[3]]));
+	}
+
+	static inline vec	gather_partial(const float* p, const int32_t* idx, uint64_t n)
+	{
+		alignas(16) float	buf[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+		for (uint64_t k = 0; k < n; ++k)
+			buf[k] = p[idx[k]];
+		return (_mm_load_ps(buf));
+	}
+
+	// CPUs without AVX have no F16C: fp16 is widened in software.
+	static constexpr bool	F16C = false;
+
+	static inline vec	load_f16(const uint16_t* p)
+	{
+		return (_mm_setr_ps(half_to_float(p[0]), half_to_float(p[1]),
+		                    half_to_float(p[2]), half_to_float(p[3])));
+	}
+
+	static inline vec	load_f16_partial(const uint16_t* p, uint64_t n)
+	{
+		uint16_t	buf[4];
+
+		copy_u16_partial(buf, p, n);
+		return (load_f16(buf));
+	}
+
+	// bfloat16 is the top half of a float: interleave with zeros.
+	static inline vec	load_bf16(const uint16_t* p)
+	{
+		const __m128i	h = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+		return (_mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), h)));
+	}
+
+	static inline vec	load_bf16_partial(const uint16_t* p, uint64_t n)
+	{
+		uint16_t	buf[4];
+
+		copy_u16_partial(buf, p, n);
+		return (load_bf16(buf));
+	}
+};
+
+// ============================================================
+//  AVX  (256-bit, 8 floats)
+// ============================================================
+
+// _mm256_maskload_ps mask with the first n (< 8) lanes set: a sliding
+// window over 8 ones followed by 8 zeros.
+static const int32_t	TAIL_MASK_TABLE_AVX[16] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static inline __m256i	tail_mask_avx(uint64_t n)
+{
+	return (_mm256_loadu_si256(
+		reinterpret_cast<const __m256i*>(TAIL_MASK_TABLE_AVX + 8 - n)));
+}
+
+struct IsaAvx {
+	typedef __m256	vec;
+	static constexpr uint64_t	W = 8;
+	static constexpr int		ACC = 4;
+
+	static inline vec	zero() { return (_mm256_setzero_ps()); }
+	static inline vec	set1(float a) { return (_mm256_set1_ps(a)); }
+	static inline vec	load(const float* p) { return (_mm256_load_ps(p)); }
+	static inline vec	loadu(const float* p) { return (_mm256_loadu_ps(p)); }
+	static inline void	store(float* p, vec v) { _mm256_store_ps(p, v); }
+	static inline void	storeu(float* p, vec v) { _mm256_storeu_ps(p, v); }
+
+	// masked-off lanes are neither read nor faulted on
+	static inline vec	load_partial(const float* p, uint64_t n)
+	{
+		return (_mm256_maskload_ps(p, tail_mask_avx(n)));
+	}
+
+	static inline void	store_partial(float* p, vec v, uint64_t n)
+	{
+		_mm256_maskstore_ps(p, tail_mask_avx(n), v);
+	}
+
+	static inline vec	add(vec a, vec b) { return (_mm256_add_ps(a, b)); }
+	static inline vec	sub(vec a, vec b) { return (_mm256_sub_ps(a, b)); }
+	static inline vec	mul(vec a, vec b) { return (_mm256_mul_ps(a, b)); }
+	static inline vec	div(vec a, vec b) { return (_mm256_div_ps(a, b)); }
+	static inline vec	sqrt(vec a) { return (_mm256_sqrt_ps(a)); }
+	static inline vec	min(vec a, vec b) { return (_mm256_min_ps(a, b)); }
+	static inline vec	max(vec a, vec b) { return (_mm256_max_ps(a, b)); }
+	static inline vec	fmadd(vec a, vec b, vec c) { return (_mm256_add_ps(_mm256_mul_ps(a, b), c)); }
+	static inline vec	fnmadd(vec a, vec b, vec c) { return (_mm256_sub_ps(c, _mm256_mul_ps(a, b))); }
+	static inline vec	rcp(vec a) { return (_mm256_rcp_ps(a)); }
+
+	static inline vec	round(vec v)
+	{
+		return (_mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+	}
+
+	// AVX has no 256-bit integer arithmetic: build the exponent bits
+	// in two SSE2 halves.
+	static inline vec	pow2n(vec p, vec n)
+	{
+		const __m128i	bias = _mm_set1_epi32(127);
+		__m256i			n_i  = _mm256_cvtps_epi32(n);
+		__m128i			lo   = _mm_add_epi32(_mm256_castsi256_si128(n_i), bias);
+		__m128i			hi   = _mm_add_epi32(_mm256_extractf128_si256(n_i, 1), bias);
+		__m256i			e    = _mm256_insertf128_si256(
+			_mm256_castsi128_si256(_mm_slli_epi32(lo, 23)), _mm_slli_epi32(hi, 23), 1);
+		return (_mm256_mul_ps(p, _mm256_castsi256_ps(e)));
+	}
+
+	static inline vec	labels(const int* y)
+	{
+		return (_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(y))));
+	}
+
+	// Fold the high half onto the low one.
+	static inline float	hsum(vec v)
+	{
+		return (IsaSse::hsum(_mm_add_ps(_mm256_castps256_ps128(v),
+		                                _mm256_extractf128_ps(v, 1))));
+	}
+
+	static inline __m128	hsum4(vec a0, vec a1, vec a2, vec a3)
+	{
+		__m256 t01 = _mm256_hadd_ps(a0, a1);
+		__m256 t23 = _mm256_hadd_ps(a2, a3);
+		__m256 t   = _mm256_hadd_ps(t01, t23);   // [s0 s1 s2 s3 | s0' s1' s2' s3']
+		return (_mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1)));
+	}
+
+	static inline vec	from4(const __m128* q)
+	{
+		return (_mm256_insertf128_ps(_mm256_castps128_ps256(q[0]), q[1], 1));
+	}
+
+	// AVX has no gather instruction.
+	static constexpr bool	GATHER = false;
+
+	static inline vec	gather(const float* p, const int32_t* idx)
+	{
+		return (_mm256_setr_ps(p[idx[0]], p[idx[1]], p[idx[2]], p[idx[3]],
+		                       p[idx[4]], p[idx[5]], p[idx[6]], p[idx[7]]));
+	}
+
+	static inline vec	gather_partial(const float* p, const int32_t* idx, uint64_t n)
+	{
+		alignas(32) float	buf[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+		for (uint64_t k = 0; k < n; ++k)
+			buf[k] = p[idx[k]];
+		return (_mm256_load_ps(buf));
+	}
+
+	// F16C came one generation after AVX (Ivy Bridge); without it in
+	// the build fp16 is widened in software, 4 lanes at a time.
+# if LOGREG_HAVE_F16C
+	static constexpr bool	F16C = true;
+
+	static inline vec	load_f16(const uint16_t* p)
+	{
+		return (_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+	}
+# else
+	static constexpr bool	F16C = false;
+
+	static inline vec	load_f16(const uint16_t* p)
+	{
+		return (_mm256_insertf128_ps(_mm256_castps128_ps256(IsaSse::load_f16(p)),
+		                             IsaSse::load_f16(p + 4), 1));
+	}
+# endif
+
+	static inline vec	load_f16_partial(const uint16_t* p, uint64_t n)
+	{
+		uint16_t	buf[8];
+
+		copy_u16_partial(buf, p, n);
+		return (load_f16(buf));
+	}
+
+	static inline vec	load_bf16(const uint16_t* p)
+	{
+		const __m128i	h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		const __m128i	z = _mm_setzero_si128();
+		return (_mm256_insertf128_ps(
+			_mm256_castps128_ps256(_mm_castsi128_ps(_mm_unpacklo_epi16(z, h))),
+			_mm_castsi128_ps(_mm_unpackhi_epi16(z, h)), 1));
+	}
+
+	static inline vec	load_bf16_partial(const uint16_t* p, uint64_t n)
+	{
+		uint16_t	buf[8];
+
+		copy_u16_partial(buf, p, n);
+		return (load_bf16(buf));
+	}
+};
+
+// ============================================================
+//  AVX2 + FMA  (256-bit, 8 floats, fused multiply-add)
+//  Everything else is inherited from IsaAvx.
+// ============================================================
+
+struct IsaAvx2Fma : IsaAvx {
+	static inline vec	fmadd(vec a, vec b, vec c) { return (_mm256_fmadd_ps(a, b, c)); }
+	static inline vec	fnmadd(vec a, vec b, vec c) { return (_mm256_fnmadd_ps(a, b, c)); }
+
+	static inline vec	pow2n(vec p, vec n)
+	{
+		__m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+		return (_mm256_mul_ps(p, _mm256_castsi256_ps(_mm256_slli_epi32(e, 23))));
+	}
+
+	static constexpr bool	GATHER = true;
+
+	static inline vec	gather(const float* p, const int32_t* idx)
+	{
+		return (_mm256_i32gather_ps(p,
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), 4));
+	}
+
+	// Masked-off lanes load neither an index nor a weight.
+	static inline vec	gather_partial(const float* p, const int32_t* idx, uint64_t n)
+	{
+		const __m256i	m = tail_mask_avx(n);
+		return (_mm256_mask_i32gather_ps(_mm256_setzero_ps(), p,
+			_mm256_maskload_epi32(idx, m), _mm256_castsi256_ps(m), 4));
+	}
+
+	static inline vec	load_bf16(const uint16_t* p)
+	{
+		const __m128i	h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		return (_mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16)));
+	}
+
+	static inline vec	load_bf16_partial(const uint16_t* p, uint64_t n)
+	{
+		uint16_t	buf[8];
+
+		copy_u16_partial(buf, p, n);
+		return (load_bf16(buf));
+	}
+};
+
+// ============================================================
+//  AVX-512F  (512-bit, 16 floats, opmask registers)
+//  Only compiled when the compiler targets AVX-512 (e.g. -march=native
+//  on an AVX-512 host, or -mavx512f for runs under Intel SDE).
+// ============================================================
+# if LOGREG_HAVE_AVX512
+
+// Mask selecting the first n (< 16) lanes.
+static inline __mmask16	tail_mask_avx512(uint64_t n)
+{
+	return ((__mmask16)((1u << n) - 1u));
+}
+
+// The unmasked forms of roundscale / scalef / rcp14 / min / max /
+// cvtepi32_ps / extractf64x4 (and so _mm512_castps512_ps256 and
+// _mm512_reduce_add_ps) in GCC 12's headers start from an
+// uninitialised register and trip -Wall; the all-lanes masked forms
+// used here compile to the same instructions.
+static const __mmask16	ALL_LANES_AVX512 = (__mmask16)0xFFFF;
+
+struct IsaAvx512 {
+	typedef __m512	vec;
+	static constexpr uint64_t	W = 16;
+	static constexpr int		ACC = 4;
+
+	// Padded rows are only 32-byte aligned, so load / store are the
+	// unaligned forms as well.
+	static inline vec	zero() { return (_mm512_setzero_ps()); }
+	static inline vec	set1(float a) { return (_mm512_set1_ps(a)); }
+	static inline vec	load(const float* p) { return (_mm512_loadu_ps(p)); }
+	static inline vec	loadu(const float* p) { return (_mm512_loadu_ps(p)); }
+	static inline void	store(float* p, vec v) { _mm512_storeu_ps(p, v); }
+	static inline void	storeu(float* p, vec v) { _mm512_storeu_ps(p, v); }
+
+	static inline vec	load_partial(const float* p, uint64_t n)
+	{
+		return (_mm512_maskz_loadu_ps(tail_mask_avx512(n), p));
+	}
+
+	static inline void	store_partial(float* p, vec v, uint64_t n)
+	{
+		_mm512_mask_storeu_ps(p, tail_mask_avx512(n), v);
+	}
+
+	static inline vec	add(vec a, vec b) { return (_mm512_add_ps(a, b)); }
+	static inline vec	sub(vec a, vec b) { return (_mm512_sub_ps(a, b)); }
+	static inline vec	mul(vec a, vec b) { return (_mm512_mul_ps(a, b)); }
+	static inline vec	div(vec a, vec b) { return (_mm512_div_ps(a, b)); }
+	static inline vec	sqrt(vec a) { return (_mm512_maskz_sqrt_ps(ALL_LANES_AVX512, a)); }
+	static inline vec	min(vec a, vec b) { return (_mm512_maskz_min_ps(ALL_LANES_AVX512, a, b)); }
+	static inline vec	max(vec a, vec b) { return (_mm512_maskz_max_ps(ALL_LANES_AVX512, a, b)); }
+	static inline vec	fmadd(vec a, vec b, vec c) { return (_mm512_fmadd_ps(a, b, c)); }
+	static inline vec	fnmadd(vec a, vec b, vec c) { return (_mm512_fnmadd_ps(a, b, c)); }
+	static inline vec	rcp(vec a) { return (_mm512_maskz_rcp14_ps(ALL_LANES_AVX512, a)); }
+
+	static inline vec	round(vec v)
+	{
+		return (_mm512_maskz_roundscale_ps(ALL_LANES_AVX512, v,
+		                                   _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+	}
+
+	// scalef: no exponent-field arithmetic needed
+	static inline vec	pow2n(vec p, vec n)
+	{
+		return (_mm512_maskz_scalef_ps(ALL_LANES_AVX512, p, n));
+	}
+
+	static inline vec	labels(const int* y)
+	{
+		return (_mm512_maskz_cvtepi32_ps(ALL_LANES_AVX512, _mm512_loadu_si512(y)));
+	}
+
+	// Fold a 512-bit register to 256 bits (AVX-512F only, no DQ needed).
+	static inline __m256	fold(vec v)
+	{
+		__m512d	d  = _mm512_castps_pd(v);
+		__m256	lo = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd((__mmask8)0xFF, d, 0));
+		__m256	hi = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd((__mmask8)0xFF, d, 1));
+		return (_mm256_add_ps(lo, hi));
+	}
+
+	static inline float	hsum(vec v)
+	{
+		return (IsaAvx::hsum(fold(v)));
+	}
+
+	static inline __m128	hsum4(vec a0, vec a1, vec a2, vec a3)
+	{
+		return (IsaAvx::hsum4(fold(a0), fold(a1), fold(a2), fold(a3)));
+	}
+
+	static inline vec	from4(const __m128* q)
+	{
+		vec v = _mm512_castps128_ps512(q[0]);
+		v = _mm512_insertf32x4(v, q[1], 1);
+		v = _mm512_insertf32x4(v, q[2], 2);
+		return (_mm512_insertf32x4(v, q[3], 3));
+	}
+
+	static constexpr bool	GATHER = true;
+
+	static inline vec	gather(const float* p, const int32_t* idx)
+	{
+		return (_mm512_mask_i32gather_ps(_mm512_setzero_ps(), ALL_LANES_AVX512,
+			_mm512_loadu_si512(idx), p, 4));
+	}
+
+	static inline vec	gather_partial(const float* p, const int32_t* idx, uint64_t n)
+	{
+		const __mmask16	m = tail_mask_avx512(n);
+		return (_mm512_mask_i32gather_ps(_mm512_setzero_ps(), m,
+			_mm512_maskz_loadu_epi32(m, idx), p, 4));
+	}
+
+	// vcvtph2ps zmm is part of AVX-512F.  16-bit masked loads need
+	// AVX-512BW, so partial loads go through a buffer.
+	static constexpr bool	F16C = true;
+
+	static inline vec	load_f16(const uint16_t* p)
+	{
+		return (_mm512_maskz_cvtph_ps(ALL_LANES_AVX512,
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))));
+	}
+
+	static inline vec	load_f16_partial(const uint16_t* p, uint64_t n)
+	{
+		uint16_t	buf[16];
+
+		copy_u16_partial(buf, p, n);
+		return (load_f16(buf));
+	}
+
+	static inline vec	load_bf16(const uint16_t* p)
+	{
+		const __m256i	h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+# if defined(__AVX512BW__)
+		// one vpermw: word i to the high half of lane i, low half zeroed
+		const __m512i	idx = _mm512_set_epi16(
+			15, 0, 14, 0, 13, 0, 12, 0, 11, 0, 10, 0, 9, 0, 8, 0,
+			7, 0, 6, 0, 5, 0, 4, 0, 3, 0, 2, 0, 1, 0, 0, 0);
+		return (_mm512_castsi512_ps(_mm512_maskz_permutexvar_epi16(
+			(__mmask32)0xAAAAAAAAu, idx, _mm512_castsi256_si512(h))));
+# else
+		return (_mm512_castsi512_ps(_mm512_maskz_slli_epi32(ALL_LANES_AVX512,
+			_mm512_maskz_cvtepu16_epi32(ALL_LANES_AVX512, h), 16)));
+# endif
+	}
+
+	static inline vec	load_bf16_partial(const uint16_t* p, uint64_t n)
+	{
+		uint16_t	buf[16];
+
+		copy_u16_partial(buf, p, n);
+		return (load_bf16(buf));
+	}
+};
+
+# endif // LOGREG_HAVE_AVX512
+
+// Widest traits the translation unit is compiled for (the build
+// targets the host with -march=native).
+# if LOGREG_HAVE_AVX512
+typedef IsaAvx512	IsaNative;
+# elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+typedef IsaAvx2Fma	IsaNative;
+# elif defined(__AVX__)
+typedef IsaAvx		IsaNative;
+# else
+typedef IsaSse		IsaNative;
+# endif
+
+#endif
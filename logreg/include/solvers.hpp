@@ -0,0 +1,35 @@
+// solvers.hpp file
+//
+// Quasi-Newton and Newton optimisers behind LogisticRegression::train
+// (SOLVER_LBFGS, SOLVER_IRLS).  Both minimise the mean log-loss of
+// the rows of a TrainJob over θ = (w, b).  Every evaluation of the
+// loss and gradient is one sweep of loss_grad_loop / hessian_loop
+// (model_loops.hpp), so the SIMD forward pass, sigmoid and fused
+// gradient are the ones gradient descent uses, and a solver's cost
+// is its number of passes over X.
+//
+// Each iteration takes one direction and a backtracking line search
+// along it; the point the search accepts already carries the gradient
+// (and, for IRLS, the Hessian) of the next iteration, so an iteration
+// usually costs a single pass.  A solver stops when every gradient
+// component is within tol, when the line search can no longer lower
+// the loss (float precision reached), or after job.epochs iterations,
+// and leaves the best weights found in job.weights / job.bias.
+//
+// Vectors over θ use the layout of a gradient slot: w in the first
+// job.acc floats (zero past n_features) and b at [acc].
+
+#ifndef SOLVERS_H
+# define SOLVERS_H
+# include <cstddef>
+# include "model_loops.hpp"
+
+// Floats of scratch (Workspace::solver_buffer) each solver needs.
+size_t	lbfgs_work_floats(const TrainJob& job);
+size_t	irls_work_floats(const TrainJob& job, int n_threads);
+
+// Both return the number of passes made over X.
+int		lbfgs_solve(const TrainJob& job, ThreadPool& pool, float tol, float* work);
+int		irls_solve(TrainJob job, ThreadPool& pool, float tol, float* work);
+
+#endif
@@ -0,0 +1,298 @@
+#include "include/simd_fn.hpp"
+#include <string.h>
+
+// ============================================================
+//  gemv_u8s8 : out[i] = scale * <Xq_i, wq> + offset over n rows
+//
+//  Xq holds 7-bit activations (0 .. 127) as unsigned bytes, rows
+//  ld bytes apart of which the first nq are read; wq holds signed
+//  8-bit weights, zero-padded to a multiple of 64 bytes.  The dot
+//  products are exact in int32 and only the result is scaled, so
+//  every tier returns the same logits bit for bit.
+//
+//  The 7-bit range is what keeps vpmaddubsw exact: it adds two
+//  u8 × s8 products into a saturating int16, and 2 × 127 × 127
+//  = 32258 still fits where 2 × 255 × 127 would not.
+//
+//  Rows are processed 4 at a time so each weight vector is loaded
+//  once for the 4 rows.  Tails are narrower steps (AVX2) or masked
+//  loads (AVX-512), never reads past nq.
+// ============================================================
+
+void	gemv_u8s8_scalar(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out) {
+	for (uint64_t i = 0; i < n; ++i) {
+		const uint8_t*	x = Xq + i * ld;
+		int32_t			acc{0};
+
+		for (uint64_t k = 0; k < nq; ++k)
+			acc += (int32_t)x[k] * (int32_t)wq[k];
+		out[i] = scale * (float)acc + offset;
+	}
+}
+
+// ============================================================
+//  quantize_u7 : Q_i[j] = clamp(round((X_i[j] - zp[j]) * inv_s[j]),
+//                               0, 127) over n rows of nf floats
+//
+//  X rows are ld floats apart, Q rows ldq bytes apart; zp and
+//  inv_s are zero-padded to a multiple of 16.  Rounding is half-up
+//  and NaN maps to 0, identically on every tier.  Only the first
+//  nf bytes of a Q row are written.
+// ============================================================
+
+static inline uint8_t	quantize_u7_one(float x, float zp, float inv_s) {
+	float	v = (x - zp) * inv_s;
+
+	v = v > 0.0f ? v : 0.0f;            // NaN fails the test: 0
+	v = v < 127.0f ? v : 127.0f;
+	return ((uint8_t)(int)(v + 0.5f));
+}
+
+void	quantize_u7_scalar(const float* X, uint64_t n, uint64_t ld,
+			const float* zp, const float* inv_s, uint64_t nf,
+			uint8_t* Q, uint64_t ldq) {
+	for (uint64_t i = 0; i < n; ++i)
+		for (uint64_t j = 0; j < nf; ++j)
+			Q[i * ldq + j] = quantize_u7_one(X[i * ld + j], zp[j], inv_s[j]);
+}
+
+// ---- AVX2: vpmaddubsw + vpmaddwd ----
+
+// acc += pairwise sums of x[k] * w[k] (u8 × s8), four per int32 lane
+static inline __m256i	madd_u8s8_avx2(__m256i acc, __m256i x, __m256i w) {
+	const __m256i	ones = _mm256_set1_epi16(1);
+
+	return (_mm256_add_epi32(acc,
+		_mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones)));
+}
+
+static inline int32_t	hsum_epi32_sse(__m128i s) {
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+	return (_mm_cvtsi128_si32(s));
+}
+
+static inline int32_t	hsum_epi32_avx2(__m256i v) {
+	return (hsum_epi32_sse(_mm_add_epi32(_mm256_castsi256_si128(v),
+	                                     _mm256_extracti128_si256(v, 1))));
+}
+
+// <x, w> over the last n < 32 bytes of a row: one 16-byte and one
+// 8-byte step where they fit, then scalar.
+static inline int32_t	dot_u8s8_tail(const uint8_t* x, const int8_t* w, uint64_t n) {
+	const __m128i	ones = _mm_set1_epi16(1);
+	__m128i			acc  = _mm_setzero_si128();
+	uint64_t		k{0};
+
+	if (n >= 16) {
+		acc = _mm_madd_epi16(_mm_maddubs_epi16(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(w))), ones);
+		k = 16;
+	}
+	if (n - k >= 8) {
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_maddubs_epi16(
+			_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + k)),
+			_mm_loadl_epi64(reinterpret_cast<const __m128i*>(w + k))), ones));
+		k += 8;
+	}
+	int32_t	sum = hsum_epi32_sse(acc);
+	for (; k < n; ++k)
+		sum += (int32_t)x[k] * (int32_t)w[k];
+	return (sum);
+}
+
+void	quantize_u7_avx2(const float* X, uint64_t n, uint64_t ld,
+			const float* zp, const float* inv_s, uint64_t nf,
+			uint8_t* Q, uint64_t ldq) {
+	const __m256	lo   = _mm256_setzero_ps();
+	const __m256	hi   = _mm256_set1_ps(127.0f);
+	const __m256	half = _mm256_set1_ps(0.5f);
+	const uint64_t	nv   = nf & ~(uint64_t)7;
+
+	for (uint64_t i = 0; i < n; ++i) {
+		const float*	x = X + i * ld;
+		uint8_t*		q = Q + i * ldq;
+		uint64_t		j{0};
+
+		for (; j < nv; j += 8) {
+			__m256	v = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + j),
+				_mm256_loadu_ps(zp + j)), _mm256_loadu_ps(inv_s + j));
+			v = _mm256_min_ps(_mm256_max_ps(v, lo), hi);   // maxps(NaN, 0) = 0
+			const __m256i	k = _mm256_cvttps_epi32(_mm256_add_ps(v, half));
+			const __m128i	w = _mm_packus_epi32(_mm256_castsi256_si128(k),
+			                                     _mm256_extracti128_si256(k, 1));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(q + j), _mm_packus_epi16(w, w));
+		}
+		for (; j < nf; ++j)
+			q[j] = quantize_u7_one(x[j], zp[j], inv_s[j]);
+	}
+}
+
+void	gemv_u8s8_avx2(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out) {
+	const uint64_t	nv = nq & ~(uint64_t)31;
+	uint64_t		i{0};
+
+	for (; i + 4 <= n; i += 4) {
+		const uint8_t*	x0 = Xq + i * ld;
+		const uint8_t*	x1 = x0 + ld;
+		const uint8_t*	x2 = x1 + ld;
+		const uint8_t*	x3 = x2 + ld;
+		__m256i			a0 = _mm256_setzero_si256();
+		__m256i			a1 = a0, a2 = a0, a3 = a0;
+		uint64_t		k{0};
+
+		for (; k < nv; k += 32) {
+			const __m256i	w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(wq + k));
+			a0 = madd_u8s8_avx2(a0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x0 + k)), w);
+			a1 = madd_u8s8_avx2(a1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x1 + k)), w);
+			a2 = madd_u8s8_avx2(a2, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x2 + k)), w);
+			a3 = madd_u8s8_avx2(a3, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x3 + k)), w);
+		}
+		out[i]     = scale * (float)(hsum_epi32_avx2(a0)
+		                             + dot_u8s8_tail(x0 + nv, wq + nv, nq - nv)) + offset;
+		out[i + 1] = scale * (float)(hsum_epi32_avx2(a1)
+		                             + dot_u8s8_tail(x1 + nv, wq + nv, nq - nv)) + offset;
+		out[i + 2] = scale * (float)(hsum_epi32_avx2(a2)
+		                             + dot_u8s8_tail(x2 + nv, wq + nv, nq - nv)) + offset;
+		out[i + 3] = scale * (float)(hsum_epi32_avx2(a3)
+		                             + dot_u8s8_tail(x3 + nv, wq + nv, nq - nv)) + offset;
+	}
+	for (; i < n; ++i) {
+		const uint8_t*	x = Xq + i * ld;
+		__m256i			a = _mm256_setzero_si256();
+		uint64_t		k{0};
+
+		for (; k < nv; k += 32)
+			a = madd_u8s8_avx2(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + k)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(wq + k)));
+		out[i] = scale * (float)(hsum_epi32_avx2(a)
+		                         + dot_u8s8_tail(x + nv, wq + nv, nq - nv)) + offset;
+	}
+}
+
+// ---- AVX-512BW (vpmaddubsw) and AVX-512 VNNI (vpdpbusd) ----
+
+#if LOGREG_HAVE_AVX512BW
+
+static const __mmask16	ALL_LANES_I32 = (__mmask16)0xFFFF;
+
+// VNNI fuses the u8 × s8 products and the int32 accumulation into one
+// instruction, with no int16 intermediate.
+template<bool VNNI>
+static inline __m512i	madd_u8s8_avx512(__m512i acc, __m512i x, __m512i w) {
+# if LOGREG_HAVE_AVX512VNNI
+	if (VNNI)
+		return (_mm512_dpbusd_epi32(acc, x, w));
+# endif
+	return (_mm512_maskz_add_epi32(ALL_LANES_I32, acc,
+		_mm512_maskz_madd_epi16(ALL_LANES_I32,
+			_mm512_maskz_maddubs_epi16((__mmask32)~0u, x, w),
+			_mm512_set1_epi16(1))));
+}
+
+static inline int32_t	hsum_epi32_avx512(__m512i v) {
+	return (hsum_epi32_avx2(_mm256_add_epi32(
+		_mm512_maskz_extracti64x4_epi64((__mmask8)0xFF, v, 0),
+		_mm512_maskz_extracti64x4_epi64((__mmask8)0xFF, v, 1))));
+}
+
+static inline __mmask64	tail_mask_u8(uint64_t n) {
+	return (n >= 64 ? ~(__mmask64)0 : (((__mmask64)1 << n) - 1));
+}
+
+template<bool VNNI>
+static void	gemv_u8s8_512(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out) {
+	const uint64_t	nv = nq & ~(uint64_t)63;
+	const __mmask64	mt = tail_mask_u8(nq - nv);
+	uint64_t		i{0};
+
+	for (; i + 4 <= n; i += 4) {
+		const uint8_t*	x0 = Xq + i * ld;
+		const uint8_t*	x1 = x0 + ld;
+		const uint8_t*	x2 = x1 + ld;
+		const uint8_t*	x3 = x2 + ld;
+		__m512i			a0 = _mm512_setzero_si512();
+		__m512i			a1 = a0, a2 = a0, a3 = a0;
+		uint64_t		k{0};
+
+		for (; k < nv; k += 64) {
+			const __m512i	w = _mm512_loadu_si512(wq + k);
+			a0 = madd_u8s8_avx512<VNNI>(a0, _mm512_loadu_si512(x0 + k), w);
+			a1 = madd_u8s8_avx512<VNNI>(a1, _mm512_loadu_si512(x1 + k), w);
+			a2 = madd_u8s8_avx512<VNNI>(a2, _mm512_loadu_si512(x2 + k), w);
+			a3 = madd_u8s8_avx512<VNNI>(a3, _mm512_loadu_si512(x3 + k), w);
+		}
+		if (k < nq) {
+			const __m512i	w = _mm512_loadu_si512(wq + k);
+			a0 = madd_u8s8_avx512<VNNI>(a0, _mm512_maskz_loadu_epi8(mt, x0 + k), w);
+			a1 = madd_u8s8_avx512<VNNI>(a1, _mm512_maskz_loadu_epi8(mt, x1 + k), w);
+			a2 = madd_u8s8_avx512<VNNI>(a2, _mm512_maskz_loadu_epi8(mt, x2 + k), w);
+			a3 = madd_u8s8_avx512<VNNI>(a3, _mm512_maskz_loadu_epi8(mt, x3 + k), w);
+		}
+		out[i]     = scale * (float)hsum_epi32_avx512(a0) + offset;
+		out[i + 1] = scale * (float)hsum_epi32_avx512(a1) + offset;
+		out[i + 2] = scale * (float)hsum_epi32_avx512(a2) + offset;
+		out[i + 3] = scale * (float)hsum_epi32_avx512(a3) + offset;
+	}
+	for (; i < n; ++i) {
+		const uint8_t*	x = Xq + i * ld;
+		__m512i			a = _mm512_setzero_si512();
+		uint64_t		k{0};
+
+		for (; k < nv; k += 64)
+			a = madd_u8s8_avx512<VNNI>(a, _mm512_loadu_si512(x + k),
+				_mm512_loadu_si512(wq + k));
+		if (k < nq)
+			a = madd_u8s8_avx512<VNNI>(a, _mm512_maskz_loadu_epi8(mt, x + k),
+				_mm512_loadu_si512(wq + k));
+		out[i] = scale * (float)hsum_epi32_avx512(a) + offset;
+	}
+}
+
+// The tail is a masked load and a masked vpmovdb store.
+void	quantize_u7_avx512(const float* X, uint64_t n, uint64_t ld,
+			const float* zp, const float* inv_s, uint64_t nf,
+			uint8_t* Q, uint64_t ldq) {
+	const __m512	lo   = _mm512_setzero_ps();
+	const __m512	hi   = _mm512_set1_ps(127.0f);
+	const __m512	half = _mm512_set1_ps(0.5f);
+
+	for (uint64_t i = 0; i < n; ++i) {
+		const float*	x = X + i * ld;
+		uint8_t*		q = Q + i * ldq;
+
+		for (uint64_t j = 0; j < nf; j += 16) {
+			const __mmask16	m = nf - j >= 16 ? ALL_LANES_I32
+			                                 : (__mmask16)((1u << (nf - j)) - 1);
+			__m512	v = _mm512_mul_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(m, x + j),
+				_mm512_loadu_ps(zp + j)), _mm512_loadu_ps(inv_s + j));
+			v = _mm512_maskz_min_ps(ALL_LANES_I32,
+				_mm512_maskz_max_ps(ALL_LANES_I32, v, lo), hi);
+			_mm512_mask_cvtepi32_storeu_epi8(q + j, m,
+				_mm512_maskz_cvttps_epi32(ALL_LANES_I32, _mm512_add_ps(v, half)));
+		}
+	}
+}
+
+void	gemv_u8s8_avx512(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out) {
+	gemv_u8s8_512<false>(Xq, n, ld, wq, nq, scale, offset, out);
+}
+
+# if LOGREG_HAVE_AVX512VNNI
+void	gemv_u8s8_avx512_vnni(const uint8_t* Xq, uint64_t n, uint64_t ld,
+			const int8_t* wq, uint64_t nq, float scale, float offset,
+			float* out) {
+	gemv_u8s8_512<true>(Xq, n, ld, wq, nq, scale, offset, out);
+}
+# endif
+
+#endif // LOGREG_HAVE_AVX512BW
@@ -0,0 +1,721 @@
+#include "include/model_loops.hpp"
+#include "include/isa_kernels.hpp"
+#include "include/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// -------------------------------------------------------------------
+//  Training – one sweep over X per epoch
+//  Every pool thread accumulates into its own cache-line-padded slot
+//  (dw in the first acc floats, db at [acc]); the slots are reduced
+//  into slot 0 once per epoch before the parameter update.  With
+//  LOSS, each block's log-loss is also added to a double kept in its
+//  thread's slot at acc + 2 and handed to the job's hook.
+// -------------------------------------------------------------------
+
+static inline double& slot_loss(float* g, int acc)
+{
+    return *reinterpret_cast<double*>(g + acc + 2);
+}
+
+static inline double slot_loss(const float* g, int acc)
+{
+    return *reinterpret_cast<const double*>(g + acc + 2);
+}
+
+// One step of the rule of st over the summed gradient (dw, db) of n
+// rows: the fused kernel over the weights, opt_update1 for the bias.
+template <class Isa, Optimizer OPT>
+static inline void apply_rule(OptState& st, const OptStep& s, const float* dw,
+                              float db, float* w, float* b, int nf)
+{
+    Kernels<Isa>::template opt_step<OPT>(s, dw, w, st.m, st.v, nf);
+    opt_update1<OPT>(s, s.scale * db, *b, st.mb, st.vb);
+}
+
+template <class Isa>
+static void opt_step(OptState& st, float lr, int n, const float* dw, float db,
+                     float* w, float* b, int nf)
+{
+    OptStep s;
+    s.scale = 1.0f / static_cast<float>(n);
+    s.lr    = lr;
+    s.beta1 = st.beta1;
+    s.beta2 = st.beta2;
+    s.eps   = st.eps;
+    ++st.t;
+
+    switch (st.kind) {
+    case OPTIMIZER_MOMENTUM:
+        apply_rule<Isa, OPTIMIZER_MOMENTUM>(st, s, dw, db, w, b, nf);
+        break;
+    case OPTIMIZER_NESTEROV:
+        apply_rule<Isa, OPTIMIZER_NESTEROV>(st, s, dw, db, w, b, nf);
+        break;
+    case OPTIMIZER_ADAGRAD:
+        apply_rule<Isa, OPTIMIZER_ADAGRAD>(st, s, dw, db, w, b, nf);
+        break;
+    default: {
+        // Bias correction folded into the step size and ε.
+        const double c2 = std::sqrt(1.0 - std::pow((double)st.beta2, (double)st.t));
+        const double c1 = 1.0 - std::pow((double)st.beta1, (double)st.t);
+        s.lr  = (float)(lr * c2 / c1);
+        s.eps = (float)(st.eps * c2);
+        apply_rule<Isa, OPTIMIZER_ADAM>(st, s, dw, db, w, b, nf);
+        break;
+    }
+    }
+}
+
+// block_grad(begin, rows, b, g, loss) adds the gradient of rows
+// [begin, begin + rows) to the slot g (and, with LOSS, their loss to
+// *loss) and returns their db.  Shared by the dense and CSR jobs,
+// which differ only in that call.
+template <class Isa, bool LOSS, class Job, class BlockGrad>
+static void descend(const Job& job, int n_samples, ThreadPool& pool,
+                    BlockGrad block_grad)
+{
+    const int    bs   = job.block_rows;
+    const int    nb   = (n_samples + bs - 1) / bs;
+    const int    nt   = pool.size();
+    const int    acc  = job.acc;
+    const int    slot = job.slot;
+    float*       grad = job.grad;
+    float*       w    = job.weights;
+
+    for (int epoch = 0; epoch < job.epochs; ++epoch) {
+
+        std::memset(grad, 0, (size_t)nt * slot * sizeof(float));
+
+        // ---- fused forward + sigmoid + gradient, one sweep per block ----
+        const float b = *job.bias;
+        pool.parallel_for(nb, [&](int blk, int t) {
+            const int begin = blk * bs;
+            const int rows  = std::min(n_samples, begin + bs) - begin;
+            float*    g     = grad + (size_t)t * slot;
+            float     loss  = 0.0f;
+            g[acc] += block_grad(begin, rows, b, g, &loss);
+            if (LOSS)
+                slot_loss(g, acc) += loss;
+        });
+
+        // ---- reduce thread slots into slot 0 (dw += g_t) ----
+        float* dw   = grad;
+        float  db   = grad[acc];
+        double loss = LOSS ? slot_loss((const float*)grad, acc) : 0.0;
+        for (int t = 1; t < nt; ++t) {
+            const float* g = grad + (size_t)t * slot;
+            Kernels<Isa>::axpy(1.0f, g, dw, job.n_features);
+            db += g[acc];
+            if (LOSS)
+                loss += slot_loss(g, acc);
+        }
+        const bool stop = LOSS && job.hook->end_epoch(loss, dw, db, n_samples);
+
+        // ---- parameter update (w -= lr / n * dw, or the job's rule) ----
+        if (job.opt && job.opt->kind != OPTIMIZER_SGD) {
+            opt_step<Isa>(*job.opt, job.lr, n_samples, dw, db, w, job.bias,
+                          job.n_features);
+        } else {
+            const float step = job.lr / static_cast<float>(n_samples);
+            Kernels<Isa>::axpy(-step, dw, w, job.n_features);
+            *job.bias -= step * db;
+        }
+        if (stop)
+            break;
+    }
+}
+
+// Rows of a dense job in the format R: X, or the 16-bit Xh.
+template <class Job>
+static inline const float* job_rows(const Job& job, RowsF32) { return job.X; }
+template <class Job>
+static inline const uint16_t* job_rows(const Job& job, RowsF16) { return job.Xh; }
+template <class Job>
+static inline const uint16_t* job_rows(const Job& job, RowsBf16) { return job.Xh; }
+
+template <class Isa, bool FAST, class R, bool LOSS>
+static void train_epochs(const TrainJob& job, ThreadPool& pool)
+{
+    const int                ld = job.ld;
+    const typename R::elem*  X  = job_rows(job, R());
+    descend<Isa, LOSS>(job, job.n_samples, pool,
+                       [&](int begin, int rows, float b, float* g, float* loss) {
+        return Kernels<Isa>::template fused_grad<FAST, R, LOSS>(X + (size_t)begin * ld,
+                                                                job.Y + begin, rows, ld,
+                                                                job.cols, job.weights,
+                                                                b, g, loss);
+    });
+}
+
+template <class Isa, bool FAST, bool LOSS>
+static void sparse_train_epochs(const SparseTrainJob& job, ThreadPool& pool)
+{
+    const CsrMatrix& X = job.X;
+    descend<Isa, LOSS>(job, X.n_rows, pool,
+                       [&](int begin, int rows, float b, float* g, float* loss) {
+        return Kernels<Isa>::template sparse_fused_grad<FAST, LOSS>(X.indptr + begin,
+                                                                    X.indices, X.values,
+                                                                    job.Y + begin, rows,
+                                                                    job.weights, b, g,
+                                                                    loss);
+    });
+}
+
+template <class Isa, class R = RowsF32>
+static void run_train(const TrainJob& job, ThreadPool& pool)
+{
+    if (job.hook) {
+        if (job.fast_sigmoid) train_epochs<Isa, true, R, true>(job, pool);
+        else                  train_epochs<Isa, false, R, true>(job, pool);
+        return;
+    }
+    if (job.fast_sigmoid) train_epochs<Isa, true, R, false>(job, pool);
+    else                  train_epochs<Isa, false, R, false>(job, pool);
+}
+
+template <class Isa>
+static void run_train(const SparseTrainJob& job, ThreadPool& pool)
+{
+    if (job.hook) {
+        if (job.fast_sigmoid) sparse_train_epochs<Isa, true, true>(job, pool);
+        else                  sparse_train_epochs<Isa, false, true>(job, pool);
+        return;
+    }
+    if (job.fast_sigmoid) sparse_train_epochs<Isa, true, false>(job, pool);
+    else                  sparse_train_epochs<Isa, false, false>(job, pool);
+}
+
+// -------------------------------------------------------------------
+//  Hogwild! – lock-free asynchronous SGD
+//  One task per shard, and each task runs every epoch over its own
+//  rows, so the threads never wait for each other until the run
+//  ends.  All of them step on the same weights: a group of rows reads
+//  w and b as they are and adds its steps straight back with plain
+//  (vector) loads and stores, no lock and no atomic read-modify-write.
+//  Aligned float accesses do not tear on x86, so a race can only lose
+//  or delay another thread's step on a weight, which SGD absorbs like
+//  any other gradient noise (Niu et al., Hogwild!, 2011).
+// -------------------------------------------------------------------
+
+// Rows [begin, end) of shard s out of k.
+static inline void shard_rows(int n, int s, int k, int& begin, int& end)
+{
+    begin = (int)((int64_t)n * s / k);
+    end   = (int)((int64_t)n * (s + 1) / k);
+}
+
+template <class Isa, bool FAST>
+static void hogwild_epochs(const TrainJob& job, ThreadPool& pool)
+{
+    const int ld = job.ld;
+    const int k  = std::max(1, std::min(job.shards, pool.size()));
+
+    pool.parallel_for(k, [&](int s, int) {
+        int begin, end;
+        shard_rows(job.n_samples, s, k, begin, end);
+        for (int epoch = 0; epoch < job.epochs; ++epoch)
+            Kernels<Isa>::template sgd_rows<FAST>(job.X + (size_t)begin * ld,
+                                                  job.Y + begin, end - begin, ld,
+                                                  job.cols, job.lr, job.weights,
+                                                  job.bias);
+    });
+}
+
+template <class Isa, bool FAST>
+static void sparse_hogwild_epochs(const SparseTrainJob& job, ThreadPool& pool)
+{
+    const CsrMatrix& X = job.X;
+    const int        k = std::max(1, std::min(job.shards, pool.size()));
+
+    pool.parallel_for(k, [&](int s, int) {
+        int begin, end;
+        shard_rows(X.n_rows, s, k, begin, end);
+        for (int epoch = 0; epoch < job.epochs; ++epoch)
+            Kernels<Isa>::template sparse_sgd_rows<FAST>(X.indptr + begin, X.indices,
+                                                         X.values, job.Y + begin,
+                                                         end - begin, job.lr,
+                                                         job.weights, job.bias);
+    });
+}
+
+template <class Isa>
+static void run_hogwild(const TrainJob& job, ThreadPool& pool)
+{
+    if (job.fast_sigmoid) hogwild_epochs<Isa, true>(job, pool);
+    else                  hogwild_epochs<Isa, false>(job, pool);
+}
+
+template <class Isa>
+static void run_hogwild(const SparseTrainJob& job, ThreadPool& pool)
+{
+    if (job.fast_sigmoid) sparse_hogwild_epochs<Isa, true>(job, pool);
+    else                  sparse_hogwild_epochs<Isa, false>(job, pool);
+}
+
+// -------------------------------------------------------------------
+//  Solver passes – loss, gradient and (IRLS) curvature at fixed weights
+//  Same blocks and slots as an epoch, without the update.  Each
+//  block's float loss is added to its thread's double sum, so the
+//  total does not drift with the number of blocks and the line
+//  searches can compare losses that differ in the 7th digit.
+// -------------------------------------------------------------------
+
+template <class Isa, bool FAST, bool HESS>
+static double solver_pass(const TrainJob& job, ThreadPool& pool)
+{
+    const int    ld    = job.ld;
+    const int    nf    = job.n_features;
+    const int    bs    = job.block_rows;
+    const int    nb    = (job.n_samples + bs - 1) / bs;
+    const int    nt    = pool.size();
+    const int    acc   = job.acc;
+    const int    slot  = job.slot;
+    const size_t hslot = (size_t)(nf + 1) * job.ldh;
+    float*       grad  = job.grad;
+    const float  b     = *job.bias;
+
+    std::memset(grad, 0, (size_t)nt * slot * sizeof(float));
+    if (HESS)
+        std::memset(job.hess, 0, nt * hslot * sizeof(float));
+
+    pool.parallel_for(nb, [&](int blk, int t) {
+        const int    begin = blk * bs;
+        const int    rows  = std::min(job.n_samples, begin + bs) - begin;
+        const float* X     = job.X + (size_t)begin * ld;
+        float*       g     = grad + (size_t)t * slot;
+        float        loss  = 0.0f;
+
+        g[acc] += Kernels<Isa>::template fused_grad<FAST, RowsF32, true>(
+            X, job.Y + begin, rows, ld, job.cols, job.weights, b, g, &loss);
+        slot_loss(g, acc) += loss;
+
+        // p (1 - p) of the block's rows, 256 at a time, then their
+        // rank-one terms while the rows are still in L2.
+        if (HESS) {
+            constexpr int CHUNK = 256;
+            alignas(64) float s[CHUNK];
+            float* H = job.hess + t * hslot;
+            for (int i = 0; i < rows; i += CHUNK) {
+                const int r = std::min(CHUNK, rows - i);
+                Kernels<Isa>::gemv(X + (size_t)i * ld, r, ld, job.cols,
+                                   job.weights, b, s);
+                Kernels<Isa>::template sigmoid<FAST>(s, s, r);
+                for (int k = 0; k < r; ++k)
+                    s[k] *= 1.0f - s[k];
+                Kernels<Isa>::hess_rows(s, X + (size_t)i * ld, r, ld, nf, H, job.ldh);
+            }
+        }
+    });
+
+    double loss = slot_loss((const float*)grad, acc);
+    for (int t = 1; t < nt; ++t) {
+        const float* g = grad + (size_t)t * slot;
+        Kernels<Isa>::axpy(1.0f, g, grad, nf);
+        grad[acc] += g[acc];
+        loss      += slot_loss(g, acc);
+        if (HESS)
+            Kernels<Isa>::axpy(1.0f, job.hess + t * hslot, job.hess, hslot);
+    }
+    return loss;
+}
+
+template <class Isa, bool HESS>
+static double run_solver_pass(const TrainJob& job, ThreadPool& pool)
+{
+    if (job.fast_sigmoid) return solver_pass<Isa, true, HESS>(job, pool);
+    return solver_pass<Isa, false, HESS>(job, pool);
+}
+
+// -------------------------------------------------------------------
+//  Batch scoring
+//  predict: logits straight into probs, turned into probabilities in
+//  place block by block.  classify: only the sign of the logit
+//  matters, so logits go through a small stack buffer.
+// -------------------------------------------------------------------
+
+template <class Isa, bool FAST, class R>
+static void predict_blocks(const ScoreJob& job, ThreadPool& pool)
+{
+    const int                ld = job.ld;
+    const int                bs = job.block_rows;
+    const int                nb = (job.n_samples + bs - 1) / bs;
+    const typename R::elem*  X  = job_rows(job, R());
+
+    pool.parallel_for(nb, [&](int blk, int) {
+        const int begin = blk * bs;
+        const int rows  = std::min(job.n_samples, begin + bs) - begin;
+        float*    out   = job.probs + begin;
+        Kernels<Isa>::template gemv<R>(X + (size_t)begin * ld, rows, ld, job.cols,
+                                       job.weights, job.bias, out);
+        Kernels<Isa>::template sigmoid<FAST>(out, out, rows);
+    });
+}
+
+template <class Isa, class R = RowsF32>
+static void run_predict(const ScoreJob& job, ThreadPool& pool)
+{
+    if (job.fast_sigmoid) predict_blocks<Isa, true, R>(job, pool);
+    else                  predict_blocks<Isa, false, R>(job, pool);
+}
+
+template <class Isa, class R = RowsF32>
+static void run_classify(const ScoreJob& job, ThreadPool& pool)
+{
+    const int                ld = job.ld;
+    const int                bs = job.block_rows;
+    const int                nb = (job.n_samples + bs - 1) / bs;
+    const typename R::elem*  X  = job_rows(job, R());
+
+    pool.parallel_for(nb, [&](int blk, int) {
+        constexpr int CHUNK = 256;
+        float z[CHUNK];
+        const int end = std::min(job.n_samples, (blk + 1) * bs);
+        for (int i = blk * bs; i < end; i += CHUNK) {
+            const int rows = std::min(CHUNK, end - i);
+            Kernels<Isa>::template gemv<R>(X + (size_t)i * ld, rows, ld, job.cols,
+                                           job.weights, job.bias, z);
+            for (int r = 0; r < rows; ++r)
+                job.labels[i + r] = z[r] >= 0.0f ? 1 : 0;
+        }
+    });
+}
+
+// Validation loss: logits of 256 rows at a time on the stack, then
+// their log-loss; each thread sums into its own cache line of sums.
+template <class Isa, class R = RowsF32>
+static double run_loss(const ScoreJob& job, const int* Y, double* sums,
+                       ThreadPool& pool)
+{
+    const int                ld = job.ld;
+    const int                bs = job.block_rows;
+    const int                nb = (job.n_samples + bs - 1) / bs;
+    const int                nt = pool.size();
+    const typename R::elem*  X  = job_rows(job, R());
+
+    for (int t = 0; t < nt; ++t)
+        sums[8 * t] = 0.0;
+    pool.parallel_for(nb, [&](int blk, int t) {
+        constexpr int CHUNK = 256;
+        float z[CHUNK];
+        float loss = 0.0f;
+        const int end = std::min(job.n_samples, (blk + 1) * bs);
+        for (int i = blk * bs; i < end; i += CHUNK) {
+            const int rows = std::min(CHUNK, end - i);
+            Kernels<Isa>::template gemv<R>(X + (size_t)i * ld, rows, ld, job.cols,
+                                           job.weights, job.bias, z);
+            loss += Kernels<Isa>::logloss(z, Y + i, rows);
+        }
+        sums[8 * t] += loss;
+    });
+
+    double loss = 0.0;
+    for (int t = 0; t < nt; ++t)
+        loss += sums[8 * t];
+    return loss;
+}
+
+// 16-bit rows: the same four loops with the row format taken from
+// the job.
+template <class Isa>
+static void run_half_train(const TrainJob& job, ThreadPool& pool)
+{
+    if (job.storage == STORAGE_BF16) run_train<Isa, RowsBf16>(job, pool);
+    else                             run_train<Isa, RowsF16>(job, pool);
+}
+
+template <class Isa>
+static void run_half_predict(const ScoreJob& job, ThreadPool& pool)
+{
+    if (job.storage == STORAGE_BF16) run_predict<Isa, RowsBf16>(job, pool);
+    else                             run_predict<Isa, RowsF16>(job, pool);
+}
+
+template <class Isa>
+static void run_half_classify(const ScoreJob& job, ThreadPool& pool)
+{
+    if (job.storage == STORAGE_BF16) run_classify<Isa, RowsBf16>(job, pool);
+    else                             run_classify<Isa, RowsF16>(job, pool);
+}
+
+template <class Isa>
+static double run_half_loss(const ScoreJob& job, const int* Y, double* sums,
+                            ThreadPool& pool)
+{
+    if (job.storage == STORAGE_BF16) return run_loss<Isa, RowsBf16>(job, Y, sums, pool);
+    return run_loss<Isa, RowsF16>(job, Y, sums, pool);
+}
+
+// CSR rows: the same two loops over sparse_gemv.
+
+template <class Isa, bool FAST>
+static void sparse_predict_blocks(const SparseScoreJob& job, ThreadPool& pool)
+{
+    const CsrMatrix& X  = job.X;
+    const int        bs = job.block_rows;
+    const int        nb = (X.n_rows + bs - 1) / bs;
+
+    pool.parallel_for(nb, [&](int blk, int) {
+        const int begin = blk * bs;
+        const int rows  = std::min(X.n_rows, begin + bs) - begin;
+        float*    out   = job.probs + begin;
+        Kernels<Isa>::sparse_gemv(X.indptr + begin, X.indices, X.values, rows,
+                                  job.weights, job.bias, out);
+        Kernels<Isa>::template sigmoid<FAST>(out, out, rows);
+    });
+}
+
+template <class Isa>
+static void run_predict(const SparseScoreJob& job, ThreadPool& pool)
+{
+    if (job.fast_sigmoid) sparse_predict_blocks<Isa, true>(job, pool);
+    else                  sparse_predict_blocks<Isa, false>(job, pool);
+}
+
+template <class Isa>
+static void run_classify(const SparseScoreJob& job, ThreadPool& pool)
+{
+    const CsrMatrix& X  = job.X;
+    const int        bs = job.block_rows;
+    const int        nb = (X.n_rows + bs - 1) / bs;
+
+    pool.parallel_for(nb, [&](int blk, int) {
+        constexpr int CHUNK = 256;
+        float z[CHUNK];
+        const int end = std::min(X.n_rows, (blk + 1) * bs);
+        for (int i = blk * bs; i < end; i += CHUNK) {
+            const int rows = std::min(CHUNK, end - i);
+            Kernels<Isa>::sparse_gemv(X.indptr + i, X.indices, X.values, rows,
+                                      job.weights, job.bias, z);
+            for (int r = 0; r < rows; ++r)
+                job.labels[i + r] = z[r] >= 0.0f ? 1 : 0;
+        }
+    });
+}
+
+// -------------------------------------------------------------------
+//  Softmax regression – one sweep over X per epoch for all K classes
+//  Per block: class-major logits Z [K × rows] from the GEMM kernel,
+//  softmax in place, minus the one-hot labels (the error), then
+//  dW_k += Σ_i err_ki x_i four rows at a time while the block is
+//  still in L2.  Reduction and update as for the binary model.
+// -------------------------------------------------------------------
+
+template <class Isa, bool FAST>
+static void softmax_epochs(const SoftmaxTrainJob& job, ThreadPool& pool)
+{
+    const int    ld   = job.ld;
+    const int    K    = job.n_classes;
+    const int    ldw  = job.ldw;
+    const int    bs   = job.block_rows;
+    const int    nb   = (job.n_samples + bs - 1) / bs;
+    const int    nt   = pool.size();
+    const int    acc  = job.acc;
+    const int    slot = job.slot;
+    float*       grad = job.grad;
+
+    for (int epoch = 0; epoch < job.epochs; ++epoch) {
+
+        std::memset(grad, 0, (size_t)nt * slot * sizeof(float));
+
+        pool.parallel_for(nb, [&](int blk, int t) {
+            const int    begin = blk * bs;
+            const int    rows  = std::min(job.n_samples, begin + bs) - begin;
+            const float* X     = job.X + (size_t)begin * ld;
+            const int*   Y     = job.Y + begin;
+            float*       Z     = job.logits + (size_t)t * K * bs;
+            float*       g     = grad + (size_t)t * slot;
+
+            Kernels<Isa>::gemm_nt(X, rows, ld, job.cols, job.weights, ldw, K,
+                                  job.bias, Z, bs);
+            Kernels<Isa>::template softmax<FAST>(Z, bs, K, rows);
+            for (int i = 0; i < rows; ++i)
+                Z[(size_t)Y[i] * bs + i] -= 1.0f;
+
+            for (int k = 0; k < K; ++k) {
+                const float* e  = Z + (size_t)k * bs;
+                float*       dw = g + (size_t)k * ldw;
+                float        db = 0.0f;
+                int          i  = 0;
+                for (; i + 4 <= rows; i += 4)
+                    Kernels<Isa>::axpy4_rows(e + i, X + (size_t)i * ld, ld, dw, job.cols);
+                for (; i < rows; ++i)
+                    Kernels<Isa>::axpy(e[i], X + (size_t)i * ld, dw, job.cols);
+                for (i = 0; i < rows; ++i)
+                    db += e[i];
+                g[acc + k] += db;
+            }
+        });
+
+        // ---- reduce thread slots into slot 0, then W -= lr / n * dW ----
+        const size_t nw = (size_t)K * ldw;
+        for (int t = 1; t < nt; ++t) {
+            const float* g = grad + (size_t)t * slot;
+            Kernels<Isa>::axpy(1.0f, g, grad, nw);
+            Kernels<Isa>::axpy(1.0f, g + acc, grad + acc, K);
+        }
+        const float step = job.lr / static_cast<float>(job.n_samples);
+        Kernels<Isa>::axpy(-step, grad, job.weights, nw);
+        Kernels<Isa>::axpy(-step, grad + acc, job.bias, K);
+    }
+}
+
+template <class Isa>
+static void run_train(const SoftmaxTrainJob& job, ThreadPool& pool)
+{
+    if (job.fast_exp) softmax_epochs<Isa, true>(job, pool);
+    else              softmax_epochs<Isa, false>(job, pool);
+}
+
+// Probabilities are computed class-major in the thread's scratch and
+// transposed into the caller's row-major output; classification
+// only needs the largest logit.
+template <class Isa, bool FAST>
+static void softmax_blocks(const SoftmaxScoreJob& job, ThreadPool& pool)
+{
+    const int ld = job.ld;
+    const int K  = job.n_classes;
+    const int bs = job.block_rows;
+    const int nb = (job.n_samples + bs - 1) / bs;
+
+    pool.parallel_for(nb, [&](int blk, int t) {
+        const int begin = blk * bs;
+        const int rows  = std::min(job.n_samples, begin + bs) - begin;
+        float*    Z     = job.logits + (size_t)t * K * bs;
+
+        Kernels<Isa>::gemm_nt(job.X + (size_t)begin * ld, rows, ld, job.cols,
+                              job.weights, job.ldw, K, job.bias, Z, bs);
+        if (job.probs) {
+            Kernels<Isa>::template softmax<FAST>(Z, bs, K, rows);
+            float* out = job.probs + (size_t)begin * K;
+            for (int i = 0; i < rows; ++i)
+                for (int k = 0; k < K; ++k)
+                    out[(size_t)i * K + k] = Z[(size_t)k * bs + i];
+        } else {
+            for (int i = 0; i < rows; ++i) {
+                int best = 0;
+                for (int k = 1; k < K; ++k)
+                    if (Z[(size_t)k * bs + i] > Z[(size_t)best * bs + i])
+                        best = k;
+                job.labels[begin + i] = best;
+            }
+        }
+    });
+}
+
+template <class Isa>
+static void run_predict(const SoftmaxScoreJob& job, ThreadPool& pool)
+{
+    if (job.fast_exp) softmax_blocks<Isa, true>(job, pool);
+    else              softmax_blocks<Isa, false>(job, pool);
+}
+
+// -------------------------------------------------------------------
+//  Per-ISA entry points
+// -------------------------------------------------------------------
+
+void train_loop_scalar(const TrainJob& job, ThreadPool& pool)      { run_train<IsaScalar>(job, pool); }
+void train_loop_sse(const TrainJob& job, ThreadPool& pool)         { run_train<IsaSse>(job, pool); }
+void train_loop_avx(const TrainJob& job, ThreadPool& pool)         { run_train<IsaAvx>(job, pool); }
+void train_loop_avx2_fma(const TrainJob& job, ThreadPool& pool)    { run_train<IsaAvx2Fma>(job, pool); }
+
+double loss_grad_loop_scalar(const TrainJob& job, ThreadPool& pool)   { return run_solver_pass<IsaScalar, false>(job, pool); }
+double loss_grad_loop_sse(const TrainJob& job, ThreadPool& pool)      { return run_solver_pass<IsaSse, false>(job, pool); }
+double loss_grad_loop_avx(const TrainJob& job, ThreadPool& pool)      { return run_solver_pass<IsaAvx, false>(job, pool); }
+double loss_grad_loop_avx2_fma(const TrainJob& job, ThreadPool& pool) { return run_solver_pass<IsaAvx2Fma, false>(job, pool); }
+
+double hessian_loop_scalar(const TrainJob& job, ThreadPool& pool)     { return run_solver_pass<IsaScalar, true>(job, pool); }
+double hessian_loop_sse(const TrainJob& job, ThreadPool& pool)        { return run_solver_pass<IsaSse, true>(job, pool); }
+double hessian_loop_avx(const TrainJob& job, ThreadPool& pool)        { return run_solver_pass<IsaAvx, true>(job, pool); }
+double hessian_loop_avx2_fma(const TrainJob& job, ThreadPool& pool)   { return run_solver_pass<IsaAvx2Fma, true>(job, pool); }
+
+double loss_loop_scalar(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_loss<IsaScalar>(job, Y, sums, pool); }
+double loss_loop_sse(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_loss<IsaSse>(job, Y, sums, pool); }
+double loss_loop_avx(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_loss<IsaAvx>(job, Y, sums, pool); }
+double loss_loop_avx2_fma(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_loss<IsaAvx2Fma>(job, Y, sums, pool); }
+
+double half_loss_loop_scalar(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_half_loss<IsaScalar>(job, Y, sums, pool); }
+double half_loss_loop_sse(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_half_loss<IsaSse>(job, Y, sums, pool); }
+double half_loss_loop_avx(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_half_loss<IsaAvx>(job, Y, sums, pool); }
+double half_loss_loop_avx2_fma(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_half_loss<IsaAvx2Fma>(job, Y, sums, pool); }
+
+void hogwild_loop_scalar(const TrainJob& job, ThreadPool& pool)     { run_hogwild<IsaScalar>(job, pool); }
+void hogwild_loop_sse(const TrainJob& job, ThreadPool& pool)        { run_hogwild<IsaSse>(job, pool); }
+void hogwild_loop_avx(const TrainJob& job, ThreadPool& pool)        { run_hogwild<IsaAvx>(job, pool); }
+void hogwild_loop_avx2_fma(const TrainJob& job, ThreadPool& pool)   { run_hogwild<IsaAvx2Fma>(job, pool); }
+
+void sparse_hogwild_loop_scalar(const SparseTrainJob& job, ThreadPool& pool)   { run_hogwild<IsaScalar>(job, pool); }
+void sparse_hogwild_loop_sse(const SparseTrainJob& job, ThreadPool& pool)      { run_hogwild<IsaSse>(job, pool); }
+void sparse_hogwild_loop_avx(const SparseTrainJob& job, ThreadPool& pool)      { run_hogwild<IsaAvx>(job, pool); }
+void sparse_hogwild_loop_avx2_fma(const SparseTrainJob& job, ThreadPool& pool) { run_hogwild<IsaAvx2Fma>(job, pool); }
+
+void predict_loop_scalar(const ScoreJob& job, ThreadPool& pool)    { run_predict<IsaScalar>(job, pool); }
+void predict_loop_sse(const ScoreJob& job, ThreadPool& pool)       { run_predict<IsaSse>(job, pool); }
+void predict_loop_avx(const ScoreJob& job, ThreadPool& pool)       { run_predict<IsaAvx>(job, pool); }
+void predict_loop_avx2_fma(const ScoreJob& job, ThreadPool& pool)  { run_predict<IsaAvx2Fma>(job, pool); }
+
+void classify_loop_scalar(const ScoreJob& job, ThreadPool& pool)   { run_classify<IsaScalar>(job, pool); }
+void classify_loop_sse(const ScoreJob& job, ThreadPool& pool)      { run_classify<IsaSse>(job, pool); }
+void classify_loop_avx(const ScoreJob& job, ThreadPool& pool)      { run_classify<IsaAvx>(job, pool); }
+void classify_loop_avx2_fma(const ScoreJob& job, ThreadPool& pool) { run_classify<IsaAvx2Fma>(job, pool); }
+
+void sparse_train_loop_scalar(const SparseTrainJob& job, ThreadPool& pool)      { run_train<IsaScalar>(job, pool); }
+void sparse_train_loop_sse(const SparseTrainJob& job, ThreadPool& pool)         { run_train<IsaSse>(job, pool); }
+void sparse_train_loop_avx(const SparseTrainJob& job, ThreadPool& pool)         { run_train<IsaAvx>(job, pool); }
+void sparse_train_loop_avx2_fma(const SparseTrainJob& job, ThreadPool& pool)    { run_train<IsaAvx2Fma>(job, pool); }
+
+void sparse_predict_loop_scalar(const SparseScoreJob& job, ThreadPool& pool)    { run_predict<IsaScalar>(job, pool); }
+void sparse_predict_loop_sse(const SparseScoreJob& job, ThreadPool& pool)       { run_predict<IsaSse>(job, pool); }
+void sparse_predict_loop_avx(const SparseScoreJob& job, ThreadPool& pool)       { run_predict<IsaAvx>(job, pool); }
+void sparse_predict_loop_avx2_fma(const SparseScoreJob& job, ThreadPool& pool)  { run_predict<IsaAvx2Fma>(job, pool); }
+
+void sparse_classify_loop_scalar(const SparseScoreJob& job, ThreadPool& pool)   { run_classify<IsaScalar>(job, pool); }
+void sparse_classify_loop_sse(const SparseScoreJob& job, ThreadPool& pool)      { run_classify<IsaSse>(job, pool); }
+void sparse_classify_loop_avx(const SparseScoreJob& job, ThreadPool& pool)      { run_classify<IsaAvx>(job, pool); }
+void sparse_classify_loop_avx2_fma(const SparseScoreJob& job, ThreadPool& pool) { run_classify<IsaAvx2Fma>(job, pool); }
+
+void softmax_train_loop_scalar(const SoftmaxTrainJob& job, ThreadPool& pool)      { run_train<IsaScalar>(job, pool); }
+void softmax_train_loop_sse(const SoftmaxTrainJob& job, ThreadPool& pool)         { run_train<IsaSse>(job, pool); }
+void softmax_train_loop_avx(const SoftmaxTrainJob& job, ThreadPool& pool)         { run_train<IsaAvx>(job, pool); }
+void softmax_train_loop_avx2_fma(const SoftmaxTrainJob& job, ThreadPool& pool)    { run_train<IsaAvx2Fma>(job, pool); }
+
+void softmax_predict_loop_scalar(const SoftmaxScoreJob& job, ThreadPool& pool)    { run_predict<IsaScalar>(job, pool); }
+void softmax_predict_loop_sse(const SoftmaxScoreJob& job, ThreadPool& pool)       { run_predict<IsaSse>(job, pool); }
+void softmax_predict_loop_avx(const SoftmaxScoreJob& job, ThreadPool& pool)       { run_predict<IsaAvx>(job, pool); }
+void softmax_predict_loop_avx2_fma(const SoftmaxScoreJob& job, ThreadPool& pool)  { run_predict<IsaAvx2Fma>(job, pool); }
+
+void half_train_loop_scalar(const TrainJob& job, ThreadPool& pool)      { run_half_train<IsaScalar>(job, pool); }
+void half_train_loop_sse(const TrainJob& job, ThreadPool& pool)         { run_half_train<IsaSse>(job, pool); }
+void half_train_loop_avx(const TrainJob& job, ThreadPool& pool)         { run_half_train<IsaAvx>(job, pool); }
+void half_train_loop_avx2_fma(const TrainJob& job, ThreadPool& pool)    { run_half_train<IsaAvx2Fma>(job, pool); }
+
+void half_predict_loop_scalar(const ScoreJob& job, ThreadPool& pool)    { run_half_predict<IsaScalar>(job, pool); }
+void half_predict_loop_sse(const ScoreJob& job, ThreadPool& pool)       { run_half_predict<IsaSse>(job, pool); }
+void half_predict_loop_avx(const ScoreJob& job, ThreadPool& pool)       { run_half_predict<IsaAvx>(job, pool); }
+void half_predict_loop_avx2_fma(const ScoreJob& job, ThreadPool& pool)  { run_half_predict<IsaAvx2Fma>(job, pool); }
+
+void half_classify_loop_scalar(const ScoreJob& job, ThreadPool& pool)   { run_half_classify<IsaScalar>(job, pool); }
+void half_classify_loop_sse(const ScoreJob& job, ThreadPool& pool)      { run_half_classify<IsaSse>(job, pool); }
+void half_classify_loop_avx(const ScoreJob& job, ThreadPool& pool)      { run_half_classify<IsaAvx>(job, pool); }
+void half_classify_loop_avx2_fma(const ScoreJob& job, ThreadPool& pool) { run_half_classify<IsaAvx2Fma>(job, pool); }
+
+#if LOGREG_HAVE_AVX512
+void train_loop_avx512(const TrainJob& job, ThreadPool& pool)      { run_train<IsaAvx512>(job, pool); }
+double loss_grad_loop_avx512(const TrainJob& job, ThreadPool& pool) { return run_solver_pass<IsaAvx512, false>(job, pool); }
+double hessian_loop_avx512(const TrainJob& job, ThreadPool& pool)   { return run_solver_pass<IsaAvx512, true>(job, pool); }
+double loss_loop_avx512(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_loss<IsaAvx512>(job, Y, sums, pool); }
+double half_loss_loop_avx512(const ScoreJob& job, const int* Y, double* sums, ThreadPool& pool) { return run_half_loss<IsaAvx512>(job, Y, sums, pool); }
+void hogwild_loop_avx512(const TrainJob& job, ThreadPool& pool)     { run_hogwild<IsaAvx512>(job, pool); }
+void sparse_hogwild_loop_avx512(const SparseTrainJob& job, ThreadPool& pool) { run_hogwild<IsaAvx512>(job, pool); }
+void predict_loop_avx512(const ScoreJob& job, ThreadPool& pool)    { run_predict<IsaAvx512>(job, pool); }
+void classify_loop_avx512(const ScoreJob& job, ThreadPool& pool)   { run_classify<IsaAvx512>(job, pool); }
+void sparse_train_loop_avx512(const SparseTrainJob& job, ThreadPool& pool)      { run_train<IsaAvx512>(job, pool); }
+void sparse_predict_loop_avx512(const SparseScoreJob& job, ThreadPool& pool)    { run_predict<IsaAvx512>(job, pool); }
+void sparse_classify_loop_avx512(const SparseScoreJob& job, ThreadPool& pool)   { run_classify<IsaAvx512>(job, pool); }
+void softmax_train_loop_avx512(const SoftmaxTrainJob& job, ThreadPool& pool)      { run_train<IsaAvx512>(job, pool); }
+void softmax_predict_loop_avx512(const SoftmaxScoreJob& job, ThreadPool& pool)    { run_predict<IsaAvx512>(job, pool); }
+void half_train_loop_avx512(const TrainJob& job, ThreadPool& pool)      { run_half_train<IsaAvx512>(job, pool); }
+void half_predict_loop_avx512(const ScoreJob& job, ThreadPool& pool)    { run_half_predict<IsaAvx512>(job, pool); }
+void half_classify_loop_avx512(const ScoreJob& job, ThreadPool& pool)   { run_half_classify<IsaAvx512>(job, pool); }
+#endif
@@ -0,0 +1,334 @@
+#include "include/solvers.hpp"
+#include "include/ThreadPool.hpp"
+#include "include/logreg_dispatcher.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static inline size_t pad16(size_t n) { return (n + 15) & ~(size_t)15; }
+
+// Pairs (s, y) of curvature history kept by L-BFGS.
+static const int    LBFGS_HISTORY = 10;
+
+// Sufficient decrease f(θ + αp) <= f(θ) + c α <g, p>, and the number
+// of step reductions before the line search gives up.
+static const double ARMIJO_C      = 1e-4;
+static const int    MAX_BACKTRACK = 30;
+
+// Relative change of the loss below which two evaluations can no
+// longer be told apart: the per-lane sums are float, so a predicted or
+// achieved decrease under this ends the search as converged.
+static const double LOSS_EPS      = 1e-7;
+
+static inline bool below_noise(double decrease, double f0)
+{
+    return decrease <= LOSS_EPS * std::max(1.0, std::fabs(f0));
+}
+
+// -------------------------------------------------------------------
+//  Vectors over θ = (w, b), gradient-slot layout (solvers.hpp)
+//  Each takes a stride of acc + 16 floats so every vector starts on a
+//  cache line; the padding between n_features and acc stays zero, so
+//  the dispatched BLAS-1 kernels can run over all acc + 1 floats.
+// -------------------------------------------------------------------
+
+static inline size_t theta_stride(const TrainJob& job)
+{
+    return (size_t)job.acc + 16;
+}
+
+static inline double dot_theta(const float* a, const float* b, int acc)
+{
+    return (double)dot_product(a, b, acc + 1);
+}
+
+static inline float max_abs(const float* g, int acc)
+{
+    float m = 0.0f;
+    for (int j = 0; j <= acc; ++j)
+        m = std::max(m, std::fabs(g[j]));
+    return m;
+}
+
+static void get_theta(const TrainJob& job, float* theta)
+{
+    std::memcpy(theta, job.weights, job.n_features * sizeof(float));
+    theta[job.acc] = *job.bias;
+}
+
+// weights, bias = θ0 + α p
+static void set_theta(const TrainJob& job, const float* theta0, double alpha,
+                      const float* p)
+{
+    std::memcpy(job.weights, theta0, job.n_features * sizeof(float));
+    axpy((float)alpha, p, job.weights, job.n_features);
+    *job.bias = (float)(theta0[job.acc] + alpha * p[job.acc]);
+}
+
+// Mean log-loss at the job's weights, its gradient into g: one pass.
+static double evaluate(const TrainJob& job, ThreadPool& pool, bool hess, float* g)
+{
+    const double loss = (hess ? hessian_loop : loss_grad_loop)(job, pool);
+    std::memcpy(g, job.grad, (job.acc + 1) * sizeof(float));
+    scal(1.0f / (float)job.n_samples, g, job.acc + 1);
+    return loss / job.n_samples;
+}
+
+// -------------------------------------------------------------------
+//  Backtracking line search from θ0 along a descent direction p
+//  (slope gp = <g0, p> < 0).  Tries α = 1 first, then the minimum of
+//  the quadratic through f0, gp and f(α), kept within [α/10, α/2].
+//  On success the weights are at the accepted point, with f and g its
+//  loss and gradient; on failure, or once the predicted decrease -αgp
+//  is below the loss's resolution, they are restored to θ0.
+// -------------------------------------------------------------------
+
+static bool line_search(const TrainJob& job, ThreadPool& pool, bool hess,
+                        const float* theta0, const float* p, double f0,
+                        double gp, double& alpha, double& f, float* g,
+                        int& passes)
+{
+    alpha = 1.0;
+    for (int k = 0; k < MAX_BACKTRACK && !below_noise(-alpha * gp, f0); ++k) {
+        set_theta(job, theta0, alpha, p);
+        f = evaluate(job, pool, hess, g);
+        ++passes;
+        if (f <= f0 + ARMIJO_C * alpha * gp)
+            return true;
+
+        const double q = -gp * alpha * alpha / (2.0 * (f - f0 - gp * alpha));
+        alpha = std::isfinite(q) ? std::min(std::max(q, 0.1 * alpha), 0.5 * alpha)
+                                 : 0.5 * alpha;
+    }
+    set_theta(job, theta0, 0.0, p);
+    return false;
+}
+
+// -------------------------------------------------------------------
+//  L-BFGS
+//  Two-loop recursion over the last LBFGS_HISTORY pairs
+//  s = θ_{k+1} - θ_k, y = g_{k+1} - g_k, scaled by <s, y> / <y, y>
+//  of the newest pair (the first step is the gradient direction,
+//  normalised to unit length).  A pair is kept only when <s, y> > 0,
+//  so the implied inverse Hessian stays positive definite.
+// -------------------------------------------------------------------
+
+size_t lbfgs_work_floats(const TrainJob& job)
+{
+    return (2 * LBFGS_HISTORY + 4) * theta_stride(job);
+}
+
+int lbfgs_solve(const TrainJob& job, ThreadPool& pool, float tol, float* work)
+{
+    const int    acc = job.acc;
+    const int    n   = acc + 1;
+    const size_t V   = theta_stride(job);
+    const int    m   = LBFGS_HISTORY;
+
+    std::memset(work, 0, lbfgs_work_floats(job) * sizeof(float));
+    float* S      = work;
+    float* Yh     = S + m * V;
+    float* theta0 = Yh + m * V;
+    float* g      = theta0 + V;
+    float* g0     = g + V;
+    float* p      = g0 + V;
+
+    double rho[LBFGS_HISTORY];
+    double a[LBFGS_HISTORY];
+    int    pairs  = 0;              // stored pairs, newest at head - 1
+    int    head   = 0;
+    int    passes = 1;
+    double f      = evaluate(job, pool, false, g);
+
+    for (int it = 0; it < job.epochs && max_abs(g, acc) > tol; ++it) {
+        // p = -H g
+        std::memcpy(p, g, n * sizeof(float));
+        for (int k = 0; k < pairs; ++k) {
+            const int i = (head - 1 - k + m) % m;
+            a[i] = rho[i] * dot_theta(S + i * V, p, acc);
+            axpy((float)-a[i], Yh + i * V, p, n);
+        }
+        double gamma;
+        if (pairs > 0) {
+            const int i = (head - 1 + m) % m;
+            gamma = 1.0 / (rho[i] * dot_theta(Yh + i * V, Yh + i * V, acc));
+        } else {
+            gamma = 1.0 / std::max(1.0, std::sqrt(dot_theta(g, g, acc)));
+        }
+        scal((float)gamma, p, n);
+        for (int k = pairs - 1; k >= 0; --k) {
+            const int    i = (head - 1 - k + m) % m;
+            const double b = rho[i] * dot_theta(Yh + i * V, p, acc);
+            axpy((float)(a[i] - b), S + i * V, p, n);
+        }
+        scal(-1.0f, p, n);
+
+        double gp = dot_theta(g, p, acc);
+        if (!(gp < 0.0)) {              // lost descent: restart from -g
+            pairs = 0;
+            std::memcpy(p, g, n * sizeof(float));
+            scal((float)(-1.0 / std::max(1.0, std::sqrt(dot_theta(g, g, acc)))), p, n);
+            gp = dot_theta(g, p, acc);
+        }
+
+        get_theta(job, theta0);
+        std::memcpy(g0, g, n * sizeof(float));
+        const double f0 = f;
+        double       alpha;
+        if (!line_search(job, pool, false, theta0, p, f0, gp, alpha, f, g, passes))
+            break;
+        const bool stalled = below_noise(f0 - f, f0);
+
+        // s = α p, y = g - g0
+        float* s = S + head * V;
+        float* y = Yh + head * V;
+        std::memcpy(s, p, n * sizeof(float));
+        scal((float)alpha, s, n);
+        std::memcpy(y, g, n * sizeof(float));
+        axpy(-1.0f, g0, y, n);
+        const double sy = dot_theta(s, y, acc);
+        if (sy > 1e-10 * dot_theta(y, y, acc)) {
+            rho[head] = 1.0 / sy;
+            head      = (head + 1) % m;
+            pairs     = std::min(pairs + 1, m);
+        }
+        if (stalled)
+            break;
+    }
+    return passes;
+}
+
+// -------------------------------------------------------------------
+//  IRLS (Newton's method on the log-loss)
+//  hessian_loop returns the curvature H = Σ p(1-p) [x 1][x 1]ᵀ with
+//  the gradient; the step solves (H / n) d = -g by Cholesky in
+//  double.  When the data are (nearly) separable H is close to
+//  singular, so a ridge of 1e-12 × max diag is added and raised
+//  100-fold until the factorisation succeeds.
+// -------------------------------------------------------------------
+
+size_t irls_work_floats(const TrainJob& job, int n_threads)
+{
+    const size_t m   = (size_t)job.n_features + 1;
+    const size_t ldh = pad16(m);
+    return (size_t)n_threads * m * ldh + pad16(2 * m * m) + pad16(2 * m)
+           + 3 * theta_stride(job);
+}
+
+// A = L Lᵀ in place (L in the lower triangle, row-major m × m); false
+// when a pivot is not positive.
+static bool cholesky(double* A, int m)
+{
+    for (int j = 0; j < m; ++j) {
+        double*      Lj = A + (size_t)j * m;
+        double       d  = Lj[j];
+        for (int k = 0; k < j; ++k)
+            d -= Lj[k] * Lj[k];
+        if (!(d > 0.0))
+            return false;
+        Lj[j] = std::sqrt(d);
+
+        const double inv = 1.0 / Lj[j];
+        for (int i = j + 1; i < m; ++i) {
+            double* Li = A + (size_t)i * m;
+            double  v  = Li[j];
+            for (int k = 0; k < j; ++k)
+                v -= Li[k] * Lj[k];
+            Li[j] = v * inv;
+        }
+    }
+    return true;
+}
+
+// Lower triangle of H / n + ridge I from the summed Hessian slot
+// (upper triangle by rows, bias row last).
+static void fill_hessian(const float* H, int nf, int ldh, double inv_n,
+                         double ridge, double* A)
+{
+    const int m = nf + 1;
+    for (int i = 0; i < nf; ++i)
+        for (int j = 0; j <= i; ++j)
+            A[(size_t)i * m + j] = H[(size_t)j * ldh + i] * inv_n;
+    for (int j = 0; j <= nf; ++j)
+        A[(size_t)nf * m + j] = H[(size_t)nf * ldh + j] * inv_n;
+    for (int i = 0; i < m; ++i)
+        A[(size_t)i * m + i] += ridge;
+}
+
+// x = A⁻¹ r with A = L Lᵀ from cholesky: L z = r, then Lᵀ x = z.
+static void cholesky_solve(const double* L, int m, double* x)
+{
+    for (int i = 0; i < m; ++i) {
+        const double* Li = L + (size_t)i * m;
+        double        v  = x[i];
+        for (int k = 0; k < i; ++k)
+            v -= Li[k] * x[k];
+        x[i] = v / Li[i];
+    }
+    for (int i = m - 1; i >= 0; --i) {
+        double v = x[i];
+        for (int k = i + 1; k < m; ++k)
+            v -= L[(size_t)k * m + i] * x[k];
+        x[i] = v / L[(size_t)i * m + i];
+    }
+}
+
+int irls_solve(TrainJob job, ThreadPool& pool, float tol, float* work)
+{
+    const int    nf  = job.n_features;
+    const int    m   = nf + 1;
+    const int    acc = job.acc;
+    const size_t V   = theta_stride(job);
+
+    // Hessian slots | A (m × m doubles) | d (m doubles) | θ0, g, p
+    job.ldh  = (int)pad16(m);
+    job.hess = work;
+    float*  tail   = work + (size_t)pool.size() * m * job.ldh;
+    double* A      = reinterpret_cast<double*>(tail);
+    double* d      = reinterpret_cast<double*>(tail + pad16(2 * (size_t)m * m));
+    float*  theta0 = tail + pad16(2 * (size_t)m * m) + pad16(2 * (size_t)m);
+    float*  g      = theta0 + V;
+    float*  p      = g + V;
+    std::memset(theta0, 0, 3 * V * sizeof(float));
+
+    const double inv_n  = 1.0 / job.n_samples;
+    int          passes = 1;
+    double       f      = evaluate(job, pool, true, g);
+
+    for (int it = 0; it < job.epochs && max_abs(g, acc) > tol; ++it) {
+        const float* H    = job.hess;
+        double       hmax = H[(size_t)nf * job.ldh + nf];
+        for (int j = 0; j < nf; ++j)
+            hmax = std::max(hmax, (double)H[(size_t)j * job.ldh + j]);
+
+        double ridge = 1e-12 * hmax * inv_n + 1e-30;
+        bool   ok    = false;
+        for (int k = 0; k < 12 && !ok; ++k, ridge *= 100.0) {
+            fill_hessian(H, nf, job.ldh, inv_n, ridge, A);
+            ok = cholesky(A, m);
+        }
+        if (!ok)
+            break;
+
+        // (H / n) d = -g, d in θ layout as p.
+        for (int j = 0; j < nf; ++j)
+            d[j] = -(double)g[j];
+        d[nf] = -(double)g[acc];
+        cholesky_solve(A, m, d);
+        for (int j = 0; j < nf; ++j)
+            p[j] = (float)d[j];
+        p[acc] = (float)d[nf];
+
+        const double gp = dot_theta(g, p, acc);
+        if (!(gp < 0.0))
+            break;
+
+        get_theta(job, theta0);
+        const double f0 = f;
+        double       alpha;
+        if (!line_search(job, pool, true, theta0, p, f0, gp, alpha, f, g, passes)
+            || below_noise(f0 - f, f0))
+            break;
+    }
+    return passes;
+}
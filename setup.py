@@ -14,9 +14,20 @@ ext_modules = [
         "logreg",
         sources=[
             "bindings/py_logreg.cpp",
+            "logreg/Dataset.cpp",
             "logreg/LogisticRegression.cpp",
+            "logreg/MappedDataset.cpp",
+            "logreg/QuantizedLogisticRegression.cpp",
+            "logreg/SoftmaxRegression.cpp",
+            "logreg/ThreadPool.cpp",
+            "logreg/Workspace.cpp",
+            "logreg/blas1.cpp",
             "logreg/dispatcher.cpp",
             "logreg/dot_product.cpp",
+            "logreg/fused_grad.cpp",
+            "logreg/int8_gemv.cpp",
+            "logreg/model_loops.cpp",
+            "logreg/solvers.cpp",
             "logreg/vect_sigmoid.cpp",
             "utils/aligned_alloc.cpp",
         ],
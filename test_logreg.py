@@ -7,6 +7,9 @@ Build first with either:
     pip install -e .      # setuptools / editable install
 """
 
+import os
+import tempfile
+
 import numpy as np
 import logreg
 
@@ -60,4 +63,363 @@ model2 = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=100)
 model2.train(X_train, Y_i64)     # should not raise
 print("int64 labels   → accepted OK")
 
+# ------------------------------------------------------------------
+#  Multithreaded training / scoring matches the single-threaded model
+# ------------------------------------------------------------------
+model_mt = logreg.LogisticRegression(n_features=n_features, lr=0.05,
+                                     epochs=500, n_threads=4)
+model_mt.train(X_train, Y_train)
+probs_mt = model_mt.predict_batch(X_test)
+assert model_mt.n_threads == 4
+assert np.allclose(probs_mt, probs, atol=1e-4), \
+    f"threaded probs differ by {np.abs(probs_mt - probs).max()}"
+assert np.array_equal(model_mt.predict_class_batch(X_test), classes)
+print("n_threads=4    → matches single-threaded model")
+
+# ------------------------------------------------------------------
+#  Steady-state train / scoring performs no heap allocations
+# ------------------------------------------------------------------
+ws = logreg.Workspace()
+model.train(X_train, Y_train)                 # warm the model's workspace
+model.predict_batch(X_test, workspace=ws)     # warm the scoring workspace
+model.predict_class_batch(X_test, workspace=ws)
+
+before = logreg.aligned_alloc_count()
+for _ in range(3):
+    model.train(X_train, Y_train)
+    model.predict_batch(X_test, workspace=ws)
+    model.predict_class_batch(X_test, workspace=ws)
+    model.predict(X_test[0])
+allocs = logreg.aligned_alloc_count() - before
+assert allocs == 0, f"steady-state calls made {allocs} allocations"
+print(f"Workspace      → 0 allocations in steady state ({ws.nbytes} B reused)")
+
+# ------------------------------------------------------------------
+#  Fast sigmoid tier stays close to the accurate one
+# ------------------------------------------------------------------
+model_fast = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=500)
+model_fast.sigmoid_accuracy = logreg.SigmoidAccuracy.FAST
+assert model_fast.sigmoid_accuracy == logreg.SigmoidAccuracy.FAST
+model_fast.train(X_train, Y_train)
+probs_fast = model_fast.predict_batch(X_test)
+assert np.allclose(probs_fast, probs, atol=1e-3), \
+    f"fast-tier probs differ by {np.abs(probs_fast - probs).max()}"
+print(f"FAST sigmoid   → max |Δp| = {np.abs(probs_fast - probs).max():.2e}")
+
+# ------------------------------------------------------------------
+#  Mini-batch and streaming training
+# ------------------------------------------------------------------
+# One batch covering the whole set is a full-batch gradient step.
+model_mb = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=500)
+model_mb.train_minibatch(X_train, Y_train, batch_size=len(X_train) + 1)
+assert np.allclose(model_mb.predict_batch(X_test), probs, atol=1e-5), \
+    "train_minibatch with one batch differs from train"
+
+# Uneven chunks are regrouped into the same batches as in memory.
+def chunks():
+    for lo, hi in [(0, 37), (37, 38), (38, 300), (300, len(X_train))]:
+        yield X_train[lo:hi], Y_train[lo:hi]
+
+model_a = logreg.LogisticRegression(n_features=n_features, lr=0.1, epochs=20)
+model_b = logreg.LogisticRegression(n_features=n_features, lr=0.1, epochs=20)
+model_a.train_minibatch(X_train, Y_train, batch_size=64)
+model_b.train_stream(chunks, batch_size=64)
+probs_a = model_a.predict_batch(X_test)
+assert np.allclose(model_b.predict_batch(X_test), probs_a, atol=1e-6), \
+    "train_stream differs from train_minibatch"
+acc_mb = (model_a.predict_class_batch(X_test) == Y_test).mean()
+print(f"Mini-batch 64  → test accuracy {acc_mb:.4f}, stream matches")
+
+# ------------------------------------------------------------------
+#  Memory-mapped data set: same model, rows read in place
+# ------------------------------------------------------------------
+with tempfile.TemporaryDirectory() as tmp:
+    path = os.path.join(tmp, "train.lrds")
+    logreg.write_dataset(path, X_train, Y_train)
+    ds = logreg.MappedDataset(path)
+    assert (ds.n_samples, ds.n_features) == X_train.shape
+    assert np.array_equal(ds.X, X_train) and np.array_equal(ds.Y, Y_train)
+
+    X_train.astype("<f4").tofile(os.path.join(tmp, "X.f32"))
+    Y_train.astype("<i4").tofile(os.path.join(tmp, "Y.i32"))
+    n = logreg.convert_raw_dataset(os.path.join(tmp, "X.f32"),
+                                   os.path.join(tmp, "Y.i32"), n_features,
+                                   os.path.join(tmp, "raw.lrds"))
+    assert n == len(X_train)
+    with open(path, "rb") as a, open(os.path.join(tmp, "raw.lrds"), "rb") as b:
+        assert a.read() == b.read(), "converter output differs from write_dataset"
+
+    model_mm = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=500)
+    model_mm.train(ds)
+    probs_mm = model_mm.predict_batch(X_test)
+    assert np.allclose(probs_mm, probs, atol=1e-6), \
+        f"mapped-data model differs by {np.abs(probs_mm - probs).max()}"
+    assert np.allclose(model_mm.predict_batch(ds), model_mm.predict_batch(X_train))
+    del ds
+print("MappedDataset  → matches in-memory training")
+
+# ------------------------------------------------------------------
+#  Strided inputs are read in place and give the same results
+# ------------------------------------------------------------------
+X_wide = np.zeros((len(X_test), n_features + 3), dtype=np.float32)
+X_wide[:, 1:1 + n_features] = X_test          # misaligned column slice
+X_view = X_wide[:, 1:1 + n_features]
+assert not X_view.flags.c_contiguous
+assert np.array_equal(model.predict_batch(X_view), model.predict_batch(X_test))
+assert np.array_equal(model.predict_class_batch(X_view),
+                      model.predict_class_batch(X_test))
+model_sv = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=50)
+model_sc = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=50)
+model_sv.train(X_view, Y_test)
+model_sc.train(np.ascontiguousarray(X_view), Y_test)
+assert np.allclose(model_sv.predict_batch(X_test), model_sc.predict_batch(X_test),
+                   atol=1e-6)
+print("Strided X      → read in place, matches contiguous copy")
+
+# ------------------------------------------------------------------
+#  Dataset: copied once, reused across train / predict calls
+# ------------------------------------------------------------------
+ds_train = logreg.Dataset(X_train, Y_train)
+ds_test  = logreg.Dataset(X_test)
+assert ds_test.Y is None and np.array_equal(ds_train.X, X_train)
+model_ds = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=500)
+model_ds.train(ds_train)
+assert np.allclose(model_ds.predict_batch(ds_test), probs, atol=1e-6)
+assert np.array_equal(model_ds.predict_class_batch(ds_test),
+                      model_ds.predict_class_batch(X_test))
+stats = ds_train.column_stats()
+assert np.allclose(stats["mean"], X_train.mean(axis=0), atol=1e-5)
+assert np.allclose(stats["std"], X_train.std(axis=0), atol=1e-5)
+assert np.array_equal(stats["min"], X_train.min(axis=0))
+assert np.array_equal(stats["max"], X_train.max(axis=0))
+print("Dataset        → reused without copies, column stats match NumPy")
+
+# ------------------------------------------------------------------
+#  Sparse CSR input (skipped without SciPy)
+# ------------------------------------------------------------------
+try:
+    import scipy.sparse as sp
+except ImportError:
+    sp = None
+
+if sp is not None:
+    X_dense = X_train * (rng.random(X_train.shape) < 0.5)
+    X_csr = sp.csr_matrix(X_dense)
+    model_d = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=200)
+    model_s = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=200)
+    model_d.train(X_dense, Y_train)
+    model_s.train(X_csr, Y_train)
+    assert np.allclose(model_s.predict_batch(X_csr), model_d.predict_batch(X_dense),
+                       atol=1e-5)
+    assert np.array_equal(model_s.predict_class_batch(X_csr.tocoo()),
+                          model_s.predict_class_batch(X_dense))
+    bad = sp.csr_matrix(X_dense[:, :3])
+    try:
+        model_s.predict_batch(bad)
+        raise AssertionError("n_features mismatch not caught")
+    except RuntimeError:
+        pass
+    print("CSR input      → matches dense training")
+else:
+    print("CSR input      → skipped (no SciPy)")
+
+# ------------------------------------------------------------------
+#  Multinomial softmax regression
+# ------------------------------------------------------------------
+n_classes = 4
+centres = rng.normal(0.0, 3.0, size=(n_classes, n_features)).astype(np.float32)
+Y_multi = rng.integers(0, n_classes, size=n_samples).astype(np.int32)
+X_multi = (centres[Y_multi]
+           + rng.normal(size=(n_samples, n_features))).astype(np.float32)
+
+softmax = logreg.SoftmaxRegression(n_features=n_features, n_classes=n_classes,
+                                   lr=0.1, epochs=200)
+softmax.train(X_multi, Y_multi)
+proba = softmax.predict_proba(X_multi)
+classes = softmax.predict_class_batch(X_multi)
+assert proba.shape == (n_samples, n_classes)
+assert np.allclose(proba.sum(axis=1), 1.0, atol=1e-5)
+assert np.array_equal(classes, proba.argmax(axis=1))
+softmax_acc = np.mean(classes == Y_multi)
+assert softmax_acc > 0.9, f"softmax accuracy too low: {softmax_acc:.3f}"
+try:
+    softmax.train(X_multi, np.full(n_samples, n_classes, dtype=np.int32))
+    raise AssertionError("out-of-range label not caught")
+except RuntimeError:
+    pass
+print(f"Softmax        → {n_classes} classes, accuracy {softmax_acc:.3f}")
+
+# ------------------------------------------------------------------
+#  16-bit feature storage
+# ------------------------------------------------------------------
+model_32 = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=100)
+model_32.train(X, Y)
+p_32 = model_32.predict_batch(X)
+for storage, tol in ((logreg.FeatureStorage.F16, 1e-3),
+                     (logreg.FeatureStorage.BF16, 1e-2)):
+    model_h = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=100)
+    model_h.feature_storage = storage
+    model_h.train(X, Y)
+    assert np.allclose(model_h.predict_batch(X), p_32, atol=tol)
+    ds_h = logreg.Dataset(X, Y, storage=storage)
+    assert ds_h.storage == storage
+    assert np.allclose(ds_h.X, X, rtol=tol, atol=1e-6)
+    model_d = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=100)
+    model_d.train(ds_h)
+    assert np.allclose(model_d.predict_batch(ds_h), p_32, atol=tol)
+print("16-bit storage → fp16 / bf16 training matches float32")
+
+# ------------------------------------------------------------------
+#  Int8 quantized scoring
+# ------------------------------------------------------------------
+qmodel = logreg.QuantizedLogisticRegression(model_32, X_train)
+Xq = qmodel.quantize(X)
+assert Xq.dtype == np.uint8 and Xq.shape == X.shape and Xq.max() <= 127
+# codes of the calibration rows dequantize to within half a step
+X_dq = qmodel.zero_point + qmodel.scale * Xq[:400].astype(np.float32)
+assert np.all(np.abs(X_dq - X_train) <= 0.5001 * qmodel.scale)
+p_q = qmodel.predict_batch(Xq)
+assert np.array_equal(p_q, qmodel.predict_batch(X))
+assert np.array_equal(qmodel.predict_batch(np.hstack([Xq, Xq])[:, :n_features]), p_q)
+assert np.abs(p_q - p_32).max() < 0.05
+agree_q = np.mean(qmodel.predict_class_batch(Xq) == model_32.predict_class_batch(X))
+assert agree_q > 0.97, agree_q
+print(f"Int8 scoring   → {logreg.int8_kernel()}, class agreement {agree_q:.3f}")
+
+# ------------------------------------------------------------------
+#  L-BFGS / IRLS solvers
+# ------------------------------------------------------------------
+def mean_log_loss(p, y):
+    p = np.clip(p.astype(np.float64), 1e-7, 1 - 1e-7)
+    return -np.mean(y * np.log(p) + (1 - y) * np.log(1 - p))
+
+Y_noisy = Y.copy()
+Y_noisy[::9] ^= 1                   # not separable: the optimum is finite
+model_gd = logreg.LogisticRegression(n_features=n_features, lr=0.5, epochs=300)
+model_gd.train(X, Y_noisy)
+assert model_gd.solver == logreg.Solver.GD and model_gd.n_passes == 300
+loss_gd = mean_log_loss(model_gd.predict_batch(X), Y_noisy)
+p_solved = []
+for solver in (logreg.Solver.LBFGS, logreg.Solver.IRLS):
+    model_s = logreg.LogisticRegression(n_features=n_features, epochs=100)
+    model_s.solver = solver
+    model_s.tol = 1e-5
+    model_s.train(X, Y_noisy)
+    assert model_s.n_passes < 60, (solver, model_s.n_passes)
+    assert mean_log_loss(model_s.predict_batch(X), Y_noisy) <= loss_gd + 1e-6
+    p_solved.append(model_s.predict_batch(X))
+assert np.allclose(p_solved[0], p_solved[1], atol=5e-3)
+try:
+    logreg.LogisticRegression(n_features=2000).solver = logreg.Solver.IRLS
+    raise AssertionError("IRLS accepted 2000 features")
+except RuntimeError:
+    pass
+print("Solvers        → L-BFGS / IRLS match GD's loss in far fewer passes")
+
+# ------------------------------------------------------------------
+#  Convergence monitoring / early stopping
+# ------------------------------------------------------------------
+history = []
+model_m = logreg.LogisticRegression(n_features=n_features, lr=0.5, epochs=40)
+model_m.set_epoch_callback(lambda st: history.append((st.loss, st.grad_norm, st.seconds)))
+p_start = model_m.predict_batch(X)
+model_m.train(X, Y_noisy)
+assert len(history) == 40 and model_m.n_passes == 40
+assert abs(history[0][0] - mean_log_loss(p_start, Y_noisy)) < 1e-5
+assert history[-1][0] < history[0][0] and history[-1][1] < history[0][1]
+assert all(sec >= 0.0 for _, _, sec in history)
+
+model_e = logreg.LogisticRegression(n_features=n_features, lr=0.5, epochs=5000)
+model_e.set_early_stopping(loss_tol=1e-7, patience=3)
+model_e.train(X, Y_noisy)
+assert model_e.n_passes < 5000, model_e.n_passes
+assert mean_log_loss(model_e.predict_batch(X), Y_noisy) < loss_gd + 1e-3
+
+model_c = logreg.LogisticRegression(n_features=n_features, lr=0.5, epochs=100)
+model_c.set_epoch_callback(lambda st: st.epoch == 9)
+model_c.train(X, Y_noisy)
+assert model_c.n_passes == 10
+
+ds_val = logreg.Dataset(X[:200], Y_noisy[:200])
+val_losses = []
+model_v = logreg.LogisticRegression(n_features=n_features, lr=0.5, epochs=200)
+model_v.set_validation(ds_val)
+model_v.set_early_stopping(loss_tol=1e-6, patience=5)
+model_v.set_epoch_callback(lambda st: val_losses.append(st.val_loss))
+model_v.train(X, Y_noisy)
+# ends on the best validation epoch
+best_val = mean_log_loss(model_v.predict_batch(ds_val), Y_noisy[:200])
+assert abs(best_val - min(val_losses)) < 1e-5
+print(f"Early stopping → {model_e.n_passes} of 5000 epochs, "
+      f"validation stop after {model_v.n_passes}")
+
+# ------------------------------------------------------------------
+#  Optimizers
+# ------------------------------------------------------------------
+def loss_after(optimizer, lr, epochs):
+    model_o = logreg.LogisticRegression(n_features=n_features, lr=lr, epochs=epochs)
+    model_o.set_optimizer(optimizer)
+    assert model_o.optimizer == optimizer
+    model_o.train(X, Y_noisy)
+    return mean_log_loss(model_o.predict_batch(X), Y_noisy)
+
+loss_sgd = loss_after(logreg.Optimizer.SGD, 0.05, 40)
+for optimizer in (logreg.Optimizer.MOMENTUM, logreg.Optimizer.NESTEROV):
+    # β1 = 0.9 carries ~10x the step of plain SGD at the same lr
+    assert loss_after(optimizer, 0.05, 40) < loss_sgd, optimizer
+for optimizer in (logreg.Optimizer.ADAGRAD, logreg.Optimizer.ADAM):
+    loss_o = loss_after(optimizer, 0.05, 300)
+    assert np.isfinite(loss_o) and loss_o < loss_gd + 2e-2, (optimizer, loss_o)
+print("Optimizers     → momentum / Nesterov / AdaGrad / Adam converge")
+
+# ------------------------------------------------------------------
+#  Hogwild! asynchronous SGD
+# ------------------------------------------------------------------
+def hogwild_loss(X_in, n_threads):
+    model_h = logreg.LogisticRegression(n_features=n_features, epochs=50, n_threads=4)
+    model_h.solver = logreg.Solver.HOGWILD
+    model_h.set_hogwild(step=0.02, n_threads=n_threads)
+    model_h.train(X_in, Y_noisy)
+    assert model_h.n_passes == 50 and model_h.samples_per_second > 0
+    return mean_log_loss(model_h.predict_batch(X), Y_noisy)
+
+loss_serial = hogwild_loss(X, 1)                    # one shard: serial SGD
+assert loss_serial < loss_gd + 5e-3, (loss_serial, loss_gd)
+for n_threads in (2, 4):
+    loss_h = hogwild_loss(X, n_threads)
+    assert abs(loss_h - loss_serial) < 2e-2, (n_threads, loss_h, loss_serial)
+if sp is not None:
+    assert abs(hogwild_loss(sp.csr_matrix(X), 4) - loss_serial) < 2e-2
+try:
+    logreg.LogisticRegression(n_features=n_features).set_hogwild(step=0.0)
+    raise AssertionError("Hogwild accepted a zero step")
+except RuntimeError:
+    pass
+print(f"Hogwild        → 4 shards within {abs(loss_h - loss_serial):.4f} of serial SGD")
+
+# ------------------------------------------------------------------
+#  Online learning (partial_fit)
+# ------------------------------------------------------------------
+# k single-step calls continue the Adam state: the same as k epochs
+model_full = logreg.LogisticRegression(n_features=n_features, lr=0.05, epochs=20)
+model_full.set_optimizer(logreg.Optimizer.ADAM)
+model_full.train(X, Y_noisy)
+model_on = logreg.LogisticRegression(n_features=n_features, lr=0.05)
+model_on.set_optimizer(logreg.Optimizer.ADAM)
+for _ in range(20):
+    model_on.partial_fit(X, Y_noisy)
+assert model_on.samples_seen == 20 * len(X)
+assert np.allclose(model_on.predict_batch(X), model_full.predict_batch(X), atol=1e-6)
+
+# streamed batches with a decaying step size
+model_on = logreg.LogisticRegression(n_features=n_features, lr=0.5)
+model_on.lr_decay = 1e-4
+for _ in range(30):
+    for i in range(0, len(X), 50):
+        model_on.partial_fit(X[i:i + 50], Y_noisy[i:i + 50])
+assert mean_log_loss(model_on.predict_batch(X), Y_noisy) < loss_gd + 1e-2
+model_on.reset_online_state()
+assert model_on.samples_seen == 0
+print("Online         → partial_fit keeps optimizer state across calls")
+
 print("\nAll checks passed ✓")
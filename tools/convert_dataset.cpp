@@ -0,0 +1,36 @@
+// tools/convert_dataset.cpp  –  raw arrays → memory-mappable data set
+//
+// Usage: convert_dataset <X.f32> <Y.i32> <n_features> <out.lrds>
+//
+// X.f32 is a headerless row-major float32 matrix [n × n_features]
+// (numpy: X.astype('<f4').tofile(...)), Y.i32 the n int32 labels.
+// The output is the padded, page-aligned format of MappedDataset.hpp,
+// ready for LogisticRegression::train(const MappedDataset&).  Both
+// inputs are streamed, so files larger than RAM convert fine.
+
+#include "../logreg/include/MappedDataset.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+int main(int argc, char** argv)
+{
+    if (argc != 5) {
+        std::fprintf(stderr,
+                     "usage: %s <X.f32> <Y.i32> <n_features> <out.lrds>\n", argv[0]);
+        return 2;
+    }
+
+    try {
+        const int64_t n = convert_raw_dataset(argv[1], argv[2],
+                                              std::atoi(argv[3]), argv[4]);
+        MappedDataset ds(argv[4], ADVISE_NORMAL);
+        std::printf("%s: %lld rows x %d features (padded to %d), %.1f MB\n",
+                    argv[4], (long long)n, ds.n_features(),
+                    ds.padded_features(), ds.size_bytes() / 1e6);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "convert_dataset: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -1,9 +1,18 @@
+#include <atomic>
 #include <cstdlib>
 #include <cstdint>
 
+static std::atomic<uint64_t> g_alloc_count{0};
+
+uint64_t aligned_alloc_count() {
+    return g_alloc_count.load(std::memory_order_relaxed);
+}
+
 float* aligned_alloc_float(size_t n, size_t alignment) {
     void* ptr = nullptr;
 
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+
 #if defined(_MSC_VER)
     // Windows (MSVC)
     ptr = _aligned_malloc(n * sizeof(float), alignment);